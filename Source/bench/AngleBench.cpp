@@ -0,0 +1,220 @@
+#include "stdafx.h"
+#include <chrono>
+#include <cfloat>
+
+// Accuracy and speed of the angle functions (EAngle.h) against libm: wrapping, directions from angles and signed angles between directions,
+// scalar and batched. The errors are measured against libm in double, and it fails if any is above what the plugin counts on
+// Usage: AngleBench [--seed <n>] [--count <n>] [--rounds <n>]
+
+namespace
+{
+	struct BenchSettings
+	{
+		int Seed = 1234;
+		int Count = 4096; // Angles (and direction pairs) per round
+		int Rounds = 500;
+		float MaxAngle = 1000.f; // Orientations keep growing as the agent turns, a few hundred turns' worth
+	};
+
+	struct Error
+	{
+		double Max = 0.;
+		double Total = 0.;
+		size_t Count = 0;
+
+		void Add(double error)
+		{
+			Max = max(Max, fabs(error));
+			Total += fabs(error);
+			++Count;
+		}
+	};
+
+	// Difference between two angles, the short way round
+	double AngleDifference(double a, double b)
+	{
+		return remainder(a - b, 2. * M_PI);
+	}
+
+	// Runs the function every round, returns the ns per angle
+	template<typename Function>
+	double Time(const BenchSettings& settings, Function function)
+	{
+		const auto startTime = chrono::steady_clock::now();
+		for (int round = 0; round < settings.Rounds; ++round)
+			function();
+		const auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - startTime).count();
+		return elapsed / (double(settings.Rounds) * double(settings.Count));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	BenchSettings settings{};
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--seed" && hasValue)
+			settings.Seed = stoi(argv[++i]);
+		else if (arg == "--count" && hasValue)
+			settings.Count = max(1, stoi(argv[++i]));
+		else if (arg == "--rounds" && hasValue)
+			settings.Rounds = max(1, stoi(argv[++i]));
+		else
+		{
+			std::cout << "Usage: AngleBench [--seed <n>] [--count <n>] [--rounds <n>]\n";
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+#if defined(ELITE_SIMD_AVX2)
+	std::cout << "Kernels: AVX2\n";
+#elif defined(ELITE_SIMD_SSE2)
+	std::cout << "Kernels: SSE2\n";
+#else
+	std::cout << "Kernels: scalar\n";
+#endif
+
+	mt19937 randomEngine{ unsigned(settings.Seed) };
+	uniform_real_distribution<float> angleDistribution{ -settings.MaxAngle, settings.MaxAngle };
+	uniform_real_distribution<float> coordinate{ -100.f, 100.f };
+
+	const auto count = size_t(settings.Count);
+	vector<float> angles(count), fromX(count), fromY(count), toX(count), toY(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		angles[i] = angleDistribution(randomEngine);
+		fromX[i] = coordinate(randomEngine);
+		fromY[i] = coordinate(randomEngine);
+		toX[i] = coordinate(randomEngine);
+		toY[i] = coordinate(randomEngine);
+	}
+	// The edges too: exact multiples of pi, directions along the axes, (anti)parallel and zero ones
+	for (size_t i = 0; i < min(count, size_t(16)); ++i)
+	{
+		angles[i] = float(int(i) - 8) * float(M_PI);
+		fromX[i] = i % 4 == 0 ? 0.f : 1.f;
+		fromY[i] = i % 4 == 1 ? 0.f : 1.f;
+		toX[i] = fromX[i] * (i % 3 == 0 ? -2.f : 3.f);
+		toY[i] = fromY[i] * (i % 3 == 0 ? -2.f : 3.f);
+	}
+
+	vector<float> wrapped(count), directionsX(count), directionsY(count), signedAngles(count);
+	Elite::WrapAngles(angles.data(), count, wrapped.data());
+	Elite::DirectionsFromAngles(angles.data(), count, directionsX.data(), directionsY.data());
+	Elite::SignedAngles(fromX.data(), fromY.data(), toX.data(), toY.data(), count, signedAngles.data());
+
+	// The batched ones have to match the scalar ones, and both libm (in double, from the same float inputs)
+	Error wrapError{}, directionError{}, signedAngleError{};
+	bool sameResults = true;
+	bool inRange = true;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto wrappedAngle = Elite::WrapAngle(angles[i]);
+		const auto direction = Elite::DirectionFromAngle(angles[i]);
+		const auto signedAngle = Elite::SignedAngle(Elite::Vector2{ fromX[i], fromY[i] }, Elite::Vector2{ toX[i], toY[i] });
+		sameResults = sameResults && fabsf(wrappedAngle - wrapped[i]) <= 1e-6f && fabsf(signedAngle - signedAngles[i]) <= 1e-6f
+			&& fabsf(direction.x - directionsX[i]) <= 1e-6f && fabsf(direction.y - directionsY[i]) <= 1e-6f;
+		inRange = inRange && wrappedAngle >= -float(M_PI) && wrappedAngle <= float(M_PI);
+
+		wrapError.Add(AngleDifference(double(wrappedAngle), double(angles[i])));
+		directionError.Add(double(direction.x) - cos(double(angles[i])));
+		directionError.Add(double(direction.y) - sin(double(angles[i])));
+		const auto cross = double(fromX[i]) * double(toY[i]) - double(fromY[i]) * double(toX[i]);
+		const auto dot = double(fromX[i]) * double(toX[i]) + double(fromY[i]) * double(toY[i]);
+		signedAngleError.Add(AngleDifference(double(signedAngle), atan2(cross, dot)));
+	}
+
+	const auto printError = [](const char* pName, const Error& error)
+	{
+		std::cout << "  " << pName << "max " << error.Max << ", mean " << error.Total / double(max(error.Count, size_t(1))) << "\n";
+	};
+	std::cout << "Errors against libm (in double), " << count << " angles in [-" << settings.MaxAngle << ", " << settings.MaxAngle << "]\n";
+	printError("Wrap:            ", wrapError);
+	printError("Direction:       ", directionError);
+	printError("Signed angle:    ", signedAngleError);
+
+	// libm in float, the way the plugin did it before, then the scalar and batched functions
+	float checksum = 0.f;
+	const auto libmWrap = Time(settings, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+				wrapped[i] = remainderf(angles[i], 2.f * float(M_PI));
+			checksum += wrapped[count / 2];
+		});
+	const auto scalarWrap = Time(settings, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+				wrapped[i] = Elite::WrapAngle(angles[i]);
+			checksum += wrapped[count / 2];
+		});
+	const auto batchWrap = Time(settings, [&]() { Elite::WrapAngles(angles.data(), count, wrapped.data()); checksum += wrapped[count / 2]; });
+
+	const auto libmDirection = Time(settings, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				directionsX[i] = cosf(angles[i]);
+				directionsY[i] = sinf(angles[i]);
+			}
+			checksum += directionsX[count / 2];
+		});
+	const auto scalarDirection = Time(settings, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto direction = Elite::DirectionFromAngle(angles[i]);
+				directionsX[i] = direction.x;
+				directionsY[i] = direction.y;
+			}
+			checksum += directionsX[count / 2];
+		});
+	const auto batchDirection = Time(settings, [&]()
+		{
+			Elite::DirectionsFromAngles(angles.data(), count, directionsX.data(), directionsY.data());
+			checksum += directionsX[count / 2];
+		});
+
+	const auto libmSignedAngle = Time(settings, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+				signedAngles[i] = atan2f(fromX[i] * toY[i] - fromY[i] * toX[i], fromX[i] * toX[i] + fromY[i] * toY[i]);
+			checksum += signedAngles[count / 2];
+		});
+	const auto scalarSignedAngle = Time(settings, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+				signedAngles[i] = Elite::SignedAngle(Elite::Vector2{ fromX[i], fromY[i] }, Elite::Vector2{ toX[i], toY[i] });
+			checksum += signedAngles[count / 2];
+		});
+	const auto batchSignedAngle = Time(settings, [&]()
+		{
+			Elite::SignedAngles(fromX.data(), fromY.data(), toX.data(), toY.data(), count, signedAngles.data());
+			checksum += signedAngles[count / 2];
+		});
+
+	const auto printRow = [](const char* pName, double libmNs, double scalarNs, double batchNs)
+	{
+		std::cout << "  " << pName << libmNs << " ns -> " << scalarNs << " ns scalar (" << libmNs / scalarNs << "x), "
+			<< batchNs << " ns batched (" << libmNs / batchNs << "x)\n";
+	};
+	std::cout << "Per angle, libm -> fast (checksum " << checksum << ")\n";
+	printRow("Wrap:            ", libmWrap, scalarWrap, batchWrap);
+	printRow("Direction:       ", libmDirection, scalarDirection, batchDirection);
+	printRow("Signed angle:    ", libmSignedAngle, scalarSignedAngle, batchSignedAngle);
+
+	if (sameResults == false || inRange == false)
+	{
+		std::cerr << "The batched functions didn't return the same results as the scalar ones, or a wrapped angle was out of range!\n";
+		return 1;
+	}
+	if (wrapError.Max > 1e-6 || directionError.Max > 1e-6 || signedAngleError.Max > 1e-6)
+	{
+		std::cerr << "The errors are above what the plugin counts on!\n";
+		return 1;
+	}
+
+	return 0;
+}
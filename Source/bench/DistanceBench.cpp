@@ -0,0 +1,203 @@
+#include "stdafx.h"
+#include <chrono>
+#include <Exam_HelperStructs.h>
+
+// Microbenchmark of the batch distance queries (EVector2SoA.h) against the scalar loops they replaced in the plugin
+// (closest entity with two Distance() calls per comparison, radius filter and closest purge zone edge),
+// at 10, 100 and 1000 entities. Every query is checked against its scalar counterpart
+// Usage: DistanceBench [--seed <n>] [--queries <n>]
+
+namespace
+{
+	struct BenchSettings
+	{
+		int Seed = 1234;
+		int Queries = 200000; // Per entity count, spread over as many query positions
+		float WorldSize = 400.f;
+		float Radius = 50.f;
+		size_t K = 4;
+	};
+
+	struct Scene
+	{
+		vector<EntityInfo> Entities; // How the plugin gets them from the interface
+		vector<PurgeZoneInfo> Zones;
+		Elite::Vector2SoA Positions; // Same positions, as SoA
+		Elite::Vector2SoA ZoneCenters;
+		vector<float> ZoneRadii;
+		vector<Elite::Vector2> QueryPositions;
+	};
+
+	Scene CreateScene(size_t nrOfEntities, const BenchSettings& settings)
+	{
+		mt19937 randomEngine{ unsigned(settings.Seed) };
+		uniform_real_distribution<float> coordinate{ -settings.WorldSize / 2.f, settings.WorldSize / 2.f };
+		uniform_real_distribution<float> radius{ 10.f, 20.f };
+
+		Scene scene{};
+		for (size_t i = 0; i < nrOfEntities; ++i)
+		{
+			const Elite::Vector2 position{ coordinate(randomEngine), coordinate(randomEngine) };
+			scene.Entities.push_back(EntityInfo{ eEntityType::ENEMY, position, int(i) });
+			scene.Positions.PushBack(position);
+
+			PurgeZoneInfo zone{};
+			zone.Center = position;
+			zone.Radius = radius(randomEngine);
+			scene.Zones.push_back(zone);
+			scene.ZoneCenters.PushBack(zone.Center);
+			scene.ZoneRadii.push_back(zone.Radius);
+		}
+
+		for (int i = 0; i < 1024; ++i)
+			scene.QueryPositions.push_back(Elite::Vector2{ coordinate(randomEngine), coordinate(randomEngine) });
+
+		return scene;
+	}
+
+	// The scalar loops, as they were written in the plugin
+	int ScalarClosest(const vector<EntityInfo>& entities, const Elite::Vector2& position)
+	{
+		int closestIdx = 0;
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			if (entities[i].Location.Distance(position) < entities[closestIdx].Location.Distance(position))
+				closestIdx = int(i);
+		}
+		return closestIdx;
+	}
+
+	size_t ScalarInRadius(const vector<EntityInfo>& entities, const Elite::Vector2& position, float radius, vector<int>& indices)
+	{
+		indices.clear();
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			if (entities[i].Location.Distance(position) <= radius)
+				indices.push_back(int(i));
+		}
+		return indices.size();
+	}
+
+	int ScalarClosestEdge(const vector<PurgeZoneInfo>& zones, const Elite::Vector2& position)
+	{
+		int closestIdx = 0;
+		for (size_t i = 0; i < zones.size(); ++i)
+		{
+			if (zones[i].Center.Distance(position) - zones[i].Radius < zones[closestIdx].Center.Distance(position) - zones[closestIdx].Radius)
+				closestIdx = int(i);
+		}
+		return closestIdx;
+	}
+
+	size_t ScalarClosestK(const vector<EntityInfo>& entities, const Elite::Vector2& position, size_t k, vector<int>& indices)
+	{
+		indices.resize(entities.size());
+		for (size_t i = 0; i < entities.size(); ++i)
+			indices[i] = int(i);
+
+		const auto nrFound = min(k, entities.size());
+		partial_sort(indices.begin(), indices.begin() + nrFound, indices.end(), [&](int a, int b)
+			{
+				const auto distanceA = entities[a].Location.DistanceSquared(position);
+				const auto distanceB = entities[b].Location.DistanceSquared(position);
+				return distanceA < distanceB || (distanceA == distanceB && a < b);
+			});
+		indices.resize(nrFound);
+		return nrFound;
+	}
+
+	// Runs the query for every query position (round robin), returns the ns per query
+	template<typename Query>
+	double Time(const Scene& scene, const BenchSettings& settings, size_t& checksum, Query query)
+	{
+		const auto startTime = chrono::steady_clock::now();
+		for (int i = 0; i < settings.Queries; ++i)
+			checksum += query(scene.QueryPositions[i & 1023]);
+		const auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - startTime).count();
+		return elapsed / double(settings.Queries);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	BenchSettings settings{};
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--seed" && hasValue)
+			settings.Seed = stoi(argv[++i]);
+		else if (arg == "--queries" && hasValue)
+			settings.Queries = max(1, stoi(argv[++i]));
+		else
+		{
+			std::cout << "Usage: DistanceBench [--seed <n>] [--queries <n>]\n";
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+#if defined(ELITE_SIMD_AVX2)
+	std::cout << "Kernels: AVX2\n";
+#elif defined(ELITE_SIMD_SSE2)
+	std::cout << "Kernels: SSE2\n";
+#else
+	std::cout << "Kernels: scalar\n";
+#endif
+
+	bool sameResults = true;
+	for (const size_t nrOfEntities : { size_t(10), size_t(100), size_t(1000) })
+	{
+		const auto scene = CreateScene(nrOfEntities, settings);
+
+		// Check every query against the scalar loops first
+		vector<int> expected{};
+		vector<int> actual{};
+		vector<int> closestIndices(settings.K);
+		vector<float> closestDistances(settings.K);
+		for (const auto& position : scene.QueryPositions)
+		{
+			sameResults = sameResults && Elite::ClosestPoint(scene.Positions, position) == ScalarClosest(scene.Entities, position);
+			sameResults = sameResults && Elite::ClosestCircleEdge(scene.ZoneCenters, scene.ZoneRadii, position) == ScalarClosestEdge(scene.Zones, position);
+
+			ScalarInRadius(scene.Entities, position, settings.Radius, expected);
+			Elite::PointsInRadius(scene.Positions, position, settings.Radius, actual);
+			sameResults = sameResults && expected == actual;
+
+			ScalarClosestK(scene.Entities, position, settings.K, expected);
+			actual.assign(closestIndices.begin(), closestIndices.begin() + Elite::ClosestPoints(scene.Positions, position, settings.K, closestIndices.data(), closestDistances.data()));
+			sameResults = sameResults && expected == actual;
+		}
+
+		size_t checksum = 0;
+		const auto scalarClosest = Time(scene, settings, checksum, [&](const Elite::Vector2& position) { return size_t(ScalarClosest(scene.Entities, position)); });
+		const auto batchClosest = Time(scene, settings, checksum, [&](const Elite::Vector2& position) { return size_t(Elite::ClosestPoint(scene.Positions, position)); });
+		const auto scalarRadius = Time(scene, settings, checksum, [&](const Elite::Vector2& position) { return ScalarInRadius(scene.Entities, position, settings.Radius, expected); });
+		const auto batchRadius = Time(scene, settings, checksum, [&](const Elite::Vector2& position) { Elite::PointsInRadius(scene.Positions, position, settings.Radius, actual); return actual.size(); });
+		const auto scalarEdge = Time(scene, settings, checksum, [&](const Elite::Vector2& position) { return size_t(ScalarClosestEdge(scene.Zones, position)); });
+		const auto batchEdge = Time(scene, settings, checksum, [&](const Elite::Vector2& position) { return size_t(Elite::ClosestCircleEdge(scene.ZoneCenters, scene.ZoneRadii, position)); });
+		const auto scalarK = Time(scene, settings, checksum, [&](const Elite::Vector2& position) { return ScalarClosestK(scene.Entities, position, settings.K, expected); });
+		const auto batchK = Time(scene, settings, checksum, [&](const Elite::Vector2& position)
+			{
+				return Elite::ClosestPoints(scene.Positions, position, settings.K, closestIndices.data(), closestDistances.data());
+			});
+
+		const auto printRow = [](const char* pName, double scalarNs, double batchNs)
+		{
+			std::cout << "  " << pName << scalarNs << " ns -> " << batchNs << " ns (" << scalarNs / batchNs << "x)\n";
+		};
+		std::cout << nrOfEntities << " entities (checksum " << checksum << ")\n";
+		printRow("Closest:         ", scalarClosest, batchClosest);
+		printRow("In radius:       ", scalarRadius, batchRadius);
+		printRow("Closest edge:    ", scalarEdge, batchEdge);
+		printRow("Closest 4:       ", scalarK, batchK);
+	}
+
+	if (sameResults == false)
+	{
+		std::cerr << "The batch queries didn't return the same results as the scalar loops!\n";
+		return 1;
+	}
+
+	return 0;
+}
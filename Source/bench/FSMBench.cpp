@@ -0,0 +1,322 @@
+#include "stdafx.h"
+#include <chrono>
+#include <IExamPlugin.h>
+#include "HeadlessWorld.h"
+#include "LevelData.h"
+#include "Perception.h"
+#include "FiniteStateMachine.h"
+#include "MovementGraph.h"
+#include "Inventory.h"
+#include "EnemyTracks.h"
+#include "HouseMemory.h"
+#include "NavGrid.h"
+#include "DangerField.h"
+#include "InfluenceMap.h"
+#include "MapFiniteStateMachine.h"
+
+// Microbenchmark of FiniteStateMachine::Update() on the movement graph (see CreateMovementGraph())
+// A headless episode of the full plugin is recorded first (one perception snapshot per frame), after which the
+// same frames are replayed through the flat-table FSM, the previous std::map based one, and the compile-time one (StaticMovementFSM)
+// Since most of that time is spent inside the states themselves, the graph's layout is also driven with stub states
+// and transitions (firing pseudo-randomly, each of its own type for the compile-time one), which only measures the FSM's own dispatching
+// The flat-table FSM's budget report (see FSMBudget) of the last replay is printed as well
+// Usage: FSMBench [--level <file.gppl>] [--seed <n>] [--duration <seconds>] [--rounds <n>]
+
+extern "C" IPluginBase* Register();
+
+namespace
+{
+	// Stubs for the dispatch-only run, one type per state and transition of the graph
+	template<size_t StateIdx>
+	class StubState final : public FSMState
+	{
+	public:
+		SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
+		{
+			SteeringPlugin_Output steering{};
+			steering.LinearVelocity.x = deltaTime;
+			return steering;
+		}
+	};
+
+	template<size_t TransitionIdx>
+	class StubTransition final : public FSMTransition
+	{
+	public:
+		explicit StubTransition(uint32_t& randomState) : m_RandomState(randomState) {}
+		void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override {}
+		bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
+		{
+			// Fires about once every 64 evaluations
+			m_RandomState = m_RandomState * 1664525u + 1013904223u;
+			return (m_RandomState >> 26) == 0;
+		}
+
+	private:
+		uint32_t& m_RandomState;
+	};
+
+	// The movement graph's layout with the stubs in it, for both kinds of FSMs
+	template<typename TStates, typename TTransitions>
+	struct StubGraph
+	{
+		FSMState* pStartState;
+		vector<MovementGraph::Edge> Edges;
+		typename TStates::Pointers TypedStates;
+		typename TTransitions::Pointers TypedTransitions;
+	};
+
+	template<typename TStates, typename TTransitions, typename TEdges, typename TStateIndices, typename TTransitionIndices>
+	struct StubLayout;
+
+	template<typename... TStates, typename... TTransitions, typename... TEdges, size_t... StateIndices, size_t... TransitionIndices>
+	struct StubLayout<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>, index_sequence<StateIndices...>, index_sequence<TransitionIndices...>>
+	{
+		template<typename T>
+		using StateStub = StubState<FSMIndexOf<T, TStates...>::value>;
+		template<typename T>
+		using TransitionStub = StubTransition<FSMIndexOf<T, TTransitions...>::value>;
+
+		using States = FSMTypeList<StubState<StateIndices>...>;
+		using Transitions = FSMTypeList<StubTransition<TransitionIndices>...>;
+		using Edges = FSMTypeList<FSMEdge<StateStub<typename TEdges::From>, StateStub<typename TEdges::To>, TransitionStub<typename TEdges::Transition>>...>;
+		using StaticFSM = StaticFiniteStateMachine<States, Transitions, Edges>;
+		using Graph = StubGraph<States, Transitions>;
+
+		// The transitions get the same rates as the graph's own, but aren't timed (that's not dispatching)
+		static Graph Create(FSMArena& arena, const MovementGraph& graph, uint32_t& randomState)
+		{
+			Graph stubs{};
+			stubs.TypedStates = make_tuple(arena.Create<StubState<StateIndices>>()...);
+			stubs.TypedTransitions = make_tuple(arena.Create<StubTransition<TransitionIndices>>(randomState)...);
+			using Expand = int[];
+			(void)Expand{ 0, (get<TransitionIndices>(stubs.TypedTransitions)->SetBudget(FSMBudget{ 0.f, graph.Transitions[TransitionIndices]->GetBudget().Interval }), 0)... };
+
+			stubs.pStartState = get<0>(stubs.TypedStates);
+			stubs.Edges = { MovementGraph::Edge{ get<StateStub<typename TEdges::From>*>(stubs.TypedStates), get<StateStub<typename TEdges::To>*>(stubs.TypedStates),
+				get<TransitionStub<typename TEdges::Transition>*>(stubs.TypedTransitions) }... };
+			return stubs;
+		}
+	};
+
+	using MovementStubs = StubLayout<MovementStates, MovementTransitions, MovementEdges, make_index_sequence<MovementStates::Size>, make_index_sequence<MovementTransitions::Size>>;
+
+	// The runtime FSMs get the graph through AddTransition(), the compile-time ones only need its states and transitions
+	template<typename FSM, typename Graph>
+	enable_if_t<is_constructible<FSM, FSMState*, IExamInterface*>::value, unique_ptr<FSM>> CreateFSM(const Graph& graph, IExamInterface* pInterface)
+	{
+		auto pFSM = make_unique<FSM>(graph.pStartState, pInterface);
+		for (const auto& edge : graph.Edges)
+			pFSM->AddTransition(edge.pFromState, edge.pToState, edge.pTransition);
+		return pFSM;
+	}
+
+	template<typename FSM, typename Graph>
+	enable_if_t<is_constructible<FSM, FSMState*, IExamInterface*>::value == false, unique_ptr<FSM>> CreateFSM(const Graph& graph, IExamInterface* pInterface)
+	{
+		return make_unique<FSM>(graph.TypedStates, graph.TypedTransitions, pInterface);
+	}
+
+	struct BenchSettings
+	{
+		string LevelFile = GameDebugParams{}.LevelFile;
+		int Seed = 1234;
+		float Duration = 300.f;
+		int Rounds = 10;
+		int DispatchTicks = 1000000;
+		float TimeStep = 1.f / 60.f;
+	};
+
+	// Runs the full plugin in a headless world, snapshotting what it perceives every frame
+	vector<Perception> RecordFrames(const LevelData& level, const BenchSettings& settings, HeadlessWorld*& pFinalWorld)
+	{
+		auto* pPlugin = static_cast<IExamPlugin*>(Register());
+		pPlugin->DllInit();
+
+		GameDebugParams params{};
+		params.Seed = settings.Seed;
+		pPlugin->InitGameDebugParams(params);
+		params.GodMode = true; // Keep the episode going for the whole duration
+
+		pFinalWorld = new HeadlessWorld{ level, params };
+		PluginInfo info{};
+		pPlugin->Initialize(pFinalWorld, info);
+
+		vector<Perception> frames{};
+		frames.reserve(size_t(settings.Duration / settings.TimeStep) + 1);
+		while (pFinalWorld->GetTimeSurvived() < settings.Duration)
+		{
+			pFinalWorld->BeginFrame();
+			frames.push_back(Perception{});
+			frames.back().Refresh(pFinalWorld);
+
+			const auto steering = pPlugin->UpdateSteering(settings.TimeStep);
+			pFinalWorld->Step(steering, settings.TimeStep);
+		}
+
+		pPlugin->DllShutdown();
+		delete pPlugin;
+		return frames;
+	}
+
+	struct ReplayResult
+	{
+		double Seconds; // Spent in the FSM's Update()
+		float Checksum; // Of the steering, both FSMs have to end up with the same one
+		vector<FSMBudgetStats> BudgetStats; // Only the flat-table FSM keeps them
+	};
+
+	vector<FSMBudgetStats> GetBudgetStats(const FiniteStateMachine& fsm) { return fsm.GetBudgetStats(); }
+	template<typename FSM>
+	vector<FSMBudgetStats> GetBudgetStats(const FSM& fsm) { return {}; }
+
+	// Replays the frames through a fresh copy of the movement graph
+	template<typename FSM>
+	ReplayResult ReplayFrames(const vector<Perception>& frames, const HeadlessWorld& finalWorld, const NavGrid& navGrid, const BenchSettings& settings)
+	{
+		HeadlessWorld world{ finalWorld }; // The states can grab items and such, so every replay gets its own world
+		Inventory inventory{ &world }; // Picks up where the recorded plugin's inventory was left
+		EnemyTracks enemyTracks{};
+		DangerField dangerField{};
+		dangerField.SetNavGrid(&navGrid);
+		HouseMemory houseMemory{};
+		InfluenceMap influenceMap{};
+		FSMArena arena{}; // Outlives the FSM, which doesn't take it over (the reference one couldn't)
+		auto graph = CreateMovementGraph(arena, &inventory, &enemyTracks, &dangerField, &influenceMap, &houseMemory, &navGrid, uint32_t(settings.Seed)); // The same random choices as the recorded plugin
+
+		auto pFSM = CreateFSM<FSM>(graph, &world);
+
+		float checksum = 0.f;
+
+		const auto startTime = chrono::steady_clock::now();
+		for (const auto& frame : frames)
+		{
+			enemyTracks.Update(frame); // Part of the plugin's frame, not the FSM's, but both FSMs pay for it
+			dangerField.Update(enemyTracks, frame.GetWorldInfo());
+			houseMemory.Update(frame);
+			influenceMap.Update(settings.TimeStep, frame, houseMemory);
+			checksum += pFSM->Update(settings.TimeStep, frame).LinearVelocity.x;
+		}
+		const auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+		return ReplayResult{ elapsed, checksum, GetBudgetStats(*pFSM) };
+	}
+
+	// Drives the movement graph's layout with stubs, so only the dispatching gets measured
+	template<typename FSM>
+	ReplayResult DispatchOnly(const Perception& frame, const BenchSettings& settings)
+	{
+		FSMArena graphArena{};
+		const auto graph = CreateMovementGraph(graphArena, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, uint32_t(settings.Seed));
+
+		// Same layout, stubbed out
+		uint32_t randomState = uint32_t(settings.Seed);
+		FSMArena arena{};
+		const auto stubs = MovementStubs::Create(arena, graph, randomState);
+		auto pFSM = CreateFSM<FSM>(stubs, nullptr);
+		graphArena.Release(); // Only the layout was needed
+
+		float checksum = 0.f;
+		const auto startTime = chrono::steady_clock::now();
+		for (int tick = 0; tick < settings.DispatchTicks; ++tick)
+			checksum += pFSM->Update(settings.TimeStep, frame).LinearVelocity.x;
+		const auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+		return ReplayResult{ elapsed, checksum + float(randomState), {} };
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	BenchSettings settings{};
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--level" && hasValue)
+			settings.LevelFile = argv[++i];
+		else if (arg == "--seed" && hasValue)
+			settings.Seed = stoi(argv[++i]);
+		else if (arg == "--duration" && hasValue)
+			settings.Duration = stof(argv[++i]);
+		else if (arg == "--rounds" && hasValue)
+			settings.Rounds = max(1, stoi(argv[++i]));
+		else
+		{
+			std::cout << "Usage: FSMBench [--level <file.gppl>] [--seed <n>] [--duration <seconds>] [--rounds <n>]\n";
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	LevelData level{};
+	if (level.Load(settings.LevelFile) == false)
+	{
+		std::cerr << "Couldn't load level \"" << settings.LevelFile << "\"\n";
+		return 1;
+	}
+
+	// The reference FSM still logs to the console, which would drown out everything else
+	std::cout.setstate(ios::badbit);
+
+	HeadlessWorld* pFinalWorld = nullptr;
+	const auto frames = RecordFrames(level, settings, pFinalWorld);
+	NavGrid navGrid{}; // Built like the plugin builds its own
+	navGrid.Build(level, frames.front().GetAgentInfo().AgentSize);
+
+	// Interleaved rounds, keeping the best time of each
+	double bestMap = DBL_MAX;
+	double bestFlat = DBL_MAX;
+	double bestStatic = DBL_MAX;
+	bool sameSteering = true;
+	vector<FSMBudgetStats> budgetStats{};
+	for (int round = 0; round < settings.Rounds; ++round)
+	{
+		const auto mapResult = ReplayFrames<MapFiniteStateMachine>(frames, *pFinalWorld, navGrid, settings);
+		auto flatResult = ReplayFrames<FiniteStateMachine>(frames, *pFinalWorld, navGrid, settings);
+		const auto staticResult = ReplayFrames<StaticMovementFSM>(frames, *pFinalWorld, navGrid, settings);
+		bestMap = min(bestMap, mapResult.Seconds);
+		bestFlat = min(bestFlat, flatResult.Seconds);
+		bestStatic = min(bestStatic, staticResult.Seconds);
+		sameSteering = sameSteering && mapResult.Checksum == flatResult.Checksum && staticResult.Checksum == flatResult.Checksum;
+		budgetStats = move(flatResult.BudgetStats);
+	}
+
+	double bestMapDispatch = DBL_MAX;
+	double bestFlatDispatch = DBL_MAX;
+	double bestStaticDispatch = DBL_MAX;
+	for (int round = 0; round < settings.Rounds; ++round)
+	{
+		const auto mapResult = DispatchOnly<MapFiniteStateMachine>(frames.back(), settings);
+		const auto flatResult = DispatchOnly<FiniteStateMachine>(frames.back(), settings);
+		const auto staticResult = DispatchOnly<MovementStubs::StaticFSM>(frames.back(), settings);
+		bestMapDispatch = min(bestMapDispatch, mapResult.Seconds);
+		bestFlatDispatch = min(bestFlatDispatch, flatResult.Seconds);
+		bestStaticDispatch = min(bestStaticDispatch, staticResult.Seconds);
+		sameSteering = sameSteering && mapResult.Checksum == flatResult.Checksum && staticResult.Checksum == flatResult.Checksum;
+	}
+
+	SAFE_DELETE(pFinalWorld);
+	std::cout.clear();
+
+	const auto nsPerTick = [](double seconds, size_t ticks) { return seconds * 1e9 / double(ticks); };
+	const auto nrOfDispatchTicks = size_t(settings.DispatchTicks);
+	std::cout << "Recorded frames:  " << frames.size() << " (" << settings.Rounds << " rounds, best of each)\n";
+	std::cout << "  std::map FSM:   " << nsPerTick(bestMap, frames.size()) << " ns/tick\n";
+	std::cout << "  Flat table FSM: " << nsPerTick(bestFlat, frames.size()) << " ns/tick\n";
+	std::cout << "  Static FSM:     " << nsPerTick(bestStatic, frames.size()) << " ns/tick\n";
+	std::cout << "  Speedup:        " << bestMap / bestFlat << "x (flat), " << bestFlat / bestStatic << "x (static over flat)\n";
+	std::cout << "Dispatch only:    " << nrOfDispatchTicks << " ticks\n";
+	std::cout << "  std::map FSM:   " << nsPerTick(bestMapDispatch, nrOfDispatchTicks) << " ns/tick\n";
+	std::cout << "  Flat table FSM: " << nsPerTick(bestFlatDispatch, nrOfDispatchTicks) << " ns/tick\n";
+	std::cout << "  Static FSM:     " << nsPerTick(bestStaticDispatch, nrOfDispatchTicks) << " ns/tick\n";
+	std::cout << "  Speedup:        " << bestMapDispatch / bestFlatDispatch << "x (flat), " << bestFlatDispatch / bestStaticDispatch << "x (static over flat)\n";
+	std::cout << "Budgets (last replay):\n";
+	FiniteStateMachine::PrintBudgetReport(std::cout, budgetStats);
+	if (sameSteering == false)
+	{
+		std::cerr << "The FSMs didn't produce the same steering!\n";
+		return 1;
+	}
+
+	return 0;
+}
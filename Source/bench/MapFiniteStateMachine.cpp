@@ -0,0 +1,82 @@
+#include "stdafx.h"
+#include "MapFiniteStateMachine.h"
+
+MapFiniteStateMachine::MapFiniteStateMachine(FSMState* startState, IExamInterface* pInterface)
+	: m_Transitions()
+	, m_pStartState(startState)
+	, m_pCurrentState(nullptr)
+	, m_pInterface(pInterface)
+{
+}
+
+void MapFiniteStateMachine::AddTransition(FSMState* startState, FSMState* toState, FSMTransition* transition)
+{
+	auto it = m_Transitions.find(startState);
+	if (it == m_Transitions.end())
+	{
+		m_Transitions[startState] = Transitions();
+	}
+
+	m_Transitions[startState].push_back(TransitionStatePair{ transition, toState, 0, 0.f });
+}
+
+SteeringPlugin_Output MapFiniteStateMachine::Update(float deltaTime, const Perception& perception)
+{
+	if (m_pStartState)
+	{
+		SetState(m_pStartState, perception);
+		m_pStartState = nullptr;
+	}
+
+	auto it = m_Transitions.find(m_pCurrentState);
+	if (it != m_Transitions.end())
+	{
+		for (TransitionStatePair& transPair : it->second)
+		{
+			transPair.PendingTime += deltaTime;
+			if (transPair.TicksToWait > 0)
+			{
+				--transPair.TicksToWait;
+				continue;
+			}
+			transPair.TicksToWait = max(transPair.first->GetBudget().Interval, 1u) - 1;
+
+			transPair.first->Update(transPair.PendingTime, m_pInterface, perception);
+			transPair.PendingTime = 0.f;
+			if (transPair.first->ToTransition(m_pInterface, perception))
+			{
+				SetState(transPair.second, perception);
+				break;
+			}
+		}
+	}
+
+	if (m_pCurrentState)
+		return m_pCurrentState->Update(deltaTime, m_pInterface, perception);
+
+	return SteeringPlugin_Output{};
+}
+
+void MapFiniteStateMachine::SetState(FSMState* newState, const Perception& perception)
+{
+	if (m_pCurrentState)
+		m_pCurrentState->OnExit(m_pInterface);
+
+	m_pCurrentState = newState;
+
+	if (m_pCurrentState)
+	{
+		std::cout << "Entering state: " << typeid(*m_pCurrentState).name() << std::endl;
+		m_pCurrentState->OnEnter(m_pInterface, perception);
+
+		auto it = m_Transitions.find(m_pCurrentState);
+		if (it != m_Transitions.end())
+		{
+			for (size_t i = 0; i < it->second.size(); ++i)
+			{
+				it->second[i].TicksToWait = uint32_t(i) % max(it->second[i].first->GetBudget().Interval, 1u);
+				it->second[i].PendingTime = 0.f;
+			}
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <map>
+#include "FiniteStateMachine.h"
+
+// The FSM as it was before the flat transition table, kept as the benchmark's reference
+// (in its own translation unit, just like the real one, so neither gets inlined into the benchmark loop)
+// It does honor the transitions' intervals (see FSMBudget), for both to take the same transitions, but doesn't time anything
+class MapFiniteStateMachine final
+{
+public:
+	MapFiniteStateMachine(FSMState* startState, IExamInterface* pInterface);
+	~MapFiniteStateMachine() = default;
+
+	void AddTransition(FSMState* startState, FSMState* toState, FSMTransition* transition);
+	SteeringPlugin_Output Update(float deltaTime, const Perception& perception);
+
+private:
+	void SetState(FSMState* newState, const Perception& perception);
+
+	struct TransitionStatePair
+	{
+		FSMTransition* first;
+		FSMState* second;
+		uint32_t TicksToWait;
+		float PendingTime;
+	};
+	typedef std::vector<TransitionStatePair> Transitions;
+
+	map<FSMState*, Transitions> m_Transitions;
+	FSMState* m_pStartState;
+	FSMState* m_pCurrentState;
+	IExamInterface* m_pInterface;
+};
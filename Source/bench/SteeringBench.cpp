@@ -0,0 +1,165 @@
+#include "stdafx.h"
+#include <chrono>
+#include "SteeringBlender.h"
+
+// Microbenchmark of the steering blenders (see SteeringBlender.h): the runtime one, calling a BotFinalBehavior's behaviours through their
+// vtables, against the compile-time one (StaticSteeringBlender) on the same set of behaviours, weighted and by priority
+// Both get the same (pseudo-random) agents and targets, and it fails if they don't blend them into the same steering
+// Usage: SteeringBench [--seed <n>] [--count <n>] [--rounds <n>]
+
+namespace
+{
+	struct BenchSettings
+	{
+		int Seed = 1234;
+		int Count = 4096; // Agents per round
+		int Rounds = 200;
+	};
+
+	struct Frame
+	{
+		AgentInfo Agent;
+		Elite::Vector2 Target;
+		float SeekWeight; // 0 half of the time, for the priority blend to fall through to the next one
+	};
+
+	bool IsSame(const SteeringPlugin_Output& a, const SteeringPlugin_Output& b)
+	{
+		return a.LinearVelocity == b.LinearVelocity && a.AngularVelocity == b.AngularVelocity && a.RunMode == b.RunMode && a.AutoOrient == b.AutoOrient;
+	}
+
+	// Runs the function on every frame every round, returns the ns per frame
+	template<typename Function>
+	double Time(const BenchSettings& settings, const vector<Frame>& frames, Function function)
+	{
+		const auto startTime = chrono::steady_clock::now();
+		for (int round = 0; round < settings.Rounds; ++round)
+			for (const auto& frame : frames)
+				function(frame);
+		const auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - startTime).count();
+		return elapsed / (double(settings.Rounds) * double(frames.size()));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	BenchSettings settings{};
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--seed" && hasValue)
+			settings.Seed = stoi(argv[++i]);
+		else if (arg == "--count" && hasValue)
+			settings.Count = max(1, stoi(argv[++i]));
+		else if (arg == "--rounds" && hasValue)
+			settings.Rounds = max(1, stoi(argv[++i]));
+		else
+		{
+			std::cout << "Usage: SteeringBench [--seed <n>] [--count <n>] [--rounds <n>]\n";
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	mt19937 randomEngine{ unsigned(settings.Seed) };
+	uniform_real_distribution<float> coordinate{ -100.f, 100.f };
+	uniform_real_distribution<float> orientation{ -10.f, 10.f };
+	vector<Frame> frames(size_t(settings.Count));
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		auto& frame = frames[i];
+		frame.Agent = AgentInfo{};
+		frame.Agent.Position = Elite::Vector2{ coordinate(randomEngine), coordinate(randomEngine) };
+		frame.Agent.Orientation = orientation(randomEngine);
+		frame.Agent.MaxLinearSpeed = 5.f;
+		frame.Agent.MaxAngularSpeed = 5.f;
+		frame.Target = Elite::Vector2{ coordinate(randomEngine), coordinate(randomEngine) };
+		frame.SeekWeight = i % 2 == 0 ? 1.f : 0.f;
+	}
+
+	// Weighted: go for the target while turning towards it, and keep away from where the agent was headed
+	// Priority: seek the target if there's one, wander otherwise (what WanderLookingBackState does)
+	Seek seek{};
+	Flee flee{};
+	Arrive arrive{};
+	Face face{};
+	SteeringBlender weighted{ eSteeringBlend::Weighted };
+	weighted.SetBehaviors({ { &seek, 1.f }, { &flee, 0.25f }, { &arrive, 0.5f }, { &face, 1.f } });
+	StaticSteeringBlender<Seek, Flee, Arrive, Face> staticWeighted{ eSteeringBlend::Weighted };
+	staticWeighted.SetWeight(1, 0.25f);
+	staticWeighted.SetWeight(2, 0.5f);
+
+	Seek prioritySeek{};
+	Wander wander{};
+	SteeringBlender priority{ eSteeringBlend::Priority };
+	priority.SetBehaviors({ { &prioritySeek, 1.f }, { &wander, 1.f } });
+	StaticSteeringBlender<Seek, Wander> staticPriority{ eSteeringBlend::Priority };
+
+	const auto setWeightedTargets = [&](const Frame& frame)
+	{
+		seek.SetTarget(frame.Target);
+		arrive.SetTarget(frame.Target);
+		face.SetTarget(frame.Target);
+		flee.SetTarget(frame.Agent.Position + Elite::DirectionFromOrientation(frame.Agent.Orientation));
+		staticWeighted.Get<0>().SetTarget(frame.Target);
+		staticWeighted.Get<2>().SetTarget(frame.Target);
+		staticWeighted.Get<3>().SetTarget(frame.Target);
+		staticWeighted.Get<1>().SetTarget(frame.Agent.Position + Elite::DirectionFromOrientation(frame.Agent.Orientation));
+	};
+	const auto setPriorityTargets = [&](const Frame& frame)
+	{
+		prioritySeek.SetTarget(frame.Target);
+		priority.SetWeight(0, frame.SeekWeight);
+		staticPriority.Get<0>().SetTarget(frame.Target);
+		staticPriority.SetWeight(0, frame.SeekWeight);
+	};
+
+	// Both have to blend every frame into the same steering (the wander ones stay in step, since they're called as often)
+	bool sameResults = true;
+	for (const auto& frame : frames)
+	{
+		setWeightedTargets(frame);
+		setPriorityTargets(frame);
+		sameResults = sameResults && IsSame(weighted.CalculateSteering(frame.Agent), staticWeighted.CalculateSteering(frame.Agent))
+			&& IsSame(priority.CalculateSteering(frame.Agent), staticPriority.CalculateSteering(frame.Agent));
+	}
+
+	float checksum = 0.f;
+	const auto runtimeWeighted = Time(settings, frames, [&](const Frame& frame)
+		{
+			setWeightedTargets(frame);
+			checksum += weighted.CalculateSteering(frame.Agent).LinearVelocity.x;
+		});
+	const auto compileTimeWeighted = Time(settings, frames, [&](const Frame& frame)
+		{
+			setWeightedTargets(frame);
+			checksum += staticWeighted.CalculateSteering(frame.Agent).LinearVelocity.x;
+		});
+	const auto runtimePriority = Time(settings, frames, [&](const Frame& frame)
+		{
+			setPriorityTargets(frame);
+			checksum += priority.CalculateSteering(frame.Agent).LinearVelocity.x;
+		});
+	const auto compileTimePriority = Time(settings, frames, [&](const Frame& frame)
+		{
+			setPriorityTargets(frame);
+			checksum += staticPriority.CalculateSteering(frame.Agent).LinearVelocity.x;
+		});
+
+	const auto printRow = [](const char* pName, double runtimeNs, double compileTimeNs)
+	{
+		std::cout << "  " << pName << runtimeNs << " ns -> " << compileTimeNs << " ns (" << runtimeNs / compileTimeNs << "x)\n";
+	};
+	std::cout << "Per blend, runtime -> compile-time (checksum " << checksum << ")\n";
+	printRow("Weighted (4):    ", runtimeWeighted, compileTimeWeighted);
+	printRow("Priority (2):    ", runtimePriority, compileTimePriority);
+
+	if (sameResults == false)
+	{
+		std::cerr << "The compile-time blender didn't blend the same steering as the runtime one!\n";
+		return 1;
+	}
+
+	return 0;
+}
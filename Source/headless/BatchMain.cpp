@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include <iomanip>
+#include "LevelData.h"
+#include "BatchRunner.h"
+
+// Batch runner: many independent headless episodes of the plugin at once (one per seed), spread over a thread pool
+// Replaces launching a handful of windowed games by hand (Build/4WindowExamRunner.bat) to compare runs
+// Usage: BatchRunner [--level <file.gppl>] [--episodes <n>] [--first-seed <n>] [--threads <n>] [--enemies <n>] [--duration <seconds>] [--dt <seconds>] [--god]
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::cout << "Usage: BatchRunner [--level <file.gppl>] [--episodes <n>] [--first-seed <n>] [--threads <n>] [--enemies <n>] [--duration <seconds>] [--dt <seconds>] [--god]\n";
+	}
+
+	void PrintStat(const char* pName, const BatchStat& stat)
+	{
+		std::cout << pName << "min " << stat.Min << ", mean " << stat.Mean << ", max " << stat.Max << '\n';
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	string levelFile = GameDebugParams{}.LevelFile;
+	BatchSettings settings{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--level" && hasValue)
+			levelFile = argv[++i];
+		else if (arg == "--episodes" && hasValue)
+			settings.Episodes = stoi(argv[++i]);
+		else if (arg == "--first-seed" && hasValue)
+			settings.FirstSeed = stoi(argv[++i]);
+		else if (arg == "--threads" && hasValue)
+			settings.Threads = stoi(argv[++i]);
+		else if (arg == "--enemies" && hasValue)
+			settings.Episode.EnemyCount = stoi(argv[++i]);
+		else if (arg == "--duration" && hasValue)
+			settings.Episode.Duration = stof(argv[++i]);
+		else if (arg == "--dt" && hasValue)
+			settings.Episode.TimeStep = stof(argv[++i]);
+		else if (arg == "--god")
+			settings.Episode.GodMode = true;
+		else
+		{
+			PrintUsage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	LevelData level{};
+	if (level.Load(levelFile) == false)
+	{
+		std::cerr << "Couldn't load level \"" << levelFile << "\"\n";
+		return 1;
+	}
+
+	const auto result = RunBatch(level, settings);
+
+	// Every episode
+	std::cout << "Seed\tOutcome\t\tTime\tScore\tKills\tHits\tMissed\tItems\n";
+	for (const auto& episode : result.Episodes)
+	{
+		const auto& stats = episode.Result.Stats;
+		std::cout << episode.Seed << '\t' << (episode.Result.AgentDied ? "died    " : "survived") << '\t' << fixed << setprecision(1) << stats.TimeSurvived
+			<< '\t' << stats.Score << '\t' << stats.NumEnemiesKilled << '\t' << stats.NumEnemiesHit << '\t' << stats.NumMissedShots << '\t' << stats.NumItemsPickUp << '\n';
+	}
+	std::cout << defaultfloat << setprecision(6);
+
+	// Aggregated
+	std::cout << "\nLevel:            " << levelFile << '\n';
+	std::cout << "Episodes:         " << result.Episodes.size() << " (seeds " << settings.FirstSeed << " to " << settings.FirstSeed + int(result.Episodes.size()) - 1
+		<< ", " << result.Threads << " threads)\n";
+	std::cout << "Deaths:           " << result.Deaths << '\n';
+	PrintStat("Score:            ", result.Score);
+	PrintStat("Time survived:    ", result.TimeSurvived);
+	PrintStat("Enemies killed:   ", result.EnemiesKilled);
+	PrintStat("Missed shots:     ", result.MissedShots);
+	PrintStat("NavMesh queries:  ", result.NavMeshQueriesPerMinute); // Per minute
+	std::cout << "Wall time:        " << result.WallTime << " s\n";
+	if (result.WallTime > 0.0)
+		std::cout << "Throughput:       " << result.SimulatedTime / result.WallTime << " simulated s / wall s\n";
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "BatchRunner.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Profiler.h"
+
+namespace
+{
+	BatchStat Summarize(const vector<BatchEpisode>& episodes, const function<double(const EpisodeResult&)>& getStat)
+	{
+		BatchStat stat{ DBL_MAX, 0.0, -DBL_MAX };
+		for (const auto& episode : episodes)
+		{
+			const auto value = getStat(episode.Result);
+			stat.Min = min(stat.Min, value);
+			stat.Max = max(stat.Max, value);
+			stat.Mean += value;
+		}
+
+		if (episodes.empty())
+			return BatchStat{};
+
+		stat.Mean /= double(episodes.size());
+		return stat;
+	}
+}
+
+BatchResult RunBatch(const LevelData& level, const BatchSettings& settings)
+{
+	BatchResult result{};
+	const auto nrOfEpisodes = max(0, settings.Episodes);
+	result.Episodes.resize(size_t(nrOfEpisodes));
+
+	int nrOfThreads = settings.Threads > 0 ? settings.Threads : int(thread::hardware_concurrency());
+#if PROFILER_ENABLED
+	nrOfThreads = 1; // Every plugin exports the (process-wide) profile when it shuts down, which can't happen while others are still recording
+#endif
+	result.Threads = max(1, min(nrOfThreads, nrOfEpisodes));
+
+	const auto startTime = chrono::steady_clock::now();
+
+	// Every worker keeps taking the next episode until there are none left
+	atomic<int> nextEpisode{ 0 };
+	const auto work = [&]()
+	{
+		for (int episodeIdx = nextEpisode++; episodeIdx < nrOfEpisodes; episodeIdx = nextEpisode++)
+		{
+			auto episodeSettings = settings.Episode;
+			episodeSettings.Seed = settings.FirstSeed + episodeIdx;
+			result.Episodes[episodeIdx] = BatchEpisode{ episodeSettings.Seed, RunEpisode(level, episodeSettings) };
+		}
+	};
+
+	vector<thread> workers{};
+	for (int i = 1; i < result.Threads; ++i)
+		workers.emplace_back(work);
+	work(); // The calling thread works as well
+	for (auto& worker : workers)
+		worker.join();
+
+	result.WallTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	result.Score = Summarize(result.Episodes, [](const EpisodeResult& episode) { return double(episode.Stats.Score); });
+	result.TimeSurvived = Summarize(result.Episodes, [](const EpisodeResult& episode) { return double(episode.Stats.TimeSurvived); });
+	result.EnemiesKilled = Summarize(result.Episodes, [](const EpisodeResult& episode) { return double(episode.Stats.NumEnemiesKilled); });
+	result.MissedShots = Summarize(result.Episodes, [](const EpisodeResult& episode) { return double(episode.Stats.NumMissedShots); });
+	result.NavMeshQueriesPerMinute = Summarize(result.Episodes, [](const EpisodeResult& episode)
+		{
+			return episode.SimulatedTime > 0.f ? double(episode.NavMeshQueries) * 60.0 / double(episode.SimulatedTime) : 0.0;
+		});
+	for (const auto& episode : result.Episodes)
+	{
+		result.Deaths += episode.Result.AgentDied ? 1 : 0;
+		result.SimulatedTime += episode.Result.SimulatedTime;
+	}
+
+	return result;
+}
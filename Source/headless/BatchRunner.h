@@ -0,0 +1,45 @@
+#pragma once
+#include "HeadlessEpisode.h"
+
+class LevelData;
+
+struct BatchSettings
+{
+	EpisodeSettings Episode{}; // Shared by every episode, apart from the seed
+	int Episodes = 16;
+	int FirstSeed = 1; // Episode i runs with seed FirstSeed + i
+	int Threads = 0; // 0 uses every hardware thread
+};
+
+struct BatchEpisode
+{
+	int Seed;
+	EpisodeResult Result;
+};
+
+// Min/mean/max of one statistic over the batch
+struct BatchStat
+{
+	double Min = 0.0;
+	double Mean = 0.0;
+	double Max = 0.0;
+};
+
+struct BatchResult
+{
+	vector<BatchEpisode> Episodes; // In seed order
+	int Threads = 0; // Actually used
+	double WallTime = 0.0; // Of the whole batch, in seconds
+
+	BatchStat Score{};
+	BatchStat TimeSurvived{};
+	BatchStat EnemiesKilled{};
+	BatchStat MissedShots{};
+	BatchStat NavMeshQueriesPerMinute{};
+	int Deaths = 0;
+	double SimulatedTime = 0.0; // Summed over every episode
+};
+
+// Runs independent headless episodes (one world and plugin instance each) over a pool of worker threads
+// Every episode only depends on its seed, so the results are the same whatever the amount of threads
+BatchResult RunBatch(const LevelData& level, const BatchSettings& settings);
@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include "HeadlessEpisode.h"
+#include "HeadlessWorld.h"
+#include "InterfaceRecorder.h"
+#include "InterfaceReplayer.h"
+#include <chrono>
+#include <IExamPlugin.h>
+
+// Plugin entry point (see Plugin.h)
+extern "C" IPluginBase* Register();
+
+EpisodeResult RunEpisode(const LevelData& level, const EpisodeSettings& settings)
+{
+	EpisodeResult result{};
+	const auto startTime = chrono::steady_clock::now();
+
+	auto* pPlugin = static_cast<IExamPlugin*>(Register());
+	pPlugin->DllInit();
+
+	// Let the plugin fill in its debug params (it picks up the seed from them, like in the game), then apply the episode's overrides
+	GameDebugParams params{};
+	params.Seed = settings.Seed;
+	params.LevelFile = level.GetFilePath();
+	pPlugin->InitGameDebugParams(params);
+	if (settings.EnemyCount >= 0)
+		params.EnemyCount = settings.EnemyCount;
+	if (settings.GodMode)
+		params.GodMode = true;
+
+	HeadlessWorld world{ level, params };
+	InterfaceRecorder recorder{ &world }; // Only records once started
+	if (settings.RecordFile.empty() == false && recorder.Start(settings.RecordFile, params.Seed) == false)
+		std::cerr << "Couldn't record to \"" << settings.RecordFile << "\"\n";
+
+	PluginInfo info{};
+	pPlugin->Initialize(&recorder, info);
+
+	// Fixed time step loop
+	while (world.GetTimeSurvived() < settings.Duration && world.IsAgentDead() == false && world.IsShutdownRequested() == false)
+	{
+		world.BeginFrame();
+		recorder.BeginFrame(settings.TimeStep);
+		pPlugin->Update(settings.TimeStep);
+		const auto steering = pPlugin->UpdateSteering(settings.TimeStep);
+		if (settings.Render)
+			pPlugin->Render(settings.TimeStep);
+		recorder.EndFrame(steering);
+
+		world.Step(steering, settings.TimeStep);
+		++result.Frames;
+	}
+
+	result.Stats = world.World_GetStats();
+	result.AgentDied = world.IsAgentDead();
+	result.SimulatedTime = world.GetTimeSurvived();
+	result.NavMeshQueries = world.GetNavMeshQueries();
+
+	pPlugin->DllShutdown();
+	delete pPlugin;
+	recorder.Stop();
+
+	result.WallTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	return result;
+}
+
+ReplayResult ReplayEpisode(const string& recordingFile, const ReplaySettings& settings)
+{
+	ReplayResult result{};
+	const auto startTime = chrono::steady_clock::now();
+
+	InterfaceReplayer replayer{};
+	if (replayer.Open(recordingFile) == false)
+		return result;
+	result.Opened = true;
+	result.Seed = replayer.GetSeed();
+
+	auto* pPlugin = static_cast<IExamPlugin*>(Register());
+	pPlugin->DllInit();
+
+	// Seeded like it was in the recording, the rest of the params only matter to the game
+	GameDebugParams params{};
+	params.Seed = replayer.GetSeed();
+	params.LevelFile = settings.LevelFile;
+	pPlugin->InitGameDebugParams(params);
+
+	PluginInfo info{};
+	pPlugin->Initialize(&replayer, info);
+
+	// As fast as the plugin goes, with the recorded time steps
+	float deltaTime = 0.f;
+	while (result.Frames < settings.MaxFrames && replayer.IsShutdownRequested() == false && replayer.BeginFrame(deltaTime))
+	{
+		pPlugin->Update(deltaTime);
+		const auto steering = pPlugin->UpdateSteering(deltaTime);
+		if (settings.Render)
+			pPlugin->Render(deltaTime);
+
+		if (replayer.EndFrame(steering) == false && replayer.HasDiverged() == false && replayer.IsCutOff() == false)
+		{
+			result.FirstSteeringMismatch = min(result.FirstSteeringMismatch, result.Frames);
+			++result.SteeringMismatches;
+		}
+
+		result.SimulatedTime += deltaTime;
+		++result.Frames;
+	}
+
+	result.Diverged = replayer.HasDiverged();
+	result.CutOff = replayer.IsCutOff();
+	result.Stats = replayer.GetLastStats();
+
+	pPlugin->DllShutdown();
+	delete pPlugin;
+
+	result.WallTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	return result;
+}
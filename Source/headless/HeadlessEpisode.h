@@ -0,0 +1,53 @@
+#pragma once
+#include <climits>
+#include <Exam_HelperStructs.h>
+
+class LevelData;
+
+struct EpisodeSettings
+{
+	int Seed = 1234;
+	int EnemyCount = -1; // Negative keeps the plugin's own GameDebugParams value
+	float Duration = 600.f; // Simulated seconds, the episode also ends when the agent dies
+	float TimeStep = 1.f / 60.f;
+	bool GodMode = false;
+	bool Render = false; // Also call the plugin's Render() (drawing goes nowhere, but its cost is included)
+	string RecordFile{}; // Records every interface call of the plugin in there (see InterfaceRecorder), left empty nothing gets recorded
+};
+
+struct EpisodeResult
+{
+	StatisticsInfo Stats{};
+	bool AgentDied = false;
+	float SimulatedTime = 0.f;
+	double WallTime = 0.0; // In seconds
+	unsigned long long Frames = 0;
+	unsigned long long NavMeshQueries = 0;
+};
+
+// Runs one full headless episode: a fresh plugin instance driven at a fixed time step in a fresh world
+EpisodeResult RunEpisode(const LevelData& level, const EpisodeSettings& settings);
+
+struct ReplaySettings
+{
+	unsigned long long MaxFrames = ULLONG_MAX; // Stop early, to bisect up to a given frame
+	bool Render = false;
+	string LevelFile = GameDebugParams{}.LevelFile; // The plugin reads the level itself (for its nav grid), so it has to be the recorded one
+};
+
+struct ReplayResult
+{
+	bool Opened = false;
+	bool Diverged = false; // The plugin asked for something else than what was recorded
+	bool CutOff = false; // The recording ended in the middle of a frame (the game got killed, for instance)
+	unsigned long long Frames = 0;
+	unsigned long long SteeringMismatches = 0; // Frames the plugin steered differently than it did in the recording
+	unsigned long long FirstSteeringMismatch = ULLONG_MAX;
+	int Seed = 0;
+	StatisticsInfo Stats{}; // The last ones the plugin was given
+	float SimulatedTime = 0.f;
+	double WallTime = 0.0; // In seconds
+};
+
+// Feeds a fresh plugin instance from an interface recording (see InterfaceReplayer), no world gets simulated
+ReplayResult ReplayEpisode(const string& recordingFile, const ReplaySettings& settings);
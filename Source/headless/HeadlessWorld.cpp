@@ -0,0 +1,751 @@
+#include "stdafx.h"
+#include "HeadlessWorld.h"
+
+namespace
+{
+	// Agent
+	const float g_AgentWalkSpeed{ 5.f };
+	const float g_AgentRunMultiplier{ 2.f };
+	const float g_AgentMaxAngularSpeed{ float(E_PI) };
+	const float g_AgentSize{ 1.f };
+	const float g_AgentGrabRange{ 2.5f };
+	const float g_AgentFOVAngle{ Elite::ToRadians(90.f) };
+	const float g_AgentFOVRange{ 20.f };
+	const float g_StaminaDrainPerSecond{ 2.f };
+	const float g_StaminaRegenPerSecond{ 1.f };
+	const float g_EnergyDrainPerSecond{ 0.07f };
+	const float g_StarvingDamagePerSecond{ 0.3f };
+
+	// Zombies
+	const float g_ZombieDetectionRange{ 15.f };
+	const float g_ZombieBiteInterval{ 1.f };
+	const float g_ZombieSpawnDistance{ 30.f };
+
+	// Items
+	const float g_ItemRespawnInterval{ 5.f };
+	const float g_PistolRange{ 50.f };
+
+	// Purge zones
+	const float g_PurgeZoneMinInterval{ 45.f };
+	const float g_PurgeZoneMaxInterval{ 75.f };
+	const float g_PurgeZoneTriggerTime{ 6.f };
+
+	// Score
+	const int g_ScorePerItem{ 2 };
+	const int g_ScorePerKill{ 10 };
+	const float g_KillCountdown{ 60.f };
+
+	Elite::Vector2 ClosestPointOnBox(const Elite::Vector2& point, const Elite::Vector2& min, const Elite::Vector2& max)
+	{
+		return Elite::Vector2{ Elite::Clamp(point.x, min.x, max.x), Elite::Clamp(point.y, min.y, max.y) };
+	}
+}
+
+HeadlessWorld::HeadlessWorld(const LevelData& level, const GameDebugParams& params)
+	: m_Level(level)
+	, m_RandomEngine(unsigned(params.Seed))
+	, m_Params(params)
+	, m_WorldInfo{ Elite::Vector2{}, level.GetDimensions() }
+	, m_Stats{}
+	, m_Agent{}
+	, m_ShutdownRequested(false)
+	, m_NavMeshQueries(0)
+	, m_NextHash(1)
+	, m_ItemRespawnTimer(0.f)
+	, m_PurgeZoneTimer(0.f)
+{
+	m_Stats.KillCountdown = g_KillCountdown;
+
+	// Agent
+	m_Agent.Stamina = m_MaxStamina;
+	m_Agent.Health = m_MaxHealth;
+	m_Agent.Energy = m_MaxEnergy;
+	m_Agent.FOV_Angle = g_AgentFOVAngle;
+	m_Agent.FOV_Range = g_AgentFOVRange;
+	m_Agent.MaxLinearSpeed = g_AgentWalkSpeed;
+	m_Agent.MaxAngularSpeed = g_AgentMaxAngularSpeed;
+	m_Agent.GrabRange = g_AgentGrabRange;
+	m_Agent.AgentSize = g_AgentSize;
+
+	// Houses
+	for (const auto& house : level.GetHouses())
+		m_Houses.push_back(house.Info);
+
+	m_Inventory.resize(m_InventoryCapacity, InventorySlot{ false, ItemInfo{} });
+
+	// Initial population
+	if (m_Params.SpawnEnemies)
+	{
+		for (int i = 0; i < m_Params.EnemyCount; ++i)
+			SpawnZombie();
+	}
+
+	for (int i = 0; i < m_Params.ItemCount; ++i)
+		SpawnItem();
+
+	if (m_Params.SpawnDebugPistol)
+	{
+		WorldItem pistol{ ItemInfo{ eItemType::PISTOL, m_Agent.Position + Elite::Vector2{ 0.f, 1.f }, m_NextHash++ }, 1000 };
+		m_Items.push_back(pistol);
+	}
+
+	m_PurgeZoneTimer = RandomFloat(g_PurgeZoneMinInterval, g_PurgeZoneMaxInterval);
+}
+
+void HeadlessWorld::BeginFrame()
+{
+	m_Agent.IsInHouse = IsInsideHouse(m_Agent.Position);
+
+	// Houses (visible when the agent's inside or when its center or any of its corners is in the cone)
+	m_HousesInFOV.clear();
+	for (const auto& house : m_Houses)
+	{
+		const auto halfSize = house.Size / 2.f;
+		const bool agentInside = abs(m_Agent.Position.x - house.Center.x) <= halfSize.x && abs(m_Agent.Position.y - house.Center.y) <= halfSize.y;
+		if (agentInside || IsInFOV(house.Center, 0.f) ||
+			IsInFOV(house.Center + halfSize, 0.f) || IsInFOV(house.Center - halfSize, 0.f) ||
+			IsInFOV(house.Center + Elite::Vector2{ halfSize.x, -halfSize.y }, 0.f) || IsInFOV(house.Center + Elite::Vector2{ -halfSize.x, halfSize.y }, 0.f))
+		{
+			m_HousesInFOV.push_back(house);
+		}
+	}
+
+	// Entities
+	m_EntitiesInFOV.clear();
+	for (const auto& item : m_Items)
+	{
+		if (IsInFOV(item.Info.Location, 0.f))
+			m_EntitiesInFOV.push_back(EntityInfo{ eEntityType::ITEM, item.Info.Location, item.Info.ItemHash });
+	}
+
+	for (const auto& zombie : m_Zombies)
+	{
+		if (IsInFOV(zombie.Info.Location, zombie.Info.Size))
+			m_EntitiesInFOV.push_back(EntityInfo{ eEntityType::ENEMY, zombie.Info.Location, zombie.Info.EnemyHash });
+	}
+
+	for (const auto& zone : m_PurgeZones)
+	{
+		const bool agentInside = zone.Info.Center.Distance(m_Agent.Position) <= zone.Info.Radius;
+		if (agentInside || IsInFOV(zone.Info.Center, zone.Info.Radius))
+			m_EntitiesInFOV.push_back(EntityInfo{ eEntityType::PURGEZONE, zone.Info.Center, zone.Info.ZoneHash });
+	}
+}
+
+void HeadlessWorld::Step(const SteeringPlugin_Output& steering, float deltaTime)
+{
+	if (m_Agent.Death)
+		return;
+
+	m_Stats.TimeSurvived += deltaTime;
+	m_Stats.Difficulty = m_Stats.TimeSurvived / 300.f;
+	m_Stats.KillCountdown = max(0.f, m_Stats.KillCountdown - deltaTime);
+
+	UpdateAgent(steering, deltaTime);
+	UpdateZombies(deltaTime);
+	UpdatePurgeZones(deltaTime);
+	UpdateSpawning(deltaTime);
+}
+
+
+//SIMULATION
+void HeadlessWorld::UpdateAgent(const SteeringPlugin_Output& steering, float deltaTime)
+{
+	// Running (only possible while there's stamina left)
+	const bool canRun = steering.RunMode && (m_Agent.Stamina > 0.f || m_Params.InfiniteStamina);
+	auto maxSpeed = g_AgentWalkSpeed * (canRun ? g_AgentRunMultiplier : 1.f);
+
+	auto velocity = steering.LinearVelocity;
+	if (velocity.Magnitude() > maxSpeed)
+		velocity = velocity.GetNormalized() * maxSpeed;
+
+	m_Agent.RunMode = canRun;
+	m_Agent.LinearVelocity = velocity;
+	m_Agent.CurrentLinearSpeed = velocity.Magnitude();
+	m_Agent.Position += velocity * deltaTime;
+	ResolveWallCollisions(m_Agent.Position, m_Agent.AgentSize);
+
+	// Orientation
+	if (steering.AutoOrient)
+	{
+		if (m_Agent.CurrentLinearSpeed > 0.01f)
+			m_Agent.Orientation = Elite::GetOrientationFromVelocity(velocity);
+		m_Agent.AngularVelocity = 0.f;
+	}
+	else
+	{
+		m_Agent.AngularVelocity = Elite::Clamp(steering.AngularVelocity, -m_Agent.MaxAngularSpeed, m_Agent.MaxAngularSpeed);
+		m_Agent.Orientation += m_Agent.AngularVelocity * deltaTime;
+	}
+
+	// Stamina
+	if (m_Params.InfiniteStamina == false)
+	{
+		if (canRun && m_Agent.CurrentLinearSpeed > 0.f)
+			m_Agent.Stamina = max(0.f, m_Agent.Stamina - g_StaminaDrainPerSecond * deltaTime);
+		else
+			m_Agent.Stamina = min(m_MaxStamina, m_Agent.Stamina + g_StaminaRegenPerSecond * deltaTime);
+	}
+
+	// Energy (starving hurts)
+	if (m_Params.IgnoreEnergy == false)
+	{
+		m_Agent.Energy = max(0.f, m_Agent.Energy - g_EnergyDrainPerSecond * deltaTime);
+		if (m_Agent.Energy <= 0.f)
+			DamageAgent(g_StarvingDamagePerSecond * deltaTime);
+	}
+
+	// Bites
+	m_Agent.WasBitten = m_Agent.Bitten;
+	m_Agent.Bitten = false;
+}
+
+void HeadlessWorld::UpdateZombies(float deltaTime)
+{
+	for (auto& zombie : m_Zombies)
+	{
+		zombie.BiteCooldown = max(0.f, zombie.BiteCooldown - deltaTime);
+
+		// Chase the agent once close enough, wander otherwise
+		const auto toAgent = m_Agent.Position - zombie.Info.Location;
+		const auto distanceToAgent = toAgent.Magnitude();
+		Elite::Vector2 target{};
+		if (distanceToAgent < g_ZombieDetectionRange)
+		{
+			target = m_Agent.Position;
+		}
+		else
+		{
+			if (zombie.WanderTarget.Distance(zombie.Info.Location) < 2.f)
+				zombie.WanderTarget = RandomPointInWorld();
+			target = zombie.WanderTarget;
+		}
+
+		const auto speed = distanceToAgent < g_ZombieDetectionRange ? zombie.Speed : zombie.Speed * 0.5f;
+		zombie.Info.LinearVelocity = (target - zombie.Info.Location).GetNormalized() * speed;
+		zombie.Info.Location += zombie.Info.LinearVelocity * deltaTime;
+		ResolveWallCollisions(zombie.Info.Location, zombie.Info.Size);
+
+		// Bite
+		if (distanceToAgent <= zombie.Info.Size + m_Agent.AgentSize && zombie.BiteCooldown <= 0.f)
+		{
+			zombie.BiteCooldown = g_ZombieBiteInterval;
+			m_Agent.Bitten = true;
+			DamageAgent(zombie.Damage);
+		}
+	}
+}
+
+void HeadlessWorld::UpdatePurgeZones(float deltaTime)
+{
+	for (auto i = int(m_PurgeZones.size()) - 1; i >= 0; i--)
+	{
+		auto& zone = m_PurgeZones[i];
+		zone.TimeToTrigger -= deltaTime;
+		if (zone.TimeToTrigger > 0.f)
+			continue;
+
+		// Once triggered, everything inside dies
+		if (zone.Info.Center.Distance(m_Agent.Position) <= zone.Info.Radius)
+			DamageAgent(m_MaxHealth);
+
+		for (auto zombieIdx = int(m_Zombies.size()) - 1; zombieIdx >= 0; zombieIdx--)
+		{
+			if (zone.Info.Center.Distance(m_Zombies[zombieIdx].Info.Location) <= zone.Info.Radius)
+				KillZombie(size_t(zombieIdx));
+		}
+
+		m_PurgeZones.erase(m_PurgeZones.begin() + i);
+	}
+}
+
+void HeadlessWorld::UpdateSpawning(float deltaTime)
+{
+	// Keep the amount of enemies and items constant
+	if (m_Params.SpawnEnemies)
+	{
+		while (int(m_Zombies.size()) < m_Params.EnemyCount)
+			SpawnZombie();
+	}
+
+	m_ItemRespawnTimer += deltaTime;
+	if (m_ItemRespawnTimer >= g_ItemRespawnInterval)
+	{
+		m_ItemRespawnTimer -= g_ItemRespawnInterval;
+		if (int(m_Items.size()) < m_Params.ItemCount)
+			SpawnItem();
+	}
+
+	m_PurgeZoneTimer -= deltaTime;
+	if (m_PurgeZoneTimer <= 0.f)
+	{
+		m_PurgeZoneTimer = RandomFloat(g_PurgeZoneMinInterval, g_PurgeZoneMaxInterval);
+		SpawnPurgeZone();
+	}
+}
+
+void HeadlessWorld::SpawnZombie()
+{
+	Zombie zombie{};
+	zombie.Info.EnemyHash = m_NextHash++;
+	zombie.Info.Location = RandomPointOutsideHouses(g_ZombieSpawnDistance);
+	zombie.WanderTarget = RandomPointInWorld();
+
+	switch (RandomInt(0, 9))
+	{
+	case 0: case 1:
+		zombie.Info.Type = eEnemyType::ZOMBIE_RUNNER;
+		zombie.Info.Size = 0.8f;
+		zombie.Info.Health = 1;
+		zombie.Speed = 7.f;
+		zombie.Damage = 0.5f;
+		break;
+	case 2:
+		zombie.Info.Type = eEnemyType::ZOMBIE_HEAVY;
+		zombie.Info.Size = 1.6f;
+		zombie.Info.Health = 4;
+		zombie.Speed = 2.5f;
+		zombie.Damage = 2.f;
+		break;
+	default:
+		zombie.Info.Type = eEnemyType::ZOMBIE_NORMAL;
+		zombie.Info.Size = 1.f;
+		zombie.Info.Health = 2;
+		zombie.Speed = 4.f;
+		zombie.Damage = 1.f;
+		break;
+	}
+
+	m_Zombies.push_back(zombie);
+}
+
+void HeadlessWorld::SpawnItem()
+{
+	if (m_Houses.empty())
+		return;
+
+	// Items only spawn inside houses (away from the walls)
+	const auto& house = m_Houses[RandomInt(0, int(m_Houses.size()) - 1)];
+	const auto halfSize = house.Size / 2.f - Elite::Vector2{ 3.f, 3.f };
+	const Elite::Vector2 location{ house.Center.x + RandomFloat(-halfSize.x, halfSize.x), house.Center.y + RandomFloat(-halfSize.y, halfSize.y) };
+
+	WorldItem item{};
+	item.Info.Location = location;
+	item.Info.ItemHash = m_NextHash++;
+
+	const auto roll = RandomInt(0, 99);
+	if (roll < 25)
+	{
+		item.Info.Type = eItemType::PISTOL;
+		item.Value = RandomInt(5, 20);
+	}
+	else if (roll < 50)
+	{
+		item.Info.Type = eItemType::MEDKIT;
+		item.Value = RandomInt(0, 5);
+	}
+	else if (roll < 85)
+	{
+		item.Info.Type = eItemType::FOOD;
+		item.Value = RandomInt(0, 5);
+	}
+	else
+	{
+		item.Info.Type = eItemType::GARBAGE;
+		item.Value = 0;
+	}
+
+	m_Items.push_back(item);
+}
+
+void HeadlessWorld::SpawnPurgeZone()
+{
+	PurgeZone zone{};
+	zone.Info.Center = RandomPointInWorld();
+	zone.Info.Radius = RandomFloat(10.f, 20.f);
+	zone.Info.ZoneHash = m_NextHash++;
+	zone.TimeToTrigger = g_PurgeZoneTriggerTime;
+	m_PurgeZones.push_back(zone);
+}
+
+void HeadlessWorld::DamageAgent(float damage)
+{
+	if (m_Params.GodMode)
+		return;
+
+	m_Agent.Health = max(0.f, m_Agent.Health - damage);
+	if (m_Agent.Health <= 0.f)
+		m_Agent.Death = true;
+}
+
+void HeadlessWorld::KillZombie(size_t zombieIdx)
+{
+	m_Zombies.erase(m_Zombies.begin() + zombieIdx);
+}
+
+void HeadlessWorld::Shoot()
+{
+	// Hitscan along the agent's facing direction, hitting the first zombie on the way
+	const auto direction = Elite::OrientationToVector(m_Agent.Orientation);
+	int hitIdx = -1;
+	float closestHit = g_PistolRange;
+	for (size_t i = 0; i < m_Zombies.size(); ++i)
+	{
+		const auto toZombie = m_Zombies[i].Info.Location - m_Agent.Position;
+		const auto projection = toZombie.Dot(direction);
+		if (projection < 0.f || projection > closestHit)
+			continue;
+
+		const auto closestApproach = (toZombie - direction * projection).Magnitude();
+		if (closestApproach <= m_Zombies[i].Info.Size)
+		{
+			closestHit = projection;
+			hitIdx = int(i);
+		}
+	}
+
+	if (hitIdx < 0)
+	{
+		++m_Stats.NumMissedShots;
+		return;
+	}
+
+	++m_Stats.NumEnemiesHit;
+	auto& zombie = m_Zombies[hitIdx];
+	if (--zombie.Info.Health <= 0)
+	{
+		++m_Stats.NumEnemiesKilled;
+		m_Stats.Score += g_ScorePerKill;
+		m_Stats.KillCountdown = g_KillCountdown;
+		KillZombie(size_t(hitIdx));
+	}
+}
+
+
+//HELPERS
+bool HeadlessWorld::IsInFOV(const Elite::Vector2& position, float radius) const
+{
+	const auto toPosition = position - m_Agent.Position;
+	const auto distance = toPosition.Magnitude();
+	if (distance - radius > m_Agent.FOV_Range)
+		return false;
+
+	if (distance <= radius)
+		return true;
+
+	const auto forward = Elite::OrientationToVector(m_Agent.Orientation);
+	const auto cosAngle = forward.Dot(toPosition) / distance;
+	const auto angle = acosf(Elite::Clamp(cosAngle, -1.f, 1.f)) - asinf(Elite::Clamp(radius / distance, 0.f, 1.f));
+	return angle <= m_Agent.FOV_Angle / 2.f;
+}
+
+bool HeadlessWorld::IsInsideHouse(const Elite::Vector2& position) const
+{
+	for (const auto& house : m_Houses)
+	{
+		if (abs(position.x - house.Center.x) <= house.Size.x / 2.f && abs(position.y - house.Center.y) <= house.Size.y / 2.f)
+			return true;
+	}
+	return false;
+}
+
+void HeadlessWorld::ResolveWallCollisions(Elite::Vector2& position, float radius) const
+{
+	// Every wall polygon in the level is an axis-aligned quad, so its bounding box is the wall itself
+	int minX, minY, maxX, maxY;
+	m_Level.GetCell(position - Elite::Vector2{ radius, radius }, minX, minY);
+	m_Level.GetCell(position + Elite::Vector2{ radius, radius }, maxX, maxY);
+	const auto polygons = m_Level.GetPolygons();
+	for (int cellY = minY; cellY <= maxY; ++cellY)
+	{
+		for (int cellX = minX; cellX <= maxX; ++cellX)
+		{
+			for (const auto wallIdx : m_Level.GetWallsInCell(cellX, cellY))
+			{
+				const auto& wall = polygons[wallIdx];
+				const auto closestPoint = ClosestPointOnBox(position, wall.Min, wall.Max);
+				auto offset = position - closestPoint;
+				const auto distance = offset.Magnitude();
+				if (distance >= radius)
+					continue;
+
+				if (distance > 0.f)
+				{
+					position = closestPoint + offset * (radius / distance);
+				}
+				else
+				{
+					// The center ended up inside the wall, push it out through the closest side
+					const float pushes[4]{ position.x - wall.Min.x, wall.Max.x - position.x, position.y - wall.Min.y, wall.Max.y - position.y };
+					const auto side = int(min_element(begin(pushes), end(pushes)) - begin(pushes));
+					switch (side)
+					{
+					case 0: position.x = wall.Min.x - radius; break;
+					case 1: position.x = wall.Max.x + radius; break;
+					case 2: position.y = wall.Min.y - radius; break;
+					default: position.y = wall.Max.y + radius; break;
+					}
+				}
+			}
+		}
+	}
+
+	// And keep everything inside the world
+	const auto halfDimensions = m_WorldInfo.Dimensions / 2.f;
+	position.x = Elite::Clamp(position.x, m_WorldInfo.Center.x - halfDimensions.x, m_WorldInfo.Center.x + halfDimensions.x);
+	position.y = Elite::Clamp(position.y, m_WorldInfo.Center.y - halfDimensions.y, m_WorldInfo.Center.y + halfDimensions.y);
+}
+
+Elite::Vector2 HeadlessWorld::RandomPointInWorld()
+{
+	const auto halfDimensions = m_WorldInfo.Dimensions / 2.f;
+	return Elite::Vector2{ m_WorldInfo.Center.x + RandomFloat(-halfDimensions.x, halfDimensions.x),
+		m_WorldInfo.Center.y + RandomFloat(-halfDimensions.y, halfDimensions.y) };
+}
+
+Elite::Vector2 HeadlessWorld::RandomPointOutsideHouses(float minDistanceToAgent)
+{
+	Elite::Vector2 point{};
+	for (int attempt = 0; attempt < 32; ++attempt)
+	{
+		point = RandomPointInWorld();
+		if (IsInsideHouse(point) == false && point.Distance(m_Agent.Position) >= minDistanceToAgent)
+			break;
+	}
+	return point;
+}
+
+int HeadlessWorld::RandomInt(int min, int max)
+{
+	return uniform_int_distribution<int>(min, max)(m_RandomEngine);
+}
+
+float HeadlessWorld::RandomFloat(float min, float max)
+{
+	return uniform_real_distribution<float>(min, max)(m_RandomEngine);
+}
+
+
+//WORLD & ENTITIES
+WorldInfo HeadlessWorld::World_GetInfo() const
+{
+	return m_WorldInfo;
+}
+
+StatisticsInfo HeadlessWorld::World_GetStats() const
+{
+	return m_Stats;
+}
+
+bool HeadlessWorld::Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const
+{
+	if (index >= m_HousesInFOV.size())
+		return false;
+
+	houseInfo = m_HousesInFOV[index];
+	return true;
+}
+
+bool HeadlessWorld::Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const
+{
+	if (index >= m_EntitiesInFOV.size())
+		return false;
+
+	enemyInfo = m_EntitiesInFOV[index];
+	return true;
+}
+
+AgentInfo HeadlessWorld::Agent_GetInfo() const
+{
+	return m_Agent;
+}
+
+bool HeadlessWorld::Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy)
+{
+	for (const auto& zombie : m_Zombies)
+	{
+		if (zombie.Info.EnemyHash == entity.EntityHash)
+		{
+			enemy = zombie.Info;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//NAVMESH
+Elite::Vector2 HeadlessWorld::NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const
+{
+	// There's no navmesh in the headless world, the agent slides along the walls instead
+	// (the queries are still counted, in the game every one of them is a path search)
+	++m_NavMeshQueries;
+	return goal;
+}
+
+
+//INVENTORY
+bool HeadlessWorld::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+	if (slotId >= m_Inventory.size() || m_Inventory[slotId].Occupied)
+		return false;
+
+	// Only items that were grabbed can be stored
+	if (m_HeldItemValues.find(item.ItemHash) == m_HeldItemValues.end())
+		return false;
+
+	m_Inventory[slotId] = InventorySlot{ true, item };
+	++m_Stats.NumItemsPickUp;
+	m_Stats.Score += g_ScorePerItem;
+	return true;
+}
+
+bool HeadlessWorld::Inventory_UseItem(UINT slotId)
+{
+	if (slotId >= m_Inventory.size() || m_Inventory[slotId].Occupied == false)
+		return false;
+
+	auto& item = m_Inventory[slotId].Item;
+	auto& value = m_HeldItemValues[item.ItemHash];
+	if (value <= 0)
+		return false;
+
+	switch (item.Type)
+	{
+	case eItemType::PISTOL:
+		--value;
+		Shoot();
+		return true;
+
+	case eItemType::MEDKIT:
+		m_Agent.Health = min(m_MaxHealth, m_Agent.Health + float(value));
+		value = 0;
+		return true;
+
+	case eItemType::FOOD:
+		m_Agent.Energy = min(m_MaxEnergy, m_Agent.Energy + float(value));
+		value = 0;
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+bool HeadlessWorld::Inventory_RemoveItem(UINT slotId)
+{
+	if (slotId >= m_Inventory.size() || m_Inventory[slotId].Occupied == false)
+		return false;
+
+	m_HeldItemValues.erase(m_Inventory[slotId].Item.ItemHash);
+	m_Inventory[slotId] = InventorySlot{ false, ItemInfo{} };
+	return true;
+}
+
+bool HeadlessWorld::Inventory_GetItem(UINT slotId, ItemInfo& item)
+{
+	if (slotId >= m_Inventory.size() || m_Inventory[slotId].Occupied == false)
+		return false;
+
+	item = m_Inventory[slotId].Item;
+	return true;
+}
+
+UINT HeadlessWorld::Inventory_GetCapacity() const
+{
+	return UINT(m_InventoryCapacity);
+}
+
+bool HeadlessWorld::Item_GetInfo(EntityInfo entity, ItemInfo& item)
+{
+	for (const auto& worldItem : m_Items)
+	{
+		if (worldItem.Info.ItemHash == entity.EntityHash)
+		{
+			item = worldItem.Info;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HeadlessWorld::Item_Grab(EntityInfo entity, ItemInfo& item)
+{
+	// Find the requested item (or the closest one, when AutoGrabClosestItem is on)
+	int itemIdx = -1;
+	float closestDistance = FLT_MAX;
+	for (size_t i = 0; i < m_Items.size(); ++i)
+	{
+		const auto distance = m_Items[i].Info.Location.Distance(m_Agent.Position);
+		if (m_Params.AutoGrabClosestItem)
+		{
+			if (distance < closestDistance)
+			{
+				closestDistance = distance;
+				itemIdx = int(i);
+			}
+		}
+		else if (m_Items[i].Info.ItemHash == entity.EntityHash)
+		{
+			closestDistance = distance;
+			itemIdx = int(i);
+			break;
+		}
+	}
+
+	if (itemIdx < 0 || closestDistance > m_Agent.GrabRange)
+		return false;
+
+	item = m_Items[itemIdx].Info;
+	m_HeldItemValues[item.ItemHash] = m_Items[itemIdx].Value;
+	m_Items.erase(m_Items.begin() + itemIdx);
+	return true;
+}
+
+bool HeadlessWorld::Item_Destroy(EntityInfo entity)
+{
+	// Items can be destroyed while still lying in the world, or after having been grabbed
+	m_HeldItemValues.erase(entity.EntityHash);
+	for (size_t i = 0; i < m_Items.size(); ++i)
+	{
+		if (m_Items[i].Info.ItemHash == entity.EntityHash)
+		{
+			m_Items.erase(m_Items.begin() + i);
+			return true;
+		}
+	}
+	return false;
+}
+
+int HeadlessWorld::Weapon_GetAmmo(ItemInfo& item)
+{
+	const auto it = m_HeldItemValues.find(item.ItemHash);
+	return item.Type == eItemType::PISTOL && it != m_HeldItemValues.end() ? it->second : 0;
+}
+
+int HeadlessWorld::Medkit_GetHealth(ItemInfo& item)
+{
+	const auto it = m_HeldItemValues.find(item.ItemHash);
+	return item.Type == eItemType::MEDKIT && it != m_HeldItemValues.end() ? it->second : 0;
+}
+
+int HeadlessWorld::Food_GetEnergy(ItemInfo& item)
+{
+	const auto it = m_HeldItemValues.find(item.ItemHash);
+	return item.Type == eItemType::FOOD && it != m_HeldItemValues.end() ? it->second : 0;
+}
+
+
+//PURGEZONE
+bool HeadlessWorld::PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone)
+{
+	for (const auto& purgeZone : m_PurgeZones)
+	{
+		if (purgeZone.Info.ZoneHash == entity.EntityHash)
+		{
+			zone = purgeZone.Info;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <unordered_map>
+#include <IExamInterface.h>
+#include "LevelData.h"
+
+// In-process stand-in for the AI Framework, implementing the exam interface without any window or renderer
+// It simulates the agent, the zombies, the items, the houses and the purge zones closely enough to drive the plugin,
+// one fixed time step at a time (BeginFrame() -> plugin's UpdateSteering() -> Step())
+class HeadlessWorld final : public IExamInterface
+{
+public:
+	HeadlessWorld(const LevelData& level, const GameDebugParams& params); // The level has to outlive the world
+	~HeadlessWorld() = default;
+
+	void BeginFrame(); // Rebuilds what the agent can see, must be called before the plugin updates
+	void Step(const SteeringPlugin_Output& steering, float deltaTime);
+
+	bool IsAgentDead() const { return m_Agent.Death; }
+	float GetTimeSurvived() const { return m_Stats.TimeSurvived; }
+	unsigned long long GetNavMeshQueries() const { return m_NavMeshQueries; } // NavMesh_GetClosestPathPoint() calls so far
+
+	//WORLD & ENTITIES
+	WorldInfo World_GetInfo() const override;
+	StatisticsInfo World_GetStats() const override;
+	bool Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const override;
+	bool Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const override;
+	AgentInfo Agent_GetInfo() const override;
+	bool Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy) override;
+
+	//NAVMESH
+	Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override;
+
+	//INVENTORY
+	bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+	bool Inventory_UseItem(UINT slotId) override;
+	bool Inventory_RemoveItem(UINT slotId) override;
+	bool Inventory_GetItem(UINT slotId, ItemInfo& item) override;
+	UINT Inventory_GetCapacity() const override;
+
+	bool Item_GetInfo(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Grab(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Destroy(EntityInfo entity) override;
+
+	int Weapon_GetAmmo(ItemInfo& item) override;
+	int Medkit_GetHealth(ItemInfo& item) override;
+	int Food_GetEnergy(ItemInfo& item) override;
+
+	//PURGEZONE
+	bool PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone) override;
+
+	//DEBUG
+	Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override { return screenPos; }
+	Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override { return worldPos; }
+
+	//INPUT (there's no input without a window)
+	bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override { return false; }
+	bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override { return true; }
+	bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override { return false; }
+	bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override { return true; }
+	Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button = Elite::InputMouseButton(0)) const override { return Elite::MouseData{}; }
+
+	//EVENT
+	void RequestShutdown() const override { m_ShutdownRequested = true; }
+	bool IsShutdownRequested() const { return m_ShutdownRequested; }
+
+	//RENDERER (nothing gets drawn)
+	void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override {}
+	void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate = false) override {}
+	void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override {}
+	void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override {}
+	void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override {}
+	void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth = 0.9f) override {}
+	void Draw_Transform(const b2Transform& xf, float depth) override {}
+	void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override {}
+	float NextDepthSlice() override { return 0.f; }
+
+private:
+	struct Zombie
+	{
+		EnemyInfo Info;
+		float Speed;
+		float Damage;
+		float BiteCooldown;
+		Elite::Vector2 WanderTarget;
+	};
+
+	struct WorldItem
+	{
+		ItemInfo Info;
+		int Value; // Ammo, health or energy (depending on the type)
+	};
+
+	struct PurgeZone
+	{
+		PurgeZoneInfo Info;
+		float TimeToTrigger;
+	};
+
+	struct InventorySlot
+	{
+		bool Occupied;
+		ItemInfo Item;
+	};
+
+	void UpdateAgent(const SteeringPlugin_Output& steering, float deltaTime);
+	void UpdateZombies(float deltaTime);
+	void UpdatePurgeZones(float deltaTime);
+	void UpdateSpawning(float deltaTime);
+
+	void SpawnZombie();
+	void SpawnItem();
+	void SpawnPurgeZone();
+	void DamageAgent(float damage);
+	void KillZombie(size_t zombieIdx);
+	void Shoot();
+
+	bool IsInFOV(const Elite::Vector2& position, float radius) const;
+	bool IsInsideHouse(const Elite::Vector2& position) const;
+	void ResolveWallCollisions(Elite::Vector2& position, float radius) const;
+	Elite::Vector2 RandomPointInWorld();
+	Elite::Vector2 RandomPointOutsideHouses(float minDistanceToAgent);
+	int RandomInt(int min, int max); // Inclusive
+	float RandomFloat(float min, float max);
+
+	const int m_InventoryCapacity{ 5 };
+	const float m_MaxHealth{ 10.f };
+	const float m_MaxEnergy{ 10.f };
+	const float m_MaxStamina{ 10.f };
+
+	const LevelData& m_Level;
+	mt19937 m_RandomEngine;
+	GameDebugParams m_Params;
+	WorldInfo m_WorldInfo;
+	StatisticsInfo m_Stats;
+	AgentInfo m_Agent;
+	mutable bool m_ShutdownRequested;
+	mutable unsigned long long m_NavMeshQueries;
+
+	vector<HouseInfo> m_Houses;
+	vector<Zombie> m_Zombies;
+	vector<WorldItem> m_Items;
+	vector<PurgeZone> m_PurgeZones;
+	vector<InventorySlot> m_Inventory;
+	unordered_map<int, int> m_HeldItemValues; // Values of the grabbed items (by ItemHash), since ItemInfo doesn't carry them
+	int m_NextHash;
+
+	float m_ItemRespawnTimer;
+	float m_PurgeZoneTimer;
+
+	// Rebuilt in BeginFrame()
+	vector<HouseInfo> m_HousesInFOV;
+	vector<EntityInfo> m_EntitiesInFOV;
+};
@@ -0,0 +1,193 @@
+#include "stdafx.h"
+#include "InterfaceReplayer.h"
+#include <cstring>
+
+InterfaceReplayer::InterfaceReplayer()
+	: m_Reader()
+	, m_Header()
+	, m_LastStats()
+	, m_ShutdownRequested(false)
+{
+}
+
+bool InterfaceReplayer::Open(const string& filePath)
+{
+	m_LastStats = StatisticsInfo{};
+	m_ShutdownRequested = false;
+	return m_Reader.Open(filePath, m_Header);
+}
+
+bool InterfaceReplayer::BeginFrame(float& deltaTime)
+{
+	if (m_Reader.BeginRecord(eRecordedCall::Frame) == false)
+		return false;
+
+	m_Reader.Value(deltaTime);
+	return true;
+}
+
+bool InterfaceReplayer::EndFrame(const SteeringPlugin_Output& steering)
+{
+	const auto recordedSteering = Replay<SteeringPlugin_Output>(eRecordedCall::Steering);
+	if (m_Reader.HasDiverged() || m_Reader.IsCutOff())
+		return false;
+
+	// Bit for bit, the plugin got the exact same inputs
+	return memcmp(&recordedSteering.LinearVelocity, &steering.LinearVelocity, sizeof(steering.LinearVelocity)) == 0
+		&& memcmp(&recordedSteering.AngularVelocity, &steering.AngularVelocity, sizeof(steering.AngularVelocity)) == 0
+		&& recordedSteering.AutoOrient == steering.AutoOrient
+		&& recordedSteering.RunMode == steering.RunMode;
+}
+
+
+//WORLD & ENTITIES
+WorldInfo InterfaceReplayer::World_GetInfo() const
+{
+	return Replay<WorldInfo>(eRecordedCall::World_GetInfo);
+}
+
+StatisticsInfo InterfaceReplayer::World_GetStats() const
+{
+	const auto stats = Replay<StatisticsInfo>(eRecordedCall::World_GetStats);
+	if (m_Reader.HasDiverged() == false && m_Reader.IsCutOff() == false)
+		m_LastStats = stats;
+	return stats;
+}
+
+bool InterfaceReplayer::Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const
+{
+	return ReplayIfFound(eRecordedCall::Fov_GetHouseByIndex, index, houseInfo);
+}
+
+bool InterfaceReplayer::Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const
+{
+	return ReplayIfFound(eRecordedCall::Fov_GetEntityByIndex, index, enemyInfo);
+}
+
+AgentInfo InterfaceReplayer::Agent_GetInfo() const
+{
+	return Replay<AgentInfo>(eRecordedCall::Agent_GetInfo);
+}
+
+bool InterfaceReplayer::Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy)
+{
+	return ReplayIfFound(eRecordedCall::Enemy_GetInfo, 0, enemy);
+}
+
+
+//NAVMESH
+Elite::Vector2 InterfaceReplayer::NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const
+{
+	return Replay<Elite::Vector2>(eRecordedCall::NavMesh_GetClosestPathPoint);
+}
+
+
+//INVENTORY
+bool InterfaceReplayer::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+	return Replay<bool>(eRecordedCall::Inventory_AddItem, slotId);
+}
+
+bool InterfaceReplayer::Inventory_UseItem(UINT slotId)
+{
+	return Replay<bool>(eRecordedCall::Inventory_UseItem, slotId);
+}
+
+bool InterfaceReplayer::Inventory_RemoveItem(UINT slotId)
+{
+	return Replay<bool>(eRecordedCall::Inventory_RemoveItem, slotId);
+}
+
+bool InterfaceReplayer::Inventory_GetItem(UINT slotId, ItemInfo& item)
+{
+	return ReplayIfFound(eRecordedCall::Inventory_GetItem, slotId, item);
+}
+
+UINT InterfaceReplayer::Inventory_GetCapacity() const
+{
+	return UINT(Replay<int>(eRecordedCall::Inventory_GetCapacity));
+}
+
+bool InterfaceReplayer::Item_GetInfo(EntityInfo entity, ItemInfo& item)
+{
+	return ReplayIfFound(eRecordedCall::Item_GetInfo, 0, item);
+}
+
+bool InterfaceReplayer::Item_Grab(EntityInfo entity, ItemInfo& item)
+{
+	return ReplayIfFound(eRecordedCall::Item_Grab, 0, item);
+}
+
+bool InterfaceReplayer::Item_Destroy(EntityInfo entity)
+{
+	return Replay<bool>(eRecordedCall::Item_Destroy);
+}
+
+int InterfaceReplayer::Weapon_GetAmmo(ItemInfo& item)
+{
+	return Replay<int>(eRecordedCall::Weapon_GetAmmo);
+}
+
+int InterfaceReplayer::Medkit_GetHealth(ItemInfo& item)
+{
+	return Replay<int>(eRecordedCall::Medkit_GetHealth);
+}
+
+int InterfaceReplayer::Food_GetEnergy(ItemInfo& item)
+{
+	return Replay<int>(eRecordedCall::Food_GetEnergy);
+}
+
+
+//PURGEZONE
+bool InterfaceReplayer::PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone)
+{
+	return ReplayIfFound(eRecordedCall::PurgeZone_GetInfo, 0, zone);
+}
+
+
+//DEBUG
+Elite::Vector2 InterfaceReplayer::Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const
+{
+	return Replay<Elite::Vector2>(eRecordedCall::Debug_ConvertScreenToWorld);
+}
+
+Elite::Vector2 InterfaceReplayer::Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const
+{
+	return Replay<Elite::Vector2>(eRecordedCall::Debug_ConvertWorldToScreen);
+}
+
+
+//INPUT
+bool InterfaceReplayer::Input_IsKeyboardKeyDown(Elite::InputScancode key) const
+{
+	return Replay<bool>(eRecordedCall::Input_IsKeyboardKeyDown, uint32_t(key));
+}
+
+bool InterfaceReplayer::Input_IsKeyboardKeyUp(Elite::InputScancode key) const
+{
+	return Replay<bool>(eRecordedCall::Input_IsKeyboardKeyUp, uint32_t(key));
+}
+
+bool InterfaceReplayer::Input_IsMouseButtonDown(Elite::InputMouseButton button) const
+{
+	return Replay<bool>(eRecordedCall::Input_IsMouseButtonDown, uint32_t(button));
+}
+
+bool InterfaceReplayer::Input_IsMouseButtonUp(Elite::InputMouseButton button) const
+{
+	return Replay<bool>(eRecordedCall::Input_IsMouseButtonUp, uint32_t(button));
+}
+
+Elite::MouseData InterfaceReplayer::Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button) const
+{
+	return Replay<Elite::MouseData>(eRecordedCall::Input_GetMouseData, uint32_t(type));
+}
+
+
+//EVENT
+void InterfaceReplayer::RequestShutdown() const
+{
+	if (m_Reader.BeginRecord(eRecordedCall::RequestShutdown))
+		m_ShutdownRequested = true;
+}
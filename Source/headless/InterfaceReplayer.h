@@ -0,0 +1,109 @@
+#pragma once
+#include <IExamInterface.h>
+#include "InterfaceRecording.h"
+
+// Stand-in for the AI Framework that plays back an interface recording (see InterfaceRecorder), without any game or simulation
+// Every query returns what it returned when it was recorded, which is all the plugin needs to make the same decisions again,
+// so a replay runs as fast as the plugin itself. Frames are driven like in HeadlessWorld: BeginFrame() -> plugin's UpdateSteering() -> EndFrame()
+// As soon as the plugin asks for anything else than what was recorded, it has diverged (the replay ends there)
+class InterfaceReplayer final : public IExamInterface
+{
+public:
+	InterfaceReplayer();
+	~InterfaceReplayer() = default;
+
+	bool Open(const string& filePath); // The plugin has to be seeded with GetSeed()
+	int GetSeed() const { return m_Header.Seed; }
+
+	bool BeginFrame(float& deltaTime); // False once the recording ended (or diverged)
+	bool EndFrame(const SteeringPlugin_Output& steering); // False when the plugin steered differently than it did in the recording
+
+	bool HasDiverged() const { return m_Reader.HasDiverged(); }
+	bool IsCutOff() const { return m_Reader.IsCutOff(); }
+	const StatisticsInfo& GetLastStats() const { return m_LastStats; } // The most recent stats the plugin was given
+	bool IsShutdownRequested() const { return m_ShutdownRequested; }
+
+	//WORLD & ENTITIES
+	WorldInfo World_GetInfo() const override;
+	StatisticsInfo World_GetStats() const override;
+	bool Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const override;
+	bool Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const override;
+	AgentInfo Agent_GetInfo() const override;
+	bool Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy) override;
+
+	//NAVMESH
+	Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override;
+
+	//INVENTORY
+	bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+	bool Inventory_UseItem(UINT slotId) override;
+	bool Inventory_RemoveItem(UINT slotId) override;
+	bool Inventory_GetItem(UINT slotId, ItemInfo& item) override;
+	UINT Inventory_GetCapacity() const override;
+
+	bool Item_GetInfo(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Grab(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Destroy(EntityInfo entity) override;
+
+	int Weapon_GetAmmo(ItemInfo& item) override;
+	int Medkit_GetHealth(ItemInfo& item) override;
+	int Food_GetEnergy(ItemInfo& item) override;
+
+	//PURGEZONE
+	bool PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone) override;
+
+	//DEBUG
+	Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override;
+	Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override;
+
+	//INPUT
+	bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override;
+	bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override;
+	bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override;
+	bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override;
+	Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button = Elite::InputMouseButton(0)) const override;
+
+	//EVENT
+	void RequestShutdown() const override;
+
+	//RENDERER (nothing gets drawn)
+	void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override {}
+	void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate = false) override {}
+	void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override {}
+	void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override {}
+	void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override {}
+	void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth = 0.9f) override {}
+	void Draw_Transform(const b2Transform& xf, float depth) override {}
+	void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override {}
+	float NextDepthSlice() override { return 0.f; }
+
+private:
+	template<typename T>
+	T Replay(eRecordedCall call, uint32_t key = 0) const
+	{
+		T result{};
+		if (m_Reader.BeginRecord(call, key))
+			SerializeValue(m_Reader, result);
+		return result;
+	}
+
+	// For the queries that can fail, the result was only recorded when they didn't
+	template<typename T>
+	bool ReplayIfFound(eRecordedCall call, uint32_t key, T& result) const
+	{
+		bool found = false;
+		if (m_Reader.BeginRecord(call, key))
+		{
+			m_Reader.Value(found);
+			if (found)
+				SerializeValue(m_Reader, result);
+		}
+		return found;
+	}
+
+	// Mutable since most interface queries are const
+	mutable RecordingReader m_Reader;
+	RecordingHeader m_Header;
+	mutable StatisticsInfo m_LastStats;
+	mutable bool m_ShutdownRequested;
+};
@@ -0,0 +1,49 @@
+#include "stdafx.h"
+#include <IExamInterface.h>
+
+// Definitions that normally ship with GPP_PluginBase.lib (only available for Windows),
+// needed to link the plugin into the headless host
+#ifndef _WIN32
+
+IBaseInterface::IBaseInterface() {}
+IBaseInterface::~IBaseInterface() {}
+
+void IBaseInterface::Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color)
+{
+	Draw_Polygon(points, count, color, 0.f);
+}
+
+void IBaseInterface::Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color)
+{
+	Draw_SolidPolygon(points, count, color, 0.f);
+}
+
+void IBaseInterface::Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color)
+{
+	Draw_Circle(center, radius, color, 0.f);
+}
+
+void IBaseInterface::Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color)
+{
+	Draw_SolidCircle(center, radius, axis, color, 0.f);
+}
+
+void IBaseInterface::Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color)
+{
+	Draw_Segment(p1, p2, color, 0.f);
+}
+
+void IBaseInterface::Draw_Transform(const b2Transform& xf)
+{
+	Draw_Transform(xf, 0.f);
+}
+
+void IBaseInterface::Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color)
+{
+	Draw_Point(p, size, color, 0.f);
+}
+
+IExamInterface::IExamInterface() {}
+IExamInterface::~IExamInterface() {}
+
+#endif
@@ -0,0 +1,167 @@
+#include "stdafx.h"
+#include <map>
+#include <limits>
+#include "TelemetryTrace.h"
+
+// Trace scanner: goes through one column of any number of telemetry traces (see TelemetryTrace.h), without touching the other columns
+// Prints the column's min, mean and max per trace and over all of them (for the State column, how long the bot spent in every state)
+// Usage: TraceScan --column <name> <file.trace>...
+// Or, to list a trace's columns and states: TraceScan --list <file.trace>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::cout << "Usage: TraceScan --column <name> <file.trace>...\n";
+		std::cout << "       TraceScan --list <file.trace>\n";
+	}
+
+	struct ColumnStats
+	{
+		uint64_t Count = 0;
+		double Min = numeric_limits<double>::max();
+		double Max = numeric_limits<double>::lowest();
+		double Sum = 0.0;
+
+		void Add(const ColumnStats& other)
+		{
+			Count += other.Count;
+			Min = min(Min, other.Min);
+			Max = max(Max, other.Max);
+			Sum += other.Sum;
+		}
+	};
+
+	template<typename T>
+	ColumnStats ScanStats(const TraceReader& reader, uint32_t column)
+	{
+		ColumnStats stats{};
+		reader.ScanColumn<T>(column, [&stats](const T* pValues, uint32_t count)
+			{
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					const auto value = double(pValues[i]);
+					stats.Min = min(stats.Min, value);
+					stats.Max = max(stats.Max, value);
+					stats.Sum += value;
+				}
+				stats.Count += count;
+			});
+		return stats;
+	}
+
+	void PrintStats(const string& name, const ColumnStats& stats)
+	{
+		std::cout << name << ": ";
+		if (stats.Count == 0)
+			std::cout << "no frames\n";
+		else
+			std::cout << stats.Count << " frames, min " << stats.Min << ", mean " << stats.Sum / double(stats.Count) << ", max " << stats.Max << '\n';
+	}
+
+	int List(const string& file)
+	{
+		TraceReader reader{};
+		if (reader.Open(file) == false)
+		{
+			std::cerr << "Couldn't open trace \"" << file << "\"\n";
+			return 1;
+		}
+
+		std::cout << "Seed " << reader.GetSeed() << ", " << reader.GetFrameCount() << " frames in " << reader.GetChunkCount() << " chunks\n";
+		std::cout << "Columns:\n";
+		for (uint32_t column = 0; column < reader.GetColumnCount(); ++column)
+			std::cout << "  " << reader.GetColumnName(column) << (reader.GetColumnType(column) == eTraceColumnType::Float ? " (float)\n" : " (int)\n");
+		std::cout << "States:\n";
+		for (uint32_t state = 0; state < reader.GetStateCount(); ++state)
+			std::cout << "  " << state << ": " << reader.GetStateName(int(state)) << '\n';
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	string columnName{};
+	vector<string> files{};
+	bool list = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		if (arg == "--column" && i + 1 < argc)
+			columnName = argv[++i];
+		else if (arg == "--list")
+			list = true;
+		else if (arg.compare(0, 2, "--") != 0)
+			files.push_back(arg);
+		else
+		{
+			PrintUsage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	if (list && files.size() == 1)
+		return List(files.front());
+
+	if (columnName.empty() || files.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const bool isStateColumn = columnName == GetTraceColumnName(eTraceColumn::State);
+	ColumnStats total{};
+	map<string, uint64_t> stateFrames{}; // By state name, the indices can differ between builds of the bot
+	int failedFiles = 0;
+
+	TraceReader reader{};
+	for (const auto& file : files)
+	{
+		if (reader.Open(file) == false)
+		{
+			std::cerr << "Couldn't open trace \"" << file << "\"\n";
+			++failedFiles;
+			continue;
+		}
+
+		const int column = reader.FindColumn(columnName);
+		if (column < 0)
+		{
+			std::cerr << "\"" << file << "\" has no column " << columnName << '\n';
+			++failedFiles;
+			continue;
+		}
+
+		const auto stats = reader.GetColumnType(uint32_t(column)) == eTraceColumnType::Float ?
+			ScanStats<float>(reader, uint32_t(column)) : ScanStats<int32_t>(reader, uint32_t(column));
+		PrintStats(file, stats);
+		total.Add(stats);
+
+		if (isStateColumn)
+		{
+			vector<uint64_t> frames(reader.GetStateCount() + 1, 0); // The last one for frames without a state
+			reader.ScanColumn<int32_t>(uint32_t(column), [&frames](const int32_t* pStates, uint32_t count)
+				{
+					for (uint32_t i = 0; i < count; ++i)
+						++frames[pStates[i] >= 0 && size_t(pStates[i]) < frames.size() - 1 ? size_t(pStates[i]) : frames.size() - 1];
+				});
+			for (size_t state = 0; state < frames.size(); ++state)
+			{
+				const auto name = state + 1 < frames.size() ? reader.GetStateName(int(state)) : string("(none)");
+				stateFrames[name] += frames[state];
+			}
+		}
+	}
+
+	if (files.size() > 1)
+		PrintStats("Total", total);
+
+	for (const auto& state : stateFrames)
+	{
+		if (state.second > 0)
+			std::cout << "  " << state.first << ": " << 100.0 * double(state.second) / double(total.Count) << "% of the frames\n";
+	}
+
+	return failedFiles > 0 ? 1 : 0;
+}
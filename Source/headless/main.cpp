@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "LevelData.h"
+#include "HeadlessEpisode.h"
+
+// Headless host: runs the plugin against an in-process simulation of the game, without any window or renderer
+// Usage: HeadlessHost [--level <file.gppl>] [--seed <n>] [--enemies <n>] [--duration <seconds>] [--dt <seconds>] [--god] [--render] [--no-sidecar] [--record <file.rec>]
+// Or, to feed the plugin from an interface recording instead (see InterfaceReplayer): HeadlessHost --replay <file.rec> [--level <file.gppl>] [--frames <n>] [--render]
+
+namespace
+{
+	int Replay(const string& replayFile, const ReplaySettings& settings)
+	{
+		const auto result = ReplayEpisode(replayFile, settings);
+		if (result.Opened == false)
+		{
+			std::cerr << "Couldn't open recording \"" << replayFile << "\"\n";
+			return 1;
+		}
+
+		std::cout << "Recording:        " << replayFile << '\n';
+		std::cout << "Seed:             " << result.Seed << '\n';
+		std::cout << "Frames:           " << result.Frames << '\n';
+		if (result.Diverged)
+			std::cout << "Outcome:          diverged in frame " << result.Frames - 1 << " (the plugin asked for something else than what was recorded)\n";
+		else if (result.CutOff)
+			std::cout << "Outcome:          cut off in frame " << result.Frames - 1 << '\n';
+		else
+			std::cout << "Outcome:          replayed\n";
+		std::cout << "Steering:         " << (result.SteeringMismatches == 0 ? string("same as recorded") :
+			to_string(result.SteeringMismatches) + " frames differ, from frame " + to_string(result.FirstSteeringMismatch) + " on") << '\n';
+		std::cout << "Time survived:    " << result.Stats.TimeSurvived << " s\n";
+		std::cout << "Score:            " << result.Stats.Score << '\n';
+		std::cout << "Wall time:        " << result.WallTime << " s\n";
+		if (result.WallTime > 0.0)
+			std::cout << "Speed:            " << result.SimulatedTime / result.WallTime << " simulated s / wall s\n";
+
+		return result.Diverged || result.SteeringMismatches > 0 ? 2 : 0;
+	}
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: HeadlessHost [--level <file.gppl>] [--seed <n>] [--enemies <n>] [--duration <seconds>] [--dt <seconds>] [--god] [--render] [--no-sidecar] [--record <file.rec>]\n";
+		std::cout << "       HeadlessHost --replay <file.rec> [--level <file.gppl>] [--frames <n>] [--render]\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	string levelFile = GameDebugParams{}.LevelFile;
+	EpisodeSettings settings{};
+	auto sidecarMode = LevelData::eSidecarMode::ReadWrite;
+	string replayFile{};
+	ReplaySettings replaySettings{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--level" && hasValue)
+			levelFile = argv[++i];
+		else if (arg == "--seed" && hasValue)
+			settings.Seed = stoi(argv[++i]);
+		else if (arg == "--enemies" && hasValue)
+			settings.EnemyCount = stoi(argv[++i]);
+		else if (arg == "--duration" && hasValue)
+			settings.Duration = stof(argv[++i]);
+		else if (arg == "--dt" && hasValue)
+			settings.TimeStep = stof(argv[++i]);
+		else if (arg == "--god")
+			settings.GodMode = true;
+		else if (arg == "--render")
+			settings.Render = true;
+		else if (arg == "--no-sidecar")
+			sidecarMode = LevelData::eSidecarMode::Ignore;
+		else if (arg == "--record" && hasValue)
+			settings.RecordFile = argv[++i];
+		else if (arg == "--replay" && hasValue)
+			replayFile = argv[++i];
+		else if (arg == "--frames" && hasValue)
+			replaySettings.MaxFrames = stoull(argv[++i]);
+		else
+		{
+			PrintUsage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	if (replayFile.empty() == false)
+	{
+		replaySettings.Render = settings.Render;
+		replaySettings.LevelFile = levelFile;
+		return Replay(replayFile, replaySettings);
+	}
+
+	LevelData level{};
+	if (level.Load(levelFile, sidecarMode) == false)
+	{
+		std::cerr << "Couldn't load level \"" << levelFile << "\"\n";
+		return 1;
+	}
+
+	const auto result = RunEpisode(level, settings);
+
+	std::cout << "Level:            " << levelFile << " (" << level.GetHouses().size() << " houses" << (level.WasLoadedFromSidecar() ? ", from sidecar" : "") << ")\n";
+	std::cout << "Seed:             " << settings.Seed << '\n';
+	std::cout << "Outcome:          " << (result.AgentDied ? "died" : "survived") << '\n';
+	std::cout << "Time survived:    " << result.Stats.TimeSurvived << " s\n";
+	std::cout << "Score:            " << result.Stats.Score << '\n';
+	std::cout << "Enemies killed:   " << result.Stats.NumEnemiesKilled << '\n';
+	std::cout << "Enemies hit:      " << result.Stats.NumEnemiesHit << '\n';
+	std::cout << "Missed shots:     " << result.Stats.NumMissedShots << '\n';
+	std::cout << "Items picked up:  " << result.Stats.NumItemsPickUp << '\n';
+	std::cout << "Frames:           " << result.Frames << '\n';
+	std::cout << "NavMesh queries:  " << result.NavMeshQueries;
+	if (result.SimulatedTime > 0.f)
+		std::cout << " (" << double(result.NavMeshQueries) * 60.0 / double(result.SimulatedTime) << " per minute)";
+	std::cout << '\n';
+	std::cout << "Wall time:        " << result.WallTime << " s\n";
+	if (result.WallTime > 0.0)
+		std::cout << "Speed:            " << result.SimulatedTime / result.WallTime << " simulated s / wall s\n";
+
+	return 0;
+}
@@ -0,0 +1,212 @@
+/*=============================================================================*/
+// EAngle.h: Angles in radians, wrapped to [-pi, pi), directions from angles and signed angles between directions
+// Sine/cosine and atan2 are minimax polynomials (degree 9 on [-pi/2, pi/2] and degree 13 on [0, 1]), within a few 1e-7 of libm's,
+// with batched variants over arrays that are vectorized like the queries in EVector2SoA.h (the scalar ones run the exact same kernels)
+/*=============================================================================*/
+#ifndef ELITE_MATH_ANGLE
+#define ELITE_MATH_ANGLE
+#include <cfloat>
+#include <cmath>
+#include "EVector2SoA.h"
+
+namespace Elite
+{
+	namespace Detail
+	{
+		// Lanes of a single float, for the scalar functions (and the tails of the batched ones)
+		struct ScalarLanes
+		{
+			using Type = float;
+
+			static Type Set(float f) { return f; }
+			static Type Add(Type a, Type b) { return a + b; }
+			static Type Sub(Type a, Type b) { return a - b; }
+			static Type Mul(Type a, Type b) { return a * b; }
+			static Type Div(Type a, Type b) { return a / b; }
+			static Type Min(Type a, Type b) { return a < b ? a : b; }
+			static Type Max(Type a, Type b) { return a > b ? a : b; }
+			static Type Abs(Type a) { return fabsf(a); }
+			static Type CopySign(Type magnitude, Type sign) { return copysignf(magnitude, sign); }
+			static Type Floor(Type a) { return floorf(a); }
+			static bool Less(Type a, Type b) { return a < b; }
+			static Type Select(bool mask, Type a, Type b) { return mask ? a : b; }
+		};
+
+		constexpr float c_Pi{ 3.14159265358979323846f };
+		constexpr float c_HalfPi{ 1.57079632679489661923f };
+		constexpr float c_InverseTwoPi{ 0.159154943091895335769f };
+		constexpr float c_TwoPi{ 6.28318530717958647693f };
+		constexpr float c_TwoPiHi{ 6.28125f }; // 2 pi in three parts, the first with few enough bits that whole turns times it stay exact, so wrapping big angles doesn't lose the remainder
+		constexpr float c_TwoPiMid{ 1.9353071693331003e-03f };
+		constexpr float c_TwoPiLo{ 1.0253131677018246e-11f };
+
+		template<typename Lanes>
+		typename Lanes::Type WrapAngle(typename Lanes::Type angle)
+		{
+			using L = Lanes;
+			const auto turns = L::Floor(L::Mul(L::Add(angle, L::Set(c_Pi)), L::Set(c_InverseTwoPi)));
+			auto wrapped = L::Sub(angle, L::Mul(turns, L::Set(c_TwoPiHi)));
+			wrapped = L::Sub(wrapped, L::Mul(turns, L::Set(c_TwoPiMid)));
+			wrapped = L::Sub(wrapped, L::Mul(turns, L::Set(c_TwoPiLo)));
+
+			// Rounding can leave it just outside
+			wrapped = L::Select(L::Less(wrapped, L::Set(c_Pi)), wrapped, L::Sub(wrapped, L::Set(c_TwoPi)));
+			return L::Select(L::Less(wrapped, L::Set(-c_Pi)), L::Add(wrapped, L::Set(c_TwoPi)), wrapped);
+		}
+
+		// Only on [-pi/2, pi/2]
+		template<typename Lanes>
+		typename Lanes::Type SinPolynomial(typename Lanes::Type x)
+		{
+			using L = Lanes;
+			const auto x2 = L::Mul(x, x);
+			auto p = L::Set(2.590486010e-06f);
+			p = L::Add(L::Mul(p, x2), L::Set(-1.980089635e-04f));
+			p = L::Add(L::Mul(p, x2), L::Set(8.332899796e-03f));
+			p = L::Add(L::Mul(p, x2), L::Set(-1.666664763e-01f));
+			p = L::Add(L::Mul(p, x2), L::Set(9.999999766e-01f));
+			return L::Mul(p, x);
+		}
+
+		// Only on [0, 1]
+		template<typename Lanes>
+		typename Lanes::Type AtanPolynomial(typename Lanes::Type x)
+		{
+			using L = Lanes;
+			const auto x2 = L::Mul(x, x);
+			auto p = L::Set(6.811840520e-03f);
+			p = L::Add(L::Mul(p, x2), L::Set(-3.360437581e-02f));
+			p = L::Add(L::Mul(p, x2), L::Set(7.962386915e-02f));
+			p = L::Add(L::Mul(p, x2), L::Set(-1.323335411e-01f));
+			p = L::Add(L::Mul(p, x2), L::Set(1.980781915e-01f));
+			p = L::Add(L::Mul(p, x2), L::Set(-3.331736852e-01f));
+			p = L::Add(L::Mul(p, x2), L::Set(9.999961117e-01f));
+			return L::Mul(p, x);
+		}
+
+		// Of an angle that's already wrapped
+		template<typename Lanes>
+		void SinCos(typename Lanes::Type angle, typename Lanes::Type& sin, typename Lanes::Type& cos)
+		{
+			using L = Lanes;
+			const auto absAngle = L::Abs(angle);
+			cos = SinPolynomial<L>(L::Sub(L::Set(c_HalfPi), absAngle)); // cos(a) = sin(pi/2 - |a|)
+			sin = SinPolynomial<L>(L::CopySign(L::Sub(L::Set(c_HalfPi), L::Abs(L::Sub(absAngle, L::Set(c_HalfPi)))), angle)); // Folded into [-pi/2, pi/2]
+		}
+
+		template<typename Lanes>
+		typename Lanes::Type Atan2(typename Lanes::Type y, typename Lanes::Type x)
+		{
+			// Of the smaller over the bigger one (so it's on [0, 1]), then unfolded into the right octant
+			using L = Lanes;
+			const auto absX = L::Abs(x);
+			const auto absY = L::Abs(y);
+			auto angle = AtanPolynomial<L>(L::Div(L::Min(absX, absY), L::Max(L::Max(absX, absY), L::Set(FLT_MIN))));
+			angle = L::Select(L::Less(absX, absY), L::Sub(L::Set(c_HalfPi), angle), angle);
+			angle = L::Select(L::Less(x, L::Set(0.f)), L::Sub(L::Set(c_Pi), angle), angle);
+			return L::CopySign(angle, y);
+		}
+	}
+
+	/* --- SCALAR --- */
+	/*! Wraps an angle into [-pi, pi), as precisely as the float it got (for |angle| up to about 1e5, way past what an orientation ever gets to) */
+	inline float WrapAngle(float angle)
+	{
+		return Detail::WrapAngle<Detail::ScalarLanes>(angle);
+	}
+
+	inline float FastSin(float angle)
+	{
+		float sin, cos;
+		Detail::SinCos<Detail::ScalarLanes>(WrapAngle(angle), sin, cos);
+		return sin;
+	}
+
+	inline float FastCos(float angle)
+	{
+		float sin, cos;
+		Detail::SinCos<Detail::ScalarLanes>(WrapAngle(angle), sin, cos);
+		return cos;
+	}
+
+	/*! Unit vector at the angle, counterclockwise from +x */
+	inline Vector2 DirectionFromAngle(float angle)
+	{
+		float sin, cos;
+		Detail::SinCos<Detail::ScalarLanes>(WrapAngle(angle), sin, cos);
+		return Vector2(cos, sin);
+	}
+
+	/*! Unit vector the agent's facing at that orientation (the same as OrientationToVector()) */
+	inline Vector2 DirectionFromOrientation(float orientation)
+	{
+		return DirectionFromAngle(orientation - Detail::c_HalfPi);
+	}
+
+	/*! Angle of (x, y) in [-pi, pi], 0 for (0, 0) */
+	inline float FastAtan2(float y, float x)
+	{
+		return Detail::Atan2<Detail::ScalarLanes>(y, x);
+	}
+
+	/*! Angle to turn from one direction to the other (neither has to be normalized), in [-pi, pi], positive counterclockwise */
+	inline float SignedAngle(const Vector2& from, const Vector2& to)
+	{
+		return FastAtan2(Cross(from, to), Dot(from, to));
+	}
+
+	/* --- BATCHED --- */
+	inline void WrapAngles(const float* pAngles, size_t count, float* pWrapped)
+	{
+		size_t i = 0;
+#ifdef ELITE_SIMD
+		using Detail::FloatLanes;
+		for (; i + FloatLanes::Width <= count; i += FloatLanes::Width)
+			FloatLanes::Store(pWrapped + i, Detail::WrapAngle<FloatLanes>(FloatLanes::Load(pAngles + i)));
+#endif
+		for (; i < count; ++i)
+			pWrapped[i] = WrapAngle(pAngles[i]);
+	}
+
+	inline void DirectionsFromAngles(const float* pAngles, size_t count, float* pX, float* pY)
+	{
+		size_t i = 0;
+#ifdef ELITE_SIMD
+		using Detail::FloatLanes;
+		for (; i + FloatLanes::Width <= count; i += FloatLanes::Width)
+		{
+			FloatLanes::Type sin, cos;
+			Detail::SinCos<FloatLanes>(Detail::WrapAngle<FloatLanes>(FloatLanes::Load(pAngles + i)), sin, cos);
+			FloatLanes::Store(pX + i, cos);
+			FloatLanes::Store(pY + i, sin);
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			const auto direction = DirectionFromAngle(pAngles[i]);
+			pX[i] = direction.x;
+			pY[i] = direction.y;
+		}
+	}
+
+	inline void SignedAngles(const float* pFromX, const float* pFromY, const float* pToX, const float* pToY, size_t count, float* pAngles)
+	{
+		size_t i = 0;
+#ifdef ELITE_SIMD
+		using Detail::FloatLanes;
+		for (; i + FloatLanes::Width <= count; i += FloatLanes::Width)
+		{
+			const auto fromX = FloatLanes::Load(pFromX + i);
+			const auto fromY = FloatLanes::Load(pFromY + i);
+			const auto toX = FloatLanes::Load(pToX + i);
+			const auto toY = FloatLanes::Load(pToY + i);
+			const auto cross = FloatLanes::Sub(FloatLanes::Mul(fromX, toY), FloatLanes::Mul(fromY, toX));
+			const auto dot = FloatLanes::Add(FloatLanes::Mul(fromX, toX), FloatLanes::Mul(fromY, toY));
+			FloatLanes::Store(pAngles + i, Detail::Atan2<FloatLanes>(cross, dot));
+		}
+#endif
+		for (; i < count; ++i)
+			pAngles[i] = SignedAngle(Vector2(pFromX[i], pFromY[i]), Vector2(pToX[i], pToY[i]));
+	}
+}
+#endif
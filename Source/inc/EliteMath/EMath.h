@@ -15,6 +15,8 @@
 #include "EVector2.h"
 #include "EVector3.h"
 #include "EMat22.h"
+#include "EVector2SoA.h"
+#include "EAngle.h"
 
 /* --- TYPE DEFINES --- */
 #endif
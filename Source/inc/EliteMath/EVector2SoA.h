@@ -0,0 +1,322 @@
+/*=============================================================================*/
+// EVector2SoA.h: Vector2 array stored as separate x and y arrays, with batch distance queries over it
+// (closest point, k closest points, points in radius, closest circle edge)
+// The queries are vectorized with AVX2 or SSE2 when the compiler targets them, with a scalar fallback otherwise
+/*=============================================================================*/
+#ifndef ELITE_MATH_VECTOR2_SOA
+#define ELITE_MATH_VECTOR2_SOA
+#include <vector>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX2__)
+#define ELITE_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ELITE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Elite
+{
+	//Vector 2D array, Structure of Arrays
+	class Vector2SoA
+	{
+	public:
+		void Clear() { m_X.clear(); m_Y.clear(); }
+		void Reserve(size_t capacity) { m_X.reserve(capacity); m_Y.reserve(capacity); }
+		void PushBack(const Vector2& v) { m_X.push_back(v.x); m_Y.push_back(v.y); }
+		void PopBack() { m_X.pop_back(); m_Y.pop_back(); }
+		void Set(size_t i, const Vector2& v) { m_X[i] = v.x; m_Y[i] = v.y; }
+
+		Vector2 operator[](size_t i) const { return Vector2(m_X[i], m_Y[i]); }
+		size_t Size() const { return m_X.size(); }
+		bool Empty() const { return m_X.empty(); }
+		const float* GetX() const { return m_X.data(); }
+		const float* GetY() const { return m_Y.data(); }
+
+	private:
+		std::vector<float> m_X;
+		std::vector<float> m_Y;
+	};
+
+	namespace Detail
+	{
+#if defined(ELITE_SIMD_AVX2)
+#define ELITE_SIMD
+		struct FloatLanes
+		{
+			using Type = __m256;
+			static const int Width = 8;
+
+			static Type Load(const float* p) { return _mm256_loadu_ps(p); }
+			static void Store(float* p, Type v) { _mm256_storeu_ps(p, v); }
+			static Type Set(float f) { return _mm256_set1_ps(f); }
+			static Type Iota(float first) { return _mm256_setr_ps(first, first + 1.f, first + 2.f, first + 3.f, first + 4.f, first + 5.f, first + 6.f, first + 7.f); }
+			static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+			static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+			static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+			static Type Div(Type a, Type b) { return _mm256_div_ps(a, b); }
+			static Type Sqrt(Type a) { return _mm256_sqrt_ps(a); }
+			static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+			static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+			static Type Abs(Type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+			static Type CopySign(Type magnitude, Type sign) { return _mm256_or_ps(Abs(magnitude), _mm256_and_ps(_mm256_set1_ps(-0.f), sign)); }
+			static Type Floor(Type a) { return _mm256_floor_ps(a); }
+			static Type Less(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static Type LessEqual(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+			static Type Select(Type mask, Type a, Type b) { return _mm256_blendv_ps(b, a, mask); }
+			static int MoveMask(Type mask) { return _mm256_movemask_ps(mask); }
+		};
+#elif defined(ELITE_SIMD_SSE2)
+#define ELITE_SIMD
+		struct FloatLanes
+		{
+			using Type = __m128;
+			static const int Width = 4;
+
+			static Type Load(const float* p) { return _mm_loadu_ps(p); }
+			static void Store(float* p, Type v) { _mm_storeu_ps(p, v); }
+			static Type Set(float f) { return _mm_set1_ps(f); }
+			static Type Iota(float first) { return _mm_setr_ps(first, first + 1.f, first + 2.f, first + 3.f); }
+			static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+			static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+			static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+			static Type Div(Type a, Type b) { return _mm_div_ps(a, b); }
+			static Type Sqrt(Type a) { return _mm_sqrt_ps(a); }
+			static Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+			static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+			static Type Abs(Type a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+			static Type CopySign(Type magnitude, Type sign) { return _mm_or_ps(Abs(magnitude), _mm_and_ps(_mm_set1_ps(-0.f), sign)); }
+			static Type Floor(Type a)
+			{
+				// No rounding instructions before SSE4.1: truncate, then step down where that rounded up (only for |a| < 2^31)
+				const auto truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+				return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.f)));
+			}
+			static Type Less(Type a, Type b) { return _mm_cmplt_ps(a, b); }
+			static Type LessEqual(Type a, Type b) { return _mm_cmple_ps(a, b); }
+			static Type Select(Type mask, Type a, Type b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+			static int MoveMask(Type mask) { return _mm_movemask_ps(mask); }
+		};
+#endif
+
+#ifdef ELITE_SIMD
+		inline FloatLanes::Type DistancesSquared(const float* pX, const float* pY, size_t i, FloatLanes::Type x, FloatLanes::Type y)
+		{
+			const auto dx = FloatLanes::Sub(FloatLanes::Load(pX + i), x);
+			const auto dy = FloatLanes::Sub(FloatLanes::Load(pY + i), y);
+			return FloatLanes::Add(FloatLanes::Mul(dx, dx), FloatLanes::Mul(dy, dy));
+		}
+#endif
+
+		inline float DistanceSquared(const float* pX, const float* pY, size_t i, const Vector2& position)
+		{
+			const auto dx = pX[i] - position.x;
+			const auto dy = pY[i] - position.y;
+			return dx * dx + dy * dy;
+		}
+
+		/*! Index of the smallest value (the first one on ties), -1 when empty. Indices are tracked as floats, so up to 2^24 values */
+		template<typename SimdValues, typename ScalarValue>
+		int ArgMin(size_t count, SimdValues getSimdValues, ScalarValue getScalarValue, float* pMinValue)
+		{
+			int minIdx = -1;
+			float minValue = FLT_MAX;
+			size_t i = 0;
+
+#ifdef ELITE_SIMD
+			const auto width = size_t(FloatLanes::Width);
+			if (count >= width)
+			{
+				auto minValues = FloatLanes::Set(FLT_MAX);
+				auto minIndices = FloatLanes::Set(-1.f);
+				auto indices = FloatLanes::Iota(0.f);
+				const auto step = FloatLanes::Set(float(width));
+				for (; i + width <= count; i += width)
+				{
+					const auto values = getSimdValues(i);
+					const auto isSmaller = FloatLanes::Less(values, minValues);
+					minValues = FloatLanes::Select(isSmaller, values, minValues);
+					minIndices = FloatLanes::Select(isSmaller, indices, minIndices);
+					indices = FloatLanes::Add(indices, step);
+				}
+
+				// Every lane holds the first minimum of its own values, keep the smallest (and earliest) of those
+				float laneValues[FloatLanes::Width];
+				float laneIndices[FloatLanes::Width];
+				FloatLanes::Store(laneValues, minValues);
+				FloatLanes::Store(laneIndices, minIndices);
+				for (int lane = 0; lane < FloatLanes::Width; ++lane)
+				{
+					const auto laneIdx = int(laneIndices[lane]);
+					if (laneIdx >= 0 && (laneValues[lane] < minValue || (laneValues[lane] == minValue && laneIdx < minIdx)))
+					{
+						minValue = laneValues[lane];
+						minIdx = laneIdx;
+					}
+				}
+			}
+#endif
+
+			for (; i < count; ++i)
+			{
+				const auto value = getScalarValue(i);
+				if (value < minValue)
+				{
+					minValue = value;
+					minIdx = int(i);
+				}
+			}
+
+			if (minIdx < 0 && count > 0) // Only FLT_MAX or bigger (or NaN) values
+			{
+				minIdx = 0;
+				minValue = getScalarValue(0);
+			}
+
+			if (pMinValue)
+				*pMinValue = minValue;
+			return minIdx;
+		}
+	}
+
+	/* --- QUERIES --- */
+	/*! Squared distance from every point to the position */
+	inline void DistancesSquared(const float* pX, const float* pY, size_t count, const Vector2& position, float* pDistancesSquared)
+	{
+		size_t i = 0;
+#ifdef ELITE_SIMD
+		const auto x = Detail::FloatLanes::Set(position.x);
+		const auto y = Detail::FloatLanes::Set(position.y);
+		for (; i + Detail::FloatLanes::Width <= count; i += Detail::FloatLanes::Width)
+			Detail::FloatLanes::Store(pDistancesSquared + i, Detail::DistancesSquared(pX, pY, i, x, y));
+#endif
+		for (; i < count; ++i)
+			pDistancesSquared[i] = Detail::DistanceSquared(pX, pY, i, position);
+	}
+
+	/*! Index of the point closest to the position (the first one on ties), -1 when there are none */
+	inline int ClosestPoint(const float* pX, const float* pY, size_t count, const Vector2& position, float* pDistanceSquared = nullptr)
+	{
+#ifdef ELITE_SIMD
+		const auto x = Detail::FloatLanes::Set(position.x);
+		const auto y = Detail::FloatLanes::Set(position.y);
+		const auto getSimdValues = [&](size_t i) { return Detail::DistancesSquared(pX, pY, i, x, y); };
+#else
+		const auto getSimdValues = [](size_t) { return 0.f; };
+#endif
+		return Detail::ArgMin(count, getSimdValues, [&](size_t i) { return Detail::DistanceSquared(pX, pY, i, position); }, pDistanceSquared);
+	}
+
+	/*! Indices of the (at most) k points closest to the position, closest first. Returns how many were written (min(k, count)) */
+	inline size_t ClosestPoints(const float* pX, const float* pY, size_t count, const Vector2& position, size_t k, int* pIndices, float* pDistancesSquared)
+	{
+		if (k == 0)
+			return 0;
+
+		size_t found = 0;
+		const auto insert = [&](float distanceSquared, int idx)
+		{
+			if (found == k && (distanceSquared < pDistancesSquared[k - 1]) == false)
+				return;
+
+			// Insertion sort, after any equal distance (so earlier points win ties)
+			auto insertAt = found < k ? found : k - 1;
+			for (; insertAt > 0 && distanceSquared < pDistancesSquared[insertAt - 1]; --insertAt)
+			{
+				pDistancesSquared[insertAt] = pDistancesSquared[insertAt - 1];
+				pIndices[insertAt] = pIndices[insertAt - 1];
+			}
+			pDistancesSquared[insertAt] = distanceSquared;
+			pIndices[insertAt] = idx;
+			found += found < k ? 1 : 0;
+		};
+
+		size_t i = 0;
+#ifdef ELITE_SIMD
+		const auto x = Detail::FloatLanes::Set(position.x);
+		const auto y = Detail::FloatLanes::Set(position.y);
+		float distancesSquared[Detail::FloatLanes::Width];
+		for (; i + Detail::FloatLanes::Width <= count; i += Detail::FloatLanes::Width)
+		{
+			// Only look at the lanes that beat the current k-th closest
+			const auto values = Detail::DistancesSquared(pX, pY, i, x, y);
+			const auto threshold = Detail::FloatLanes::Set(found < k ? FLT_MAX : pDistancesSquared[k - 1]);
+			auto candidates = Detail::FloatLanes::MoveMask(Detail::FloatLanes::Less(values, threshold));
+			if (candidates == 0)
+				continue;
+
+			Detail::FloatLanes::Store(distancesSquared, values);
+			for (int lane = 0; candidates != 0; ++lane, candidates >>= 1)
+			{
+				if (candidates & 1)
+					insert(distancesSquared[lane], int(i) + lane);
+			}
+		}
+#endif
+		for (; i < count; ++i)
+			insert(Detail::DistanceSquared(pX, pY, i, position), int(i));
+
+		return found;
+	}
+
+	/*! Indices of every point within the radius of the position (inclusive), in order. Returns how many were written (pIndices needs room for count) */
+	inline size_t PointsInRadius(const float* pX, const float* pY, size_t count, const Vector2& position, float radius, int* pIndices)
+	{
+		const auto radiusSquared = radius * radius;
+		size_t found = 0;
+		size_t i = 0;
+#ifdef ELITE_SIMD
+		const auto x = Detail::FloatLanes::Set(position.x);
+		const auto y = Detail::FloatLanes::Set(position.y);
+		const auto threshold = Detail::FloatLanes::Set(radiusSquared);
+		for (; i + Detail::FloatLanes::Width <= count; i += Detail::FloatLanes::Width)
+		{
+			auto inside = Detail::FloatLanes::MoveMask(Detail::FloatLanes::LessEqual(Detail::DistancesSquared(pX, pY, i, x, y), threshold));
+			for (int lane = 0; inside != 0; ++lane, inside >>= 1)
+			{
+				if (inside & 1)
+					pIndices[found++] = int(i) + lane;
+			}
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			if (Detail::DistanceSquared(pX, pY, i, position) <= radiusSquared)
+				pIndices[found++] = int(i);
+		}
+
+		return found;
+	}
+
+	/*! Index of the circle whose edge is closest to the position (negative distances are inside), -1 when there are none */
+	inline int ClosestCircleEdge(const float* pX, const float* pY, const float* pRadii, size_t count, const Vector2& position, float* pEdgeDistance = nullptr)
+	{
+#ifdef ELITE_SIMD
+		const auto x = Detail::FloatLanes::Set(position.x);
+		const auto y = Detail::FloatLanes::Set(position.y);
+		const auto getSimdValues = [&](size_t i) { return Detail::FloatLanes::Sub(Detail::FloatLanes::Sqrt(Detail::DistancesSquared(pX, pY, i, x, y)), Detail::FloatLanes::Load(pRadii + i)); };
+#else
+		const auto getSimdValues = [](size_t) { return 0.f; };
+#endif
+		return Detail::ArgMin(count, getSimdValues, [&](size_t i) { return sqrtf(Detail::DistanceSquared(pX, pY, i, position)) - pRadii[i]; }, pEdgeDistance);
+	}
+
+	/* --- QUERIES ON A Vector2SoA --- */
+	inline int ClosestPoint(const Vector2SoA& points, const Vector2& position, float* pDistanceSquared = nullptr)
+	{ return ClosestPoint(points.GetX(), points.GetY(), points.Size(), position, pDistanceSquared); }
+
+	inline size_t ClosestPoints(const Vector2SoA& points, const Vector2& position, size_t k, int* pIndices, float* pDistancesSquared)
+	{ return ClosestPoints(points.GetX(), points.GetY(), points.Size(), position, k, pIndices, pDistancesSquared); }
+
+	inline void PointsInRadius(const Vector2SoA& points, const Vector2& position, float radius, std::vector<int>& indices)
+	{
+		indices.resize(points.Size());
+		indices.resize(PointsInRadius(points.GetX(), points.GetY(), points.Size(), position, radius, indices.data()));
+	}
+
+	inline int ClosestCircleEdge(const Vector2SoA& centers, const std::vector<float>& radii, const Vector2& position, float* pEdgeDistance = nullptr)
+	{ return ClosestCircleEdge(centers.GetX(), centers.GetY(), radii.data(), centers.Size(), position, pEdgeDistance); }
+}
+#endif
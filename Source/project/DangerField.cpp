@@ -0,0 +1,246 @@
+#include "stdafx.h"
+#include "DangerField.h"
+#include "EnemyTracks.h"
+#include "NavGrid.h"
+#include <cfloat>
+
+namespace
+{
+	const Elite::Vector2 g_NoFlow{};
+	const int g_WallSamples{ 4 }; // Per side of a cell, to find a walkable spot in it
+}
+
+DangerField::DangerField(float cellSize, float radius)
+	: m_Danger()
+	, m_Flow()
+	, m_Links()
+	, m_GridMin()
+	, m_CellSize(cellSize)
+	, m_Columns(0)
+	, m_Rows(0)
+	, m_Kernel()
+	, m_KernelRadius(max(1, int(ceilf(radius / cellSize))))
+	, m_Splats()
+	, m_DirtyRects()
+	, m_Stamp(0)
+	, m_MovedCount(0)
+	, m_pNavGrid(nullptr)
+{
+	// Falls off linearly with distance, so the closest enemies weigh the most
+	const auto kernelSize = 2 * m_KernelRadius + 1;
+	m_Kernel.resize(size_t(kernelSize) * kernelSize);
+	for (int offsetY = -m_KernelRadius; offsetY <= m_KernelRadius; ++offsetY)
+	{
+		for (int offsetX = -m_KernelRadius; offsetX <= m_KernelRadius; ++offsetX)
+		{
+			const auto distance = sqrtf(float(offsetX * offsetX + offsetY * offsetY)) * cellSize;
+			const auto falloff = max(0.f, 1.f - distance / radius);
+			m_Kernel[(offsetY + m_KernelRadius) * kernelSize + offsetX + m_KernelRadius] = int32_t(float(m_KernelPeak) * falloff + 0.5f);
+		}
+	}
+}
+
+void DangerField::Update(const EnemyTracks& enemyTracks, const WorldInfo& world)
+{
+	if (m_Danger.empty())
+		SetUpGrid(world);
+
+	++m_Stamp;
+	m_MovedCount = 0;
+	m_DirtyRects.clear();
+
+	// Re-splat the tracks that moved into another cell (or just showed up)
+	const auto& hashes = enemyTracks.GetHashes();
+	const auto& predictedPositions = enemyTracks.GetPredictedPositions();
+	for (size_t trackIdx = 0; trackIdx < hashes.size(); ++trackIdx)
+	{
+		const auto cellIdx = GetCellIdx(predictedPositions[trackIdx]);
+		const auto cellX = cellIdx % m_Columns;
+		const auto cellY = cellIdx / m_Columns;
+
+		const auto it = m_Splats.find(hashes[trackIdx]);
+		if (it == m_Splats.end())
+		{
+			m_Splats.emplace(hashes[trackIdx], Splat{ cellX, cellY, m_Stamp });
+			AddSplat(cellX, cellY, 1);
+			++m_MovedCount;
+			continue;
+		}
+
+		auto& splat = it->second;
+		splat.Stamp = m_Stamp;
+		if (splat.CellX != cellX || splat.CellY != cellY)
+		{
+			AddSplat(splat.CellX, splat.CellY, -1);
+			AddSplat(cellX, cellY, 1);
+
+			// Both footprints mostly overlap, their flow only has to be redone once
+			const auto addedRect = m_DirtyRects.back();
+			m_DirtyRects.pop_back();
+			auto& removedRect = m_DirtyRects.back();
+			removedRect = Rect{ min(removedRect.MinX, addedRect.MinX), min(removedRect.MinY, addedRect.MinY), max(removedRect.MaxX, addedRect.MaxX), max(removedRect.MaxY, addedRect.MaxY) };
+			splat.CellX = cellX;
+			splat.CellY = cellY;
+			++m_MovedCount;
+		}
+	}
+
+	// Take out the ones that aren't tracked anymore
+	for (auto it = m_Splats.begin(); it != m_Splats.end();)
+	{
+		if (it->second.Stamp != m_Stamp)
+		{
+			AddSplat(it->second.CellX, it->second.CellY, -1);
+			it = m_Splats.erase(it);
+			++m_MovedCount;
+		}
+		else
+			++it;
+	}
+
+	// Only now that the danger's final
+	for (const auto& rect : m_DirtyRects)
+		UpdateFlow(rect);
+}
+
+void DangerField::Clear()
+{
+	fill(m_Danger.begin(), m_Danger.end(), 0);
+	fill(m_Flow.begin(), m_Flow.end(), Elite::Vector2{});
+	m_Splats.clear();
+	m_MovedCount = 0;
+}
+
+float DangerField::GetDanger(const Elite::Vector2& position) const
+{
+	if (m_Danger.empty())
+		return 0.f;
+	return float(m_Danger[GetCellIdx(position)]) / float(m_KernelPeak);
+}
+
+const Elite::Vector2& DangerField::GetFlow(const Elite::Vector2& position) const
+{
+	if (m_Flow.empty())
+		return g_NoFlow;
+	return m_Flow[GetCellIdx(position)];
+}
+
+void DangerField::SetUpGrid(const WorldInfo& world)
+{
+	m_GridMin = world.Center - world.Dimensions / 2.f;
+	m_Columns = max(1, int(ceilf(world.Dimensions.x / m_CellSize)));
+	m_Rows = max(1, int(ceilf(world.Dimensions.y / m_CellSize)));
+	const auto nrOfCells = size_t(m_Columns) * m_Rows;
+	m_Danger.assign(nrOfCells, 0);
+	m_Flow.assign(nrOfCells, Elite::Vector2{});
+	m_Links.assign(nrOfCells, 0);
+	SetUpLinks();
+}
+
+void DangerField::SetUpLinks()
+{
+	// Every cell gets a walkable spot (the one closest to its center), neighbors are linked when there's a straight line between their spots
+	// Without a nav grid, every neighbor inside the world is
+	const bool hasNavGrid = m_pNavGrid != nullptr && m_pNavGrid->IsBuilt();
+	const auto nrOfCells = m_Links.size();
+	vector<Elite::Vector2> spots(nrOfCells);
+	vector<uint8_t> hasSpot(nrOfCells, 0);
+	const auto sampleSpacing = m_CellSize / float(g_WallSamples);
+	for (size_t cellIdx = 0; cellIdx < nrOfCells && hasNavGrid; ++cellIdx)
+	{
+		const auto cellMin = m_GridMin + Elite::Vector2{ float(cellIdx % m_Columns), float(cellIdx / m_Columns) } * m_CellSize;
+		const auto cellCenter = cellMin + Elite::Vector2{ m_CellSize, m_CellSize } / 2.f;
+		float closestDistanceSquared = FLT_MAX;
+		for (int sampleY = 0; sampleY < g_WallSamples; ++sampleY)
+		{
+			for (int sampleX = 0; sampleX < g_WallSamples; ++sampleX)
+			{
+				const auto samplePosition = cellMin + Elite::Vector2{ float(sampleX) + 0.5f, float(sampleY) + 0.5f } * sampleSpacing;
+				const auto distanceSquared = samplePosition.DistanceSquared(cellCenter);
+				if (distanceSquared < closestDistanceSquared && m_pNavGrid->IsWalkable(samplePosition))
+				{
+					closestDistanceSquared = distanceSquared;
+					spots[cellIdx] = samplePosition;
+					hasSpot[cellIdx] = 1;
+				}
+			}
+		}
+	}
+
+	const auto isLinked = [&](size_t cellIdx, size_t neighborIdx)
+	{
+		return hasNavGrid == false || (hasSpot[cellIdx] != 0 && hasSpot[neighborIdx] != 0 && m_pNavGrid->HasLineOfSight(spots[cellIdx], spots[neighborIdx]));
+	};
+	for (size_t cellIdx = 0; cellIdx < nrOfCells; ++cellIdx)
+	{
+		const auto cellX = int(cellIdx % m_Columns);
+		const auto cellY = int(cellIdx / m_Columns);
+		uint8_t links = 0;
+		if (cellX + 1 < m_Columns && isLinked(cellIdx, cellIdx + 1))
+			links |= eLink::Right;
+		if (cellX > 0 && isLinked(cellIdx, cellIdx - 1))
+			links |= eLink::Left;
+		if (cellY + 1 < m_Rows && isLinked(cellIdx, cellIdx + m_Columns))
+			links |= eLink::Up;
+		if (cellY > 0 && isLinked(cellIdx, cellIdx - m_Columns))
+			links |= eLink::Down;
+		m_Links[cellIdx] = links;
+	}
+}
+
+int DangerField::GetCellIdx(const Elite::Vector2& position) const
+{
+	const auto local = (position - m_GridMin) / m_CellSize;
+	const auto cellX = Elite::Clamp(int(floorf(local.x)), 0, m_Columns - 1);
+	const auto cellY = Elite::Clamp(int(floorf(local.y)), 0, m_Rows - 1);
+	return cellY * m_Columns + cellX;
+}
+
+void DangerField::AddSplat(int cellX, int cellY, int sign)
+{
+	const auto kernelSize = 2 * m_KernelRadius + 1;
+	const auto minX = max(0, cellX - m_KernelRadius);
+	const auto minY = max(0, cellY - m_KernelRadius);
+	const auto maxX = min(m_Columns - 1, cellX + m_KernelRadius);
+	const auto maxY = min(m_Rows - 1, cellY + m_KernelRadius);
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const auto* pKernelRow = m_Kernel.data() + (y - cellY + m_KernelRadius) * kernelSize + m_KernelRadius - cellX + minX;
+		auto* pDangerRow = m_Danger.data() + y * m_Columns + minX;
+		for (int x = 0; x <= maxX - minX; ++x)
+			pDangerRow[x] += sign * pKernelRow[x];
+	}
+
+	// The flow of a cell depends on its neighbors as well
+	m_DirtyRects.push_back(Rect{ max(0, minX - 1), max(0, minY - 1), min(m_Columns - 1, maxX + 1), min(m_Rows - 1, maxY + 1) });
+}
+
+void DangerField::UpdateFlow(const Rect& rect)
+{
+	for (int y = rect.MinY; y <= rect.MaxY; ++y)
+	{
+		for (int x = rect.MinX; x <= rect.MaxX; ++x)
+		{
+			const auto cellIdx = y * m_Columns + x;
+			auto& flow = m_Flow[cellIdx];
+			if (m_Danger[cellIdx] <= 0)
+			{
+				flow = Elite::Vector2{};
+				continue;
+			}
+
+			// Down the (central difference) gradient
+			flow.x = float(GetNeighborDanger(cellIdx, cellIdx - 1, eLink::Left) - GetNeighborDanger(cellIdx, cellIdx + 1, eLink::Right));
+			flow.y = float(GetNeighborDanger(cellIdx, cellIdx - m_Columns, eLink::Down) - GetNeighborDanger(cellIdx, cellIdx + m_Columns, eLink::Up));
+			flow.Normalize();
+		}
+	}
+}
+
+int DangerField::GetNeighborDanger(int cellIdx, int neighborIdx, uint8_t link) const
+{
+	// Also covers the world's border, where there's never a link
+	if ((m_Links[cellIdx] & link) == 0)
+		return m_Danger[cellIdx] + m_WallDanger;
+	return m_Danger[neighborIdx];
+}
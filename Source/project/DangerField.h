@@ -0,0 +1,84 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include <unordered_map>
+
+class EnemyTracks;
+class NavGrid;
+
+// How dangerous every spot around the tracked enemies is, and which way is away from it, on a coarse grid over the world
+// Every track splats a fixed kernel (falling off with distance) around where it'll be shortly (its predicted position, see EnemyTracks),
+// summed up in integers so taking a splat back out is exact. Only the tracks that moved into another cell get re-splatted,
+// and only the cells around them get their flow recomputed, so an update costs the same whatever the amount of zombies standing around
+// The flow is the way down the danger, where a neighbor that can't be walked to in a straight line (through the NavGrid)
+// or is outside of the world counts as dangerous, so whoever follows it gets steered around the walls too. Sampling it is a lookup
+class DangerField final
+{
+public:
+	explicit DangerField(float cellSize = 4.f, float radius = 50.f);
+	~DangerField() = default;
+
+	DangerField(const DangerField&) = delete;
+	DangerField& operator=(const DangerField&) = delete;
+
+	void SetNavGrid(const NavGrid* pNavGrid) { m_pNavGrid = pNavGrid; } // Not owned, only read when the grid gets set up
+	void Update(const EnemyTracks& enemyTracks, const WorldInfo& world); // Once per frame, after the tracks
+	void Clear();
+
+	float GetDanger(const Elite::Vector2& position) const; // 0 when there's nothing around, 1 right on top of a single enemy
+	const Elite::Vector2& GetFlow(const Elite::Vector2& position) const; // Normalized, zero where there's no danger
+	size_t GetMovedCount() const { return m_MovedCount; } // Splats the last Update() had to redo
+
+private:
+	struct Splat
+	{
+		int CellX;
+		int CellY;
+		uint32_t Stamp; // Last Update() that saw the track
+	};
+
+	enum eLink : uint8_t
+	{
+		Right = 1 << 0,
+		Left = 1 << 1,
+		Up = 1 << 2,
+		Down = 1 << 3
+	};
+
+	struct Rect
+	{
+		int MinX;
+		int MinY;
+		int MaxX;
+		int MaxY;
+	};
+
+	void SetUpGrid(const WorldInfo& world);
+	int GetCellIdx(const Elite::Vector2& position) const; // Clamped to the grid
+	void AddSplat(int cellX, int cellY, int sign);
+	void SetUpLinks();
+	void UpdateFlow(const Rect& rect);
+	int GetNeighborDanger(int cellIdx, int neighborIdx, uint8_t link) const;
+
+	// Grid
+	vector<int32_t> m_Danger; // Sum of the kernels, m_KernelPeak being a single enemy right there
+	vector<Elite::Vector2> m_Flow;
+	vector<uint8_t> m_Links; // Per cell, which of its 4 neighbors can be walked to straight (see eLink)
+	Elite::Vector2 m_GridMin;
+	const float m_CellSize;
+	int m_Columns;
+	int m_Rows;
+
+	// Kernel, (2 * m_KernelRadius + 1) squared weights around the splat's cell
+	vector<int32_t> m_Kernel;
+	int m_KernelRadius;
+
+	unordered_map<int, Splat> m_Splats; // By EnemyHash
+	vector<Rect> m_DirtyRects; // Only reused between updates (to not reallocate)
+	uint32_t m_Stamp;
+	size_t m_MovedCount;
+
+	const NavGrid* m_pNavGrid;
+
+	const int32_t m_KernelPeak{ 1024 };
+	const int32_t m_WallDanger{ 256 }; // Added on top of a cell's own danger for the neighbors it can't get to
+};
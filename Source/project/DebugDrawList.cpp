@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "DebugDrawList.h"
+#include <IExamInterface.h>
+
+namespace
+{
+	const uint8_t g_FrameIdxMask{ 0x3 };
+}
+
+DebugDrawList::DebugDrawList()
+	: m_Frames()
+	, m_WriteIdx(0)
+	, m_ReadIdx(1)
+	, m_PublishedIdx(2)
+	, m_EnabledMask(0)
+{
+	// The influence map's a lot of cells, only on request
+	SetEnabled(eDebugDrawCategory::Steering, true);
+	SetEnabled(eDebugDrawCategory::Tracks, true);
+	SetEnabled(eDebugDrawCategory::Paths, true);
+}
+
+void DebugDrawList::SetEnabled(eDebugDrawCategory category, bool isEnabled)
+{
+	if (isEnabled)
+		m_EnabledMask.fetch_or(GetBit(category), memory_order_relaxed);
+	else
+		m_EnabledMask.fetch_and(~GetBit(category), memory_order_relaxed);
+}
+
+void DebugDrawList::AddPolygon(eDebugDrawCategory category, const Elite::Vector2* pPoints, int count, const Elite::Vector3& color, bool isSolid)
+{
+	if (IsEnabled(category) == false || count < 2)
+		return;
+
+	auto& frame = m_Frames[m_WriteIdx];
+	frame.Polygons.push_back(Polygon{ uint32_t(frame.PolygonPoints.size()), count, color, isSolid });
+	frame.PolygonPoints.insert(frame.PolygonPoints.end(), pPoints, pPoints + count);
+}
+
+void DebugDrawList::Publish()
+{
+	// Swap the filled in frame for the published one (which the consumer either drew already, or never got to)
+	m_WriteIdx = m_PublishedIdx.exchange(uint8_t(m_WriteIdx | m_FreshBit), memory_order_acq_rel) & g_FrameIdxMask;
+	m_Frames[m_WriteIdx].Clear();
+}
+
+void DebugDrawList::Draw(IExamInterface* pInterface)
+{
+	// Only take the published frame when it's a newer one, otherwise the one drawn last time is still the latest
+	if ((m_PublishedIdx.load(memory_order_acquire) & m_FreshBit) != 0)
+		m_ReadIdx = m_PublishedIdx.exchange(m_ReadIdx, memory_order_acq_rel) & g_FrameIdxMask;
+
+	const auto& frame = m_Frames[m_ReadIdx];
+	for (const auto& segment : frame.Segments)
+		pInterface->Draw_Segment(segment.From, segment.To, segment.Color);
+	for (const auto& circle : frame.Circles)
+	{
+		if (circle.IsSolid)
+			pInterface->Draw_SolidCircle(circle.Center, circle.Radius, Elite::Vector2{ 1.f, 0.f }, circle.Color);
+		else
+			pInterface->Draw_Circle(circle.Center, circle.Radius, circle.Color);
+	}
+	for (const auto& polygon : frame.Polygons)
+	{
+		const auto* pPoints = frame.PolygonPoints.data() + polygon.FirstPoint;
+		if (polygon.IsSolid)
+			pInterface->Draw_SolidPolygon(pPoints, polygon.PointCount, polygon.Color);
+		else
+			pInterface->Draw_Polygon(pPoints, polygon.PointCount, polygon.Color);
+	}
+}
+
+size_t DebugDrawList::GetPrimitiveCount() const
+{
+	const auto& frame = m_Frames[m_WriteIdx];
+	return frame.Segments.size() + frame.Circles.size() + frame.Polygons.size();
+}
+
+void DebugDrawList::Frame::Clear()
+{
+	Segments.clear();
+	Circles.clear();
+	Polygons.clear();
+	PolygonPoints.clear();
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include <atomic>
+
+class IExamInterface;
+
+enum class eDebugDrawCategory : uint8_t
+{
+	Steering, // Where the agent's heading, and its FOV
+	Tracks, // Tracked enemies, and where they're heading
+	Paths, // The route being followed, and whatever the current state's going for
+	Influence, // The influence map's cells (see InfluenceMap)
+	Count
+};
+
+// Debug visuals, gathered while the bot updates and drawn in Plugin::Render() afterwards
+// The states and subsystems append their primitives to the current frame (batched by type, so Render() goes through every type in one go),
+// and once the frame's done it's published: a triple buffer swapped through a single atomic, so neither side ever waits for the other
+// (the producer always has a frame to fill in, Render() always has the latest complete one to draw, and draws it again until there's a newer one)
+// Appending to a disabled category returns right away, whoever draws a lot should check IsEnabled() first to not even gather it
+class DebugDrawList final
+{
+public:
+	DebugDrawList();
+	~DebugDrawList() = default;
+
+	DebugDrawList(const DebugDrawList&) = delete;
+	DebugDrawList& operator=(const DebugDrawList&) = delete;
+
+	void SetEnabled(eDebugDrawCategory category, bool isEnabled);
+	bool IsEnabled(eDebugDrawCategory category) const { return (m_EnabledMask.load(memory_order_relaxed) & GetBit(category)) != 0; }
+
+	// Producer side, during UpdateSteering()
+	void AddSegment(eDebugDrawCategory category, const Elite::Vector2& from, const Elite::Vector2& to, const Elite::Vector3& color)
+	{
+		if (IsEnabled(category))
+			m_Frames[m_WriteIdx].Segments.push_back(Segment{ from, to, color });
+	}
+	void AddDirection(eDebugDrawCategory category, const Elite::Vector2& from, const Elite::Vector2& direction, float length, const Elite::Vector3& color)
+	{
+		if (IsEnabled(category) && direction != Elite::Vector2{})
+			m_Frames[m_WriteIdx].Segments.push_back(Segment{ from, from + direction.GetNormalized() * length, color });
+	}
+	void AddCircle(eDebugDrawCategory category, const Elite::Vector2& center, float radius, const Elite::Vector3& color, bool isSolid = false)
+	{
+		if (IsEnabled(category))
+			m_Frames[m_WriteIdx].Circles.push_back(Circle{ center, radius, color, isSolid });
+	}
+	void AddPolygon(eDebugDrawCategory category, const Elite::Vector2* pPoints, int count, const Elite::Vector3& color, bool isSolid = false);
+	void Publish(); // Hands the frame over to Render(), and starts on the next one
+
+	// Consumer side, during Render()
+	void Draw(IExamInterface* pInterface);
+
+	size_t GetPrimitiveCount() const; // In the frame being filled in
+
+private:
+	struct Segment
+	{
+		Elite::Vector2 From;
+		Elite::Vector2 To;
+		Elite::Vector3 Color;
+	};
+
+	struct Circle
+	{
+		Elite::Vector2 Center;
+		float Radius;
+		Elite::Vector3 Color;
+		bool IsSolid;
+	};
+
+	struct Polygon
+	{
+		uint32_t FirstPoint; // In Frame::PolygonPoints
+		int PointCount;
+		Elite::Vector3 Color;
+		bool IsSolid;
+	};
+
+	// The vectors are only cleared between frames (never shrunk), so after the first few frames appending doesn't allocate
+	struct Frame
+	{
+		vector<Segment> Segments;
+		vector<Circle> Circles;
+		vector<Polygon> Polygons;
+		vector<Elite::Vector2> PolygonPoints;
+
+		void Clear();
+	};
+
+	static uint32_t GetBit(eDebugDrawCategory category) { return 1u << uint32_t(category); }
+
+	Frame m_Frames[3];
+	uint8_t m_WriteIdx; // Only touched by the producer
+	uint8_t m_ReadIdx; // Only touched by the consumer
+	atomic<uint8_t> m_PublishedIdx; // The third frame, with m_FreshBit set while the consumer hasn't taken it yet
+	atomic<uint32_t> m_EnabledMask;
+
+	static const uint8_t m_FreshBit{ 1 << 7 };
+};
@@ -0,0 +1,302 @@
+#include "stdafx.h"
+#include "EnemyTracks.h"
+#include "Perception.h"
+#include "EventLog.h"
+#include "DebugDrawList.h"
+
+namespace
+{
+	const uint32_t g_EmptySlot{ UINT32_MAX };
+}
+
+EnemyTracks::EnemyTracks(float forgetAfter, float forgetDistance, float lookAhead)
+	: m_Slots()
+	, m_SlotMask(0)
+	, m_SlotBits(0)
+	, m_AddedCount(0)
+	, m_LastUpdateTime(0.f)
+	, m_ForgetAfter(forgetAfter)
+	, m_ForgetDistance(forgetDistance)
+	, m_LookAhead(lookAhead)
+	, m_pEventLog(nullptr)
+	, m_pEvents(nullptr)
+{
+	m_SlotBits = m_InitialSlotBits;
+	m_Slots.assign(size_t(1) << m_SlotBits, g_EmptySlot);
+	m_SlotMask = uint32_t(m_Slots.size() - 1);
+
+	const auto reserved = m_Slots.size() / 2;
+	m_Hashes.reserve(reserved);
+	m_Positions.Reserve(reserved);
+	m_Velocities.reserve(reserved);
+	m_LastSeenTimes.reserve(reserved);
+	for (auto* pFilterValues : { &m_FilterX, &m_FilterY, &m_FilterVelX, &m_FilterVelY, &m_PositionVariances, &m_Covariances, &m_VelocityVariances, &m_TimesToReachAgent })
+		pFilterValues->reserve(reserved);
+	m_PredictedPositions.Reserve(reserved);
+}
+
+void EnemyTracks::Update(const Perception& perception)
+{
+	const auto time = perception.GetStats().TimeSurvived;
+	const auto& agentPosition = perception.GetAgentInfo().Position;
+
+	// Refresh (or start) the track of every enemy in the FOV
+	m_AddedCount = 0;
+	for (const auto& enemy : perception.GetEnemies())
+	{
+		const auto slot = FindSlot(enemy.EnemyHash);
+		uint32_t trackIdx = 0;
+		if (slot == g_EmptySlot)
+		{
+			trackIdx = Add(enemy.EnemyHash);
+			++m_AddedCount;
+			LOG_EVENT(EVENT_LOG_VERBOSE, m_pEventLog, eLogEvent::EnemyTracked, "EnemyTracks", enemy.EnemyHash);
+			if (m_pEvents)
+				m_pEvents->Push(EnemyFirstSeenEvent{ enemy.EnemyHash, enemy.Location });
+		}
+		else
+			trackIdx = m_Slots[slot];
+
+		m_Positions.Set(trackIdx, enemy.Location);
+		m_Velocities[trackIdx] = enemy.LinearVelocity;
+		m_LastSeenTimes[trackIdx] = time;
+
+		// A new track's filter starts off right where it was seen, as (un)certain as the measurement
+		if (slot == g_EmptySlot)
+		{
+			m_FilterX[trackIdx] = enemy.Location.x;
+			m_FilterY[trackIdx] = enemy.Location.y;
+			m_FilterVelX[trackIdx] = enemy.LinearVelocity.x;
+			m_FilterVelY[trackIdx] = enemy.LinearVelocity.y;
+			m_PositionVariances[trackIdx] = m_PositionNoise;
+			m_Covariances[trackIdx] = 0.f;
+			m_VelocityVariances[trackIdx] = m_VelocityNoise;
+		}
+	}
+
+	// Forget the ones that haven't been seen for too long, or were last seen too far away
+	const auto forgetDistanceSquared = m_ForgetDistance * m_ForgetDistance;
+	for (uint32_t trackIdx = 0; trackIdx < uint32_t(m_Hashes.size());)
+	{
+		if (time - m_LastSeenTimes[trackIdx] > m_ForgetAfter || m_Positions[trackIdx].DistanceSquared(agentPosition) > forgetDistanceSquared)
+		{
+			LOG_EVENT(EVENT_LOG_VERBOSE, m_pEventLog, eLogEvent::EnemyUntracked, "EnemyTracks", m_Hashes[trackIdx]);
+			if (m_pEvents)
+				m_pEvents->Push(EnemyLostEvent{ m_Hashes[trackIdx], m_Positions[trackIdx] });
+			Remove(trackIdx); // The last track moves into this index, so don't advance
+		}
+		else
+			++trackIdx;
+	}
+
+	UpdateFilters(time, max(0.f, time - m_LastUpdateTime), agentPosition);
+	m_LastUpdateTime = time;
+}
+
+void EnemyTracks::Clear()
+{
+	fill(m_Slots.begin(), m_Slots.end(), g_EmptySlot);
+	m_Hashes.clear();
+	m_Positions.Clear();
+	m_Velocities.clear();
+	m_LastSeenTimes.clear();
+	for (auto* pFilterValues : { &m_FilterX, &m_FilterY, &m_FilterVelX, &m_FilterVelY, &m_PositionVariances, &m_Covariances, &m_VelocityVariances, &m_TimesToReachAgent })
+		pFilterValues->clear();
+	m_PredictedPositions.Clear();
+	m_AddedCount = 0;
+}
+
+void EnemyTracks::DebugDraw(DebugDrawList& drawList) const
+{
+	if (drawList.IsEnabled(eDebugDrawCategory::Tracks) == false)
+		return;
+
+	// Where every enemy was last seen, and where it was heading then (a second's worth)
+	// And where its filter thinks it is now (as big as it's uncertain), and will be in a look ahead
+	for (size_t trackIdx = 0; trackIdx < m_Hashes.size(); ++trackIdx)
+	{
+		const auto position = m_Positions[trackIdx];
+		drawList.AddCircle(eDebugDrawCategory::Tracks, position, 1.f, { 1, 0, 0 });
+		drawList.AddSegment(eDebugDrawCategory::Tracks, position, position + m_Velocities[trackIdx], { 1, 0, 0 });
+
+		const auto filteredPosition = PredictPosition(int(trackIdx), 0.f);
+		drawList.AddCircle(eDebugDrawCategory::Tracks, filteredPosition, 1.f + sqrtf(m_PositionVariances[trackIdx]), { 1, 0.5f, 0 });
+		drawList.AddSegment(eDebugDrawCategory::Tracks, filteredPosition, m_PredictedPositions[trackIdx], { 1, 0.5f, 0 });
+	}
+}
+
+Elite::Vector2 EnemyTracks::PredictPosition(int trackIdx, float time) const
+{
+	return Elite::Vector2{ m_FilterX[trackIdx] + m_FilterVelX[trackIdx] * time, m_FilterY[trackIdx] + m_FilterVelY[trackIdx] * time };
+}
+
+int EnemyTracks::Find(int enemyHash) const
+{
+	const auto slot = FindSlot(enemyHash);
+	return slot == g_EmptySlot ? -1 : int(m_Slots[slot]);
+}
+
+uint32_t EnemyTracks::GetHomeSlot(int enemyHash) const
+{
+	// Fibonacci hashing, the game hands out hashes sequentially so they need spreading out
+	return (uint32_t(enemyHash) * 2654435769u) >> (32 - m_SlotBits);
+}
+
+uint32_t EnemyTracks::FindSlot(int enemyHash) const
+{
+	for (auto slot = GetHomeSlot(enemyHash);; slot = (slot + 1) & m_SlotMask)
+	{
+		const auto trackIdx = m_Slots[slot];
+		if (trackIdx == g_EmptySlot)
+			return g_EmptySlot;
+		if (m_Hashes[trackIdx] == enemyHash)
+			return slot;
+	}
+}
+
+uint32_t EnemyTracks::Add(int enemyHash)
+{
+	if ((m_Hashes.size() + 1) * 2 > m_Slots.size())
+		Grow();
+
+	const auto trackIdx = uint32_t(m_Hashes.size());
+	m_Hashes.push_back(enemyHash);
+	m_Positions.PushBack(Elite::ZeroVector2);
+	m_Velocities.push_back(Elite::ZeroVector2);
+	m_LastSeenTimes.push_back(0.f);
+	for (auto* pFilterValues : { &m_FilterX, &m_FilterY, &m_FilterVelX, &m_FilterVelY, &m_PositionVariances, &m_Covariances, &m_VelocityVariances, &m_TimesToReachAgent })
+		pFilterValues->push_back(0.f);
+	m_PredictedPositions.PushBack(Elite::ZeroVector2);
+
+	auto slot = GetHomeSlot(enemyHash);
+	while (m_Slots[slot] != g_EmptySlot)
+		slot = (slot + 1) & m_SlotMask;
+	m_Slots[slot] = trackIdx;
+
+	return trackIdx;
+}
+
+void EnemyTracks::Remove(uint32_t trackIdx)
+{
+	// Empty the track's slot, shifting back the entries after it that would otherwise become unreachable
+	auto emptySlot = FindSlot(m_Hashes[trackIdx]);
+	for (auto slot = (emptySlot + 1) & m_SlotMask; m_Slots[slot] != g_EmptySlot; slot = (slot + 1) & m_SlotMask)
+	{
+		// Only entries whose home slot isn't cyclically in (emptySlot, slot] can move back
+		const auto homeSlot = GetHomeSlot(m_Hashes[m_Slots[slot]]);
+		if (((slot - homeSlot) & m_SlotMask) >= ((slot - emptySlot) & m_SlotMask))
+		{
+			m_Slots[emptySlot] = m_Slots[slot];
+			emptySlot = slot;
+		}
+	}
+	m_Slots[emptySlot] = g_EmptySlot;
+
+	// Move the last track into the hole
+	const auto lastIdx = uint32_t(m_Hashes.size() - 1);
+	if (trackIdx != lastIdx)
+	{
+		m_Slots[FindSlot(m_Hashes[lastIdx])] = trackIdx;
+		m_Hashes[trackIdx] = m_Hashes[lastIdx];
+		m_Positions.Set(trackIdx, m_Positions[lastIdx]);
+		m_Velocities[trackIdx] = m_Velocities[lastIdx];
+		m_LastSeenTimes[trackIdx] = m_LastSeenTimes[lastIdx];
+		for (auto* pFilterValues : { &m_FilterX, &m_FilterY, &m_FilterVelX, &m_FilterVelY, &m_PositionVariances, &m_Covariances, &m_VelocityVariances, &m_TimesToReachAgent })
+			(*pFilterValues)[trackIdx] = (*pFilterValues)[lastIdx];
+		m_PredictedPositions.Set(trackIdx, m_PredictedPositions[lastIdx]);
+	}
+
+	m_Hashes.pop_back();
+	m_Positions.PopBack();
+	m_Velocities.pop_back();
+	m_LastSeenTimes.pop_back();
+	for (auto* pFilterValues : { &m_FilterX, &m_FilterY, &m_FilterVelX, &m_FilterVelY, &m_PositionVariances, &m_Covariances, &m_VelocityVariances, &m_TimesToReachAgent })
+		pFilterValues->pop_back();
+	m_PredictedPositions.PopBack();
+}
+
+void EnemyTracks::Grow()
+{
+	++m_SlotBits;
+	m_Slots.assign(size_t(1) << m_SlotBits, g_EmptySlot);
+	m_SlotMask = uint32_t(m_Slots.size() - 1);
+
+	for (uint32_t trackIdx = 0; trackIdx < uint32_t(m_Hashes.size()); ++trackIdx)
+	{
+		auto slot = GetHomeSlot(m_Hashes[trackIdx]);
+		while (m_Slots[slot] != g_EmptySlot)
+			slot = (slot + 1) & m_SlotMask;
+		m_Slots[slot] = trackIdx;
+	}
+}
+
+void EnemyTracks::UpdateFilters(float time, float deltaTime, const Elite::Vector2& agentPosition)
+{
+	const auto trackCount = m_Hashes.size();
+	const auto* pMeasuredX = m_Positions.GetX();
+	const auto* pMeasuredY = m_Positions.GetY();
+
+	// Process noise over the time step, of white noise acceleration
+	const auto dt2 = deltaTime * deltaTime;
+	const auto positionProcessNoise = m_AccelerationNoise * dt2 * deltaTime / 3.f;
+	const auto covarianceProcessNoise = m_AccelerationNoise * dt2 / 2.f;
+	const auto velocityProcessNoise = m_AccelerationNoise * deltaTime;
+
+	for (size_t i = 0; i < trackCount; ++i)
+	{
+		// Predict up to now (a track that's been out of the FOV for too long stays put, only ever less certain)
+		const auto moveTime = time - m_LastSeenTimes[i] <= m_MaxCoastTime ? deltaTime : 0.f;
+		auto x = m_FilterX[i] + m_FilterVelX[i] * moveTime;
+		auto y = m_FilterY[i] + m_FilterVelY[i] * moveTime;
+		auto velX = m_FilterVelX[i];
+		auto velY = m_FilterVelY[i];
+		auto positionVariance = m_PositionVariances[i] + 2.f * deltaTime * m_Covariances[i] + dt2 * m_VelocityVariances[i] + positionProcessNoise;
+		auto covariance = m_Covariances[i] + deltaTime * m_VelocityVariances[i] + covarianceProcessNoise;
+		auto velocityVariance = m_VelocityVariances[i] + velocityProcessNoise;
+
+		// Correct with this frame's measurement, both the position and the velocity are measured (so the innovation's covariance is 2x2)
+		if (m_LastSeenTimes[i] == time)
+		{
+			const auto innovationPosition = positionVariance + m_PositionNoise;
+			const auto innovationVelocity = velocityVariance + m_VelocityNoise;
+			const auto inverseDeterminant = 1.f / (innovationPosition * innovationVelocity - covariance * covariance);
+
+			// Kalman gain, the covariance times the innovation's inverse
+			const auto gainPP = (positionVariance * innovationVelocity - covariance * covariance) * inverseDeterminant;
+			const auto gainPV = (covariance * innovationPosition - positionVariance * covariance) * inverseDeterminant;
+			const auto gainVP = (covariance * innovationVelocity - velocityVariance * covariance) * inverseDeterminant;
+			const auto gainVV = (velocityVariance * innovationPosition - covariance * covariance) * inverseDeterminant;
+
+			const auto residualX = pMeasuredX[i] - x;
+			const auto residualY = pMeasuredY[i] - y;
+			const auto residualVelX = m_Velocities[i].x - velX;
+			const auto residualVelY = m_Velocities[i].y - velY;
+			x += gainPP * residualX + gainPV * residualVelX;
+			y += gainPP * residualY + gainPV * residualVelY;
+			velX += gainVP * residualX + gainVV * residualVelX;
+			velY += gainVP * residualY + gainVV * residualVelY;
+
+			const auto correctedPositionVariance = (1.f - gainPP) * positionVariance - gainPV * covariance;
+			const auto correctedCovariance = (1.f - gainPP) * covariance - gainPV * velocityVariance;
+			velocityVariance = (1.f - gainVV) * velocityVariance - gainVP * covariance;
+			positionVariance = correctedPositionVariance;
+			covariance = correctedCovariance;
+		}
+
+		m_FilterX[i] = x;
+		m_FilterY[i] = y;
+		m_FilterVelX[i] = velX;
+		m_FilterVelY[i] = velY;
+		m_PositionVariances[i] = positionVariance;
+		m_Covariances[i] = covariance;
+		m_VelocityVariances[i] = velocityVariance;
+
+		// Where it'll be shortly, and how long it'd take to get to the agent at the speed it's closing in with
+		m_PredictedPositions.Set(i, Elite::Vector2{ x + velX * m_LookAhead, y + velY * m_LookAhead });
+		const auto toAgentX = agentPosition.x - x;
+		const auto toAgentY = agentPosition.y - y;
+		const auto distance = sqrtf(toAgentX * toAgentX + toAgentY * toAgentY);
+		const auto closingSpeed = distance > 0.f ? (velX * toAgentX + velY * toAgentY) / distance : 0.f;
+		m_TimesToReachAgent[i] = distance == 0.f ? 0.f : closingSpeed > m_MinClosingSpeed ? distance / closingSpeed : FLT_MAX;
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include "GameEvents.h"
+
+class Perception;
+class EventLog;
+class DebugDrawList;
+
+// Every enemy the agent has seen recently, keyed by EnemyHash, kept across frames and state changes
+// Tracks live in parallel arrays (hash, last known position and velocity, when it was last seen), indexed by an
+// open-addressing hash table (linear probing), so updating it with a frame's enemies is O(n) and allocation free once grown
+// Enemies that haven't been seen for a while, or whose last known position is far away, are forgotten
+// Every track also runs a constant velocity Kalman filter (per axis, both axes sharing the covariance since they're measured the same way),
+// all of them in one pass over the arrays per Update(): predicted up to now, then corrected with what was seen this frame, if anything
+// Out of the FOV a track keeps coasting for a while (ever less certain of where it is). That same pass answers, for every track at once,
+// where it'll be shortly and how soon it could reach the agent, so whoever needs it (aiming, the danger field, fleeing) just reads it
+class EnemyTracks final
+{
+public:
+	explicit EnemyTracks(float forgetAfter = 10.f, float forgetDistance = 100.f, float lookAhead = 0.25f);
+	~EnemyTracks() = default;
+
+	void Update(const Perception& perception); // Once per frame, after the perception got refreshed
+	void Clear();
+	void SetEventLog(EventLog* pEventLog) { m_pEventLog = pEventLog; }
+	void SetEventQueue(GameEventQueue* pEvents) { m_pEvents = pEvents; } // Can be null, raises every track it starts and forgets
+	void DebugDraw(DebugDrawList& drawList) const;
+
+	size_t GetCount() const { return m_Hashes.size(); }
+	size_t GetAddedCount() const { return m_AddedCount; } // Tracks that got added by the last Update()
+	int Find(int enemyHash) const; // Index of the enemy's track, -1 if it isn't tracked
+
+	// Indexed by track, in no particular order (forgetting a track moves the last one in its place)
+	const vector<int>& GetHashes() const { return m_Hashes; }
+	const Elite::Vector2SoA& GetPositions() const { return m_Positions; } // Last known ones
+	const vector<Elite::Vector2>& GetVelocities() const { return m_Velocities; }
+	const vector<float>& GetLastSeenTimes() const { return m_LastSeenTimes; } // In TimeSurvived
+
+	// Filtered, also indexed by track (as of the last Update())
+	Elite::Vector2 PredictPosition(int trackIdx, float time) const; // That many seconds from now, the filtered position for 0
+	Elite::Vector2 GetFilteredVelocity(int trackIdx) const { return Elite::Vector2{ m_FilterVelX[trackIdx], m_FilterVelY[trackIdx] }; }
+	float GetPositionVariance(int trackIdx) const { return m_PositionVariances[trackIdx]; } // Per axis, in m²
+	const Elite::Vector2SoA& GetPredictedPositions() const { return m_PredictedPositions; } // The look ahead from now
+	const vector<float>& GetTimesToReachAgent() const { return m_TimesToReachAgent; } // Going straight at it, FLT_MAX when not closing in
+	float GetLookAhead() const { return m_LookAhead; }
+
+private:
+	uint32_t GetHomeSlot(int enemyHash) const;
+	uint32_t FindSlot(int enemyHash) const; // UINT32_MAX if it isn't tracked
+	uint32_t Add(int enemyHash);
+	void Remove(uint32_t trackIdx);
+	void Grow();
+	void UpdateFilters(float time, float deltaTime, const Elite::Vector2& agentPosition);
+
+	// Hash table, every slot holds a track index (or UINT32_MAX when empty), kept at most half full
+	vector<uint32_t> m_Slots;
+	uint32_t m_SlotMask;
+	int m_SlotBits;
+
+	// Tracks
+	vector<int> m_Hashes;
+	Elite::Vector2SoA m_Positions;
+	vector<Elite::Vector2> m_Velocities;
+	vector<float> m_LastSeenTimes;
+
+	// Filters, the state of both axes and the covariance they share
+	vector<float> m_FilterX;
+	vector<float> m_FilterY;
+	vector<float> m_FilterVelX;
+	vector<float> m_FilterVelY;
+	vector<float> m_PositionVariances;
+	vector<float> m_Covariances; // Between position and velocity
+	vector<float> m_VelocityVariances;
+
+	// Answers of the last Update()
+	Elite::Vector2SoA m_PredictedPositions;
+	vector<float> m_TimesToReachAgent;
+
+	size_t m_AddedCount;
+	float m_LastUpdateTime;
+	const float m_ForgetAfter;
+	const float m_ForgetDistance;
+	const float m_LookAhead;
+	EventLog* m_pEventLog;
+	GameEventQueue* m_pEvents;
+
+	const int m_InitialSlotBits{ 6 };
+
+	// Filter tuning, the game reports positions and velocities exactly, what's uncertain is where the zombies are going next
+	const float m_PositionNoise{ 0.01f }; // Variances of the measurements, in m² and (m/s)²
+	const float m_VelocityNoise{ 0.25f };
+	const float m_AccelerationNoise{ 4.f }; // Spectral density of the (white noise) acceleration, in m²/s³
+	const float m_MaxCoastTime{ 1.f }; // How long a track out of the FOV keeps moving along, after that it's left where it was
+	const float m_MinClosingSpeed{ 0.1f }; // In m/s, anything slower isn't coming for the agent
+};
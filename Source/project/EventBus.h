@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Queued, typed events between the bot's subsystems: whoever raises one pushes it into an EventQueue (without knowing who's interested),
+// and an EventDispatcher hands everything that piled up to its subscribers in one go, once per frame
+// Every event type gets its own fixed size buffer (no allocations, no type erasure), an event that doesn't fit anymore is dropped (and counted)
+// The subscribers are a type list as well: every subscriber gets every event it has an OnEvent() overload for (found at compile time),
+// called directly instead of through a vtable (an event type nobody subscribed to is just cleared)
+
+// The events of one type pushed since the last dispatch, in the order they were pushed
+template<typename TEvent, size_t Capacity>
+struct EventBuffer
+{
+	TEvent Events[Capacity];
+	size_t Count;
+};
+
+template<size_t Capacity, typename... TEvents>
+class EventQueue final
+{
+public:
+	static const size_t EventCapacity = Capacity; // Per type
+
+	EventQueue() : m_Buffers(), m_DroppedCount(0) {}
+	~EventQueue() = default;
+
+	EventQueue(const EventQueue&) = delete;
+	EventQueue& operator=(const EventQueue&) = delete;
+
+	template<typename TEvent>
+	bool Push(const TEvent& event)
+	{
+		auto& buffer = GetBuffer<TEvent>();
+		if (buffer.Count == Capacity)
+		{
+			++m_DroppedCount;
+			return false;
+		}
+		buffer.Events[buffer.Count++] = event;
+		return true;
+	}
+
+	template<typename TEvent>
+	size_t GetCount() const { return get<EventBuffer<TEvent, Capacity>>(m_Buffers).Count; }
+	uint64_t GetDroppedCount() const { return m_DroppedCount; } // Over the whole run
+	void Clear()
+	{
+		using Expand = int[];
+		(void)Expand{ 0, (GetBuffer<TEvents>().Count = 0, 0)... };
+	}
+
+	// Hands every type's events to the visitor (visitor(pEvents, count), types in the queue's order) and takes them out
+	// Events pushed while visiting (by a subscriber reacting to one) stay queued for the next time
+	template<typename Visitor>
+	void Drain(Visitor&& visitor)
+	{
+		using Expand = int[];
+		(void)Expand{ 0, (Drain<TEvents>(visitor), 0)... };
+	}
+
+private:
+	static_assert(sizeof...(TEvents) > 0, "A queue without events");
+	static_assert(Capacity > 0, "A queue without room");
+
+	template<typename TEvent>
+	EventBuffer<TEvent, Capacity>& GetBuffer() { return get<EventBuffer<TEvent, Capacity>>(m_Buffers); }
+
+	template<typename TEvent, typename Visitor>
+	void Drain(Visitor& visitor)
+	{
+		auto& buffer = GetBuffer<TEvent>();
+		const auto count = buffer.Count;
+		if (count == 0)
+			return;
+
+		visitor(static_cast<const TEvent*>(buffer.Events), count);
+		for (size_t i = count; i < buffer.Count; ++i)
+			buffer.Events[i - count] = buffer.Events[i];
+		buffer.Count -= count;
+	}
+
+	tuple<EventBuffer<TEvents, Capacity>...> m_Buffers;
+	uint64_t m_DroppedCount;
+};
+
+// Whether a subscriber has an OnEvent() for that event
+template<typename TSubscriber, typename TEvent, typename = void>
+struct IsEventSubscriber : false_type {};
+template<typename TSubscriber, typename TEvent>
+struct IsEventSubscriber<TSubscriber, TEvent, decltype(declval<TSubscriber&>().OnEvent(declval<const TEvent&>()), void())> : true_type {};
+
+template<typename TQueue, typename... TSubscribers>
+class EventDispatcher final
+{
+public:
+	using Subscribers = tuple<TSubscribers*...>;
+
+	// None of them can be null, and all of them have to outlive the dispatcher (or at least its last Dispatch())
+	explicit EventDispatcher(TQueue* pQueue, TSubscribers*... pSubscribers) : m_pQueue(pQueue), m_Subscribers(pSubscribers...) {}
+	~EventDispatcher() = default;
+
+	// Every event queued since the last time, every type in turn, every event to all of its subscribers (in the list's order)
+	void Dispatch()
+	{
+		m_pQueue->Drain([this](const auto* pEvents, size_t count) { this->DeliverAll(pEvents, count, index_sequence_for<TSubscribers...>{}); });
+	}
+
+private:
+	template<typename TEvent, size_t... SubscriberIndices>
+	void DeliverAll(const TEvent* pEvents, size_t count, index_sequence<SubscriberIndices...>)
+	{
+		using Expand = int[];
+		for (size_t i = 0; i < count; ++i)
+			(void)Expand{ 0, (DeliverTo<SubscriberIndices>(pEvents[i], IsEventSubscriber<TSubscribers, TEvent>{}), 0)... };
+	}
+
+	template<size_t SubscriberIdx, typename TEvent>
+	void DeliverTo(const TEvent& event, true_type) { get<SubscriberIdx>(m_Subscribers)->OnEvent(event); }
+	template<size_t SubscriberIdx, typename TEvent>
+	void DeliverTo(const TEvent& event, false_type) {}
+
+	TQueue* m_pQueue;
+	Subscribers m_Subscribers;
+};
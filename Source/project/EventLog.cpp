@@ -0,0 +1,122 @@
+#include "stdafx.h"
+#include "EventLog.h"
+#include <iomanip>
+
+EventLog::EventLog(size_t capacity)
+	: m_Events()
+	, m_Mask(0)
+	, m_StartTime(chrono::steady_clock::now())
+	, m_WriteIdx(0)
+	, m_ReadIdx(0)
+	, m_DroppedCount(0)
+	, m_StopDumping(false)
+{
+	// Nothing to store when logging is compiled out
+	if (EVENT_LOG_LEVEL == EVENT_LOG_OFF)
+		return;
+
+	size_t powerOfTwo = 1;
+	while (powerOfTwo < capacity)
+		powerOfTwo <<= 1;
+
+	m_Events.resize(powerOfTwo);
+	m_Mask = powerOfTwo - 1;
+}
+
+EventLog::~EventLog()
+{
+	StopBackgroundDump();
+}
+
+bool EventLog::Push(eLogEvent type, const char* pName, int value)
+{
+	const auto writeIdx = m_WriteIdx.load(memory_order_relaxed);
+	const auto readIdx = m_ReadIdx.load(memory_order_acquire);
+	if (writeIdx - readIdx >= m_Events.size())
+	{
+		m_DroppedCount.fetch_add(1, memory_order_relaxed);
+		return false;
+	}
+
+	const auto timestamp = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - m_StartTime).count();
+	m_Events[writeIdx & m_Mask] = LogEvent{ uint64_t(timestamp), pName, value, type };
+	m_WriteIdx.store(writeIdx + 1, memory_order_release); // Publishes the event to the consumer
+	return true;
+}
+
+size_t EventLog::Drain(const function<void(const LogEvent&)>& consume)
+{
+	auto readIdx = m_ReadIdx.load(memory_order_relaxed);
+	const auto writeIdx = m_WriteIdx.load(memory_order_acquire);
+
+	const auto nrOfEvents = size_t(writeIdx - readIdx);
+	for (; readIdx != writeIdx; ++readIdx)
+		consume(m_Events[readIdx & m_Mask]);
+
+	m_ReadIdx.store(readIdx, memory_order_release); // Hands the slots back to the producer
+	return nrOfEvents;
+}
+
+size_t EventLog::Dump(ostream& stream)
+{
+	const auto nrOfEvents = Drain([&stream](const LogEvent& event)
+		{
+			stream << fixed << setprecision(6) << double(event.Timestamp) / 1e9 << " s\t" << ToString(event.Type) << '\t'
+				<< (event.pName ? event.pName : "") << '\t' << event.Value << '\n';
+		});
+
+	return nrOfEvents;
+}
+
+void EventLog::StartBackgroundDump(const string& filePath, chrono::milliseconds interval)
+{
+	if (EVENT_LOG_LEVEL == EVENT_LOG_OFF || m_DumpThread.joinable())
+		return;
+
+	m_StopDumping = false;
+	m_DumpThread = thread([this, filePath, interval]()
+		{
+			ofstream file(filePath);
+			if (!file)
+				return;
+
+			unique_lock<mutex> lock(m_DumpMutex);
+			while (m_StopDumping == false)
+			{
+				m_DumpCondition.wait_for(lock, interval, [this]() { return m_StopDumping; });
+				Dump(file);
+			}
+
+			if (GetDroppedCount() > 0)
+				file << GetDroppedCount() << " events were dropped (the log was full)\n";
+		});
+}
+
+void EventLog::StopBackgroundDump()
+{
+	if (m_DumpThread.joinable() == false)
+		return;
+
+	{
+		lock_guard<mutex> lock(m_DumpMutex);
+		m_StopDumping = true;
+	}
+	m_DumpCondition.notify_one();
+	m_DumpThread.join();
+}
+
+const char* EventLog::ToString(eLogEvent type)
+{
+	switch (type)
+	{
+	case eLogEvent::StateEntered: return "StateEntered";
+	case eLogEvent::StateExited: return "StateExited";
+	case eLogEvent::EnemyTracked: return "EnemyTracked";
+	case eLogEvent::EnemyUntracked: return "EnemyUntracked";
+	case eLogEvent::HouseRansacked: return "HouseRansacked";
+	case eLogEvent::HouseForgotten: return "HouseForgotten";
+	case eLogEvent::HouseEntered: return "HouseEntered";
+	case eLogEvent::BudgetOverrun: return "BudgetOverrun";
+	}
+	return "Unknown";
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Compile-time log levels (define EVENT_LOG_LEVEL project-wide to override the default)
+// Everything above the chosen level compiles away, so a release build doesn't pay for the log at all
+#define EVENT_LOG_OFF 0
+#define EVENT_LOG_STATES 1 // State enters/exits
+#define EVENT_LOG_VERBOSE 2 // Also every enemy that gets tracked or untracked, and every house that gets ransacked or forgotten
+
+#ifndef EVENT_LOG_LEVEL
+#ifdef _DEBUG
+#define EVENT_LOG_LEVEL EVENT_LOG_VERBOSE
+#else
+#define EVENT_LOG_LEVEL EVENT_LOG_OFF
+#endif
+#endif
+
+// Logs an event if the level is compiled in (and there's a log to write it to)
+#define LOG_EVENT(level, pEventLog, type, pName, value) \
+	do { if ((level) <= EVENT_LOG_LEVEL && (pEventLog)) (pEventLog)->Push((type), (pName), (value)); } while (false)
+
+enum class eLogEvent : uint8_t
+{
+	StateEntered, // Name: the state's type, Value: unused
+	StateExited, // Same
+	EnemyTracked, // Name: who's tracking, Value: the enemy's hash
+	EnemyUntracked, // Same
+	HouseRansacked, // Name: "HouseMemory", Value: the house's index in it
+	HouseForgotten, // Same (its ransack expired)
+	HouseEntered, // Same (the agent walked into it)
+	BudgetOverrun // Name: the state or transition's type, Value: how long it took, in microseconds
+};
+
+struct LogEvent
+{
+	uint64_t Timestamp; // Nanoseconds since the log was created
+	const char* pName; // Has to outlive the log (string literals and type names)
+	int Value;
+	eLogEvent Type;
+};
+
+// Lock-free single producer, single consumer ring buffer of events
+// The bot pushes while it updates, and a single consumer (the background dump, or whoever calls Drain()) gets them in order
+// When it's full new events are dropped (and counted), pushing never blocks nor allocates
+class EventLog final
+{
+public:
+	explicit EventLog(size_t capacity = 4096); // Rounded up to a power of two
+	~EventLog();
+
+	EventLog(const EventLog&) = delete;
+	EventLog& operator=(const EventLog&) = delete;
+
+	bool Push(eLogEvent type, const char* pName, int value = 0); // Producer side
+	size_t Drain(const function<void(const LogEvent&)>& consume); // Consumer side, returns the amount of drained events
+	size_t Dump(ostream& stream); // Drains everything as text
+
+	// Periodically dumps the log into a file (overwriting it) from a background thread, until stopped
+	// Nothing gets started when logging is compiled out
+	void StartBackgroundDump(const string& filePath, chrono::milliseconds interval = chrono::milliseconds(100));
+	void StopBackgroundDump(); // Also dumps whatever was still left
+
+	uint64_t GetDroppedCount() const { return m_DroppedCount.load(memory_order_relaxed); }
+	static const char* ToString(eLogEvent type);
+
+private:
+	vector<LogEvent> m_Events;
+	size_t m_Mask;
+	chrono::steady_clock::time_point m_StartTime;
+
+	// Padded apart, since each index is written by a different thread
+	atomic<uint64_t> m_WriteIdx;
+	char m_WriteIdxPadding[64 - sizeof(atomic<uint64_t>)];
+	atomic<uint64_t> m_ReadIdx;
+	char m_ReadIdxPadding[64 - sizeof(atomic<uint64_t>)];
+	atomic<uint64_t> m_DroppedCount;
+
+	// Background dump
+	thread m_DumpThread;
+	mutex m_DumpMutex;
+	condition_variable m_DumpCondition;
+	bool m_StopDumping;
+};
@@ -0,0 +1,81 @@
+#include "stdafx.h"
+#include "FSMArena.h"
+
+FSMArena::FSMArena(size_t blockSize)
+	: m_Blocks()
+	, m_Destructors()
+	, m_BlockSize(max(blockSize, size_t(256)))
+	, m_pNext(nullptr)
+	, m_pBlockEnd(nullptr)
+	, m_UsedBytes(0)
+{
+}
+
+FSMArena::FSMArena(FSMArena&& other) noexcept
+	: m_Blocks(move(other.m_Blocks))
+	, m_Destructors(move(other.m_Destructors))
+	, m_BlockSize(other.m_BlockSize)
+	, m_pNext(other.m_pNext)
+	, m_pBlockEnd(other.m_pBlockEnd)
+	, m_UsedBytes(other.m_UsedBytes)
+{
+	other.m_Blocks.clear();
+	other.m_Destructors.clear();
+	other.m_pNext = other.m_pBlockEnd = nullptr;
+	other.m_UsedBytes = 0;
+}
+
+FSMArena& FSMArena::operator=(FSMArena&& other) noexcept
+{
+	if (this != &other)
+	{
+		Release();
+		m_Blocks = move(other.m_Blocks);
+		m_Destructors = move(other.m_Destructors);
+		m_BlockSize = other.m_BlockSize;
+		m_pNext = other.m_pNext;
+		m_pBlockEnd = other.m_pBlockEnd;
+		m_UsedBytes = other.m_UsedBytes;
+
+		other.m_Blocks.clear();
+		other.m_Destructors.clear();
+		other.m_pNext = other.m_pBlockEnd = nullptr;
+		other.m_UsedBytes = 0;
+	}
+	return *this;
+}
+
+void FSMArena::Release()
+{
+	// Newest first, whatever got created later can still point at what was there before it
+	for (auto it = m_Destructors.rbegin(); it != m_Destructors.rend(); ++it)
+		it->pDestroy(it->pObject);
+
+	m_Destructors.clear();
+	m_Blocks.clear();
+	m_pNext = m_pBlockEnd = nullptr;
+	m_UsedBytes = 0;
+}
+
+void* FSMArena::Allocate(size_t size, size_t alignment)
+{
+	const auto getAligned = [alignment](uint8_t* pAddress)
+	{
+		return reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(pAddress) + alignment - 1) & ~uintptr_t(alignment - 1));
+	};
+
+	auto* pObject = m_pNext ? getAligned(m_pNext) : nullptr;
+	if (pObject == nullptr || pObject + size > m_pBlockEnd)
+	{
+		// Doesn't fit anymore, start a new block (big enough for it, if it's a huge one)
+		const auto blockSize = max(m_BlockSize, size + alignment);
+		m_Blocks.push_back(unique_ptr<uint8_t[]>(new uint8_t[blockSize]));
+		m_pNext = m_Blocks.back().get();
+		m_pBlockEnd = m_pNext + blockSize;
+		pObject = getAligned(m_pNext);
+	}
+
+	m_UsedBytes += size_t(pObject + size - m_pNext);
+	m_pNext = pObject + size;
+	return pObject;
+}
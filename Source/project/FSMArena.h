@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Storage for a whole decision graph (its states, transitions, and whatever observers they need), released all at once
+// Objects are bumped one after the other into big blocks, so a graph usually ends up in a single block, next to each other in the
+// order they were created in (which is about the order the FSM goes through them), instead of scattered around the heap
+// Nothing gets freed on its own: Release() (or the destructor) destroys everything, newest first, and hands the blocks back
+class FSMArena final
+{
+public:
+	explicit FSMArena(size_t blockSize = 16 * 1024);
+	~FSMArena() { Release(); }
+
+	FSMArena(const FSMArena&) = delete;
+	FSMArena& operator=(const FSMArena&) = delete;
+	FSMArena(FSMArena&& other) noexcept; // What was created in the other one stays where it is, only the ownership moves
+	FSMArena& operator=(FSMArena&& other) noexcept;
+
+	template<typename T, typename... Args>
+	T* Create(Args&&... args)
+	{
+		auto* pObject = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		if (std::is_trivially_destructible<T>::value == false)
+			m_Destructors.push_back(Destructor{ pObject, [](void* pDestroyed) { static_cast<T*>(pDestroyed)->~T(); } });
+		return pObject;
+	}
+
+	void Release();
+
+	size_t GetUsedBytes() const { return m_UsedBytes; } // Including the padding to align the objects
+	size_t GetBlockCount() const { return m_Blocks.size(); }
+
+private:
+	void* Allocate(size_t size, size_t alignment);
+
+	struct Destructor
+	{
+		void* pObject;
+		void (*pDestroy)(void*);
+	};
+
+	vector<unique_ptr<uint8_t[]>> m_Blocks;
+	vector<Destructor> m_Destructors; // In creation order
+	size_t m_BlockSize;
+	uint8_t* m_pNext; // In the last block
+	uint8_t* m_pBlockEnd;
+	size_t m_UsedBytes;
+};
@@ -1,59 +1,299 @@
 #include "stdafx.h"
 #include "FiniteStateMachine.h"
+#include "Perception.h"
 
 #include <IExamInterface.h>
+#include <chrono>
+#include <iomanip>
 
-FiniteStateMachine::FiniteStateMachine(FSMState* startState, IExamInterface* pInterface)
-    : m_Transitions()
-	, m_pCurrentState(nullptr)
+namespace
+{
+    using BudgetClock = chrono::steady_clock;
+
+    double GetMicrosecondsSince(BudgetClock::time_point start)
+    {
+        return chrono::duration<double, micro>(BudgetClock::now() - start).count();
+    }
+
+    ProfileZoneId RegisterTypeZone(const type_info& type, const char* pSuffix)
+    {
+#if PROFILER_ENABLED
+        return Profiler::RegisterZone(Profiler::GetTypeName(type) + pSuffix);
+#else
+        return 0;
+#endif
+    }
+}
+
+FiniteStateMachine::FiniteStateMachine(FSMState* startState, IExamInterface* pInterface, FSMArena&& arena)
+    : m_Arena(move(arena))
+	, m_TransitionDescs()
+	, m_IsCompiled(false)
+	, m_States()
+	, m_FirstTransitions()
+	, m_CompiledTransitions()
+	, m_StateProfileZones()
+	, m_StateCounters()
+	, m_pStartState(startState)
+	, m_CurrentStateId(m_InvalidStateId)
 	, m_pInterface(pInterface)
+	, m_pEventLog(nullptr)
+	, m_pCurrentState(nullptr)
+	, m_pCurrentTransitions(nullptr)
+	, m_pCurrentTransitionsEnd(nullptr)
 {
-    SetState(startState);
 }
 
 void FiniteStateMachine::AddTransition(FSMState* startState, FSMState* toState, FSMTransition* transition)
 {
-    auto it = m_Transitions.find(startState);
-    if (it == m_Transitions.end())
-    {
-        m_Transitions[startState] = Transitions();
-    }
-
-    m_Transitions[startState].push_back(std::make_pair(transition, toState));
+    m_TransitionDescs.push_back(TransitionDesc{ startState, toState, transition });
+    m_IsCompiled = false;
 }
 
-SteeringPlugin_Output FiniteStateMachine::Update(float deltaTime)
+SteeringPlugin_Output FiniteStateMachine::Update(float deltaTime, const Perception& perception)
 {
-    auto it = m_Transitions.find(m_pCurrentState);
-    if (it != m_Transitions.end())
+    PROFILE_ZONE("FiniteStateMachine::Update");
+
+    if (m_IsCompiled == false)
+        Compile();
+
+    if (m_pStartState)
     {
-        for (TransitionStatePair& transPair : it->second)
+        SetState(0, perception); // Compile() always gives the start state the first id
+        m_pStartState = nullptr;
+    }
+
+    for (auto* pTransition = m_pCurrentTransitions; pTransition != m_pCurrentTransitionsEnd; ++pTransition)
+    {
+        // Guards on a lower rate are only looked at every few ticks, and catch up on the time that passed in the meantime
+        pTransition->PendingTime += deltaTime;
+        if (pTransition->TicksToWait > 0)
         {
-            transPair.first->Update(deltaTime, m_pInterface);
-            if (transPair.first->ToTransition(m_pInterface))
+            --pTransition->TicksToWait;
+            ++pTransition->Counters.Skips;
+            continue;
+        }
+        pTransition->TicksToWait = pTransition->Budget.Interval - 1;
+
+        bool toTransition;
+        {
+            PROFILE_ZONE_ID(pTransition->ProfileZone);
+            const auto isTimed = pTransition->Budget.Microseconds > 0.f;
+            const auto start = isTimed ? BudgetClock::now() : BudgetClock::time_point{};
+
+            pTransition->pTransition->Update(pTransition->PendingTime, m_pInterface, perception);
+            toTransition = pTransition->pTransition->ToTransition(m_pInterface, perception);
+            pTransition->PendingTime = 0.f;
+
+            ++pTransition->Counters.Evaluations;
+            if (isTimed)
             {
-                SetState(transPair.second);
-                break;
+                const auto microseconds = GetMicrosecondsSince(start);
+                if (pTransition->Counters.Add(microseconds, pTransition->Budget.Microseconds))
+                    LOG_EVENT(EVENT_LOG_STATES, m_pEventLog, eLogEvent::BudgetOverrun, typeid(*pTransition->pTransition).name(), int(microseconds));
             }
         }
+
+        if (toTransition)
+        {
+            SetState(pTransition->ToStateId, perception);
+            break;
+        }
     }
 
     if (m_pCurrentState)
-        return m_pCurrentState->Update(deltaTime, m_pInterface);
+    {
+        PROFILE_ZONE_ID(m_StateProfileZones[m_CurrentStateId].Update);
+        const auto budget = m_pCurrentState->GetBudget().Microseconds;
+        auto& counters = m_StateCounters[m_CurrentStateId];
+        ++counters.Evaluations;
+        if (budget <= 0.f)
+            return m_pCurrentState->Update(deltaTime, m_pInterface, perception);
+
+        const auto start = BudgetClock::now();
+        const auto steering = m_pCurrentState->Update(deltaTime, m_pInterface, perception);
+        const auto microseconds = GetMicrosecondsSince(start);
+        if (counters.Add(microseconds, budget))
+            LOG_EVENT(EVENT_LOG_STATES, m_pEventLog, eLogEvent::BudgetOverrun, typeid(*m_pCurrentState).name(), int(microseconds));
+        return steering;
+    }
 
     return SteeringPlugin_Output{};
 }
 
-void FiniteStateMachine::SetState(FSMState* newState)
+void FiniteStateMachine::SetEventLog(EventLog* pEventLog)
+{
+    m_pEventLog = pEventLog;
+    for (auto* pState : m_States)
+        pState->SetEventLog(pEventLog);
+}
+
+void FiniteStateMachine::Compile()
+{
+    // Transitions can be added after the FSM started running, so the current state has to survive a recompile
+    auto* pCurrentState = m_pCurrentState;
+
+    // Give every state an id (graphs are small and this only runs once, so a linear search is fine)
+    m_States.clear();
+    const auto getStateId = [this](FSMState* pState) -> uint32_t
+    {
+        if (pState == nullptr)
+            return m_InvalidStateId; // Transitioning into "no state" stops the FSM
+
+        const auto it = find(m_States.begin(), m_States.end(), pState);
+        if (it != m_States.end())
+            return uint32_t(it - m_States.begin());
+
+        m_States.push_back(pState);
+        return uint32_t(m_States.size() - 1);
+    };
+
+    if (m_pStartState)
+        getStateId(m_pStartState);
+    if (pCurrentState)
+        m_CurrentStateId = getStateId(pCurrentState);
+
+    for (const auto& desc : m_TransitionDescs)
+    {
+        getStateId(desc.pStartState);
+        getStateId(desc.pToState);
+    }
+
+    // Count the transitions per state, then lay them out per state (keeping the order they were added in)
+    // (transitions starting from "no state" can never be taken, so they're left out)
+    m_FirstTransitions.assign(m_States.size() + 1, 0);
+    for (const auto& desc : m_TransitionDescs)
+    {
+        if (desc.pStartState)
+            ++m_FirstTransitions[getStateId(desc.pStartState) + 1];
+    }
+
+    for (size_t i = 1; i < m_FirstTransitions.size(); ++i)
+        m_FirstTransitions[i] += m_FirstTransitions[i - 1];
+
+    m_CompiledTransitions.resize(m_FirstTransitions.back());
+    vector<uint32_t> nextSlots(m_FirstTransitions.begin(), m_FirstTransitions.end() - 1);
+    for (const auto& desc : m_TransitionDescs)
+    {
+        if (desc.pStartState)
+        {
+            auto budget = desc.pTransition->GetBudget();
+            budget.Interval = max(budget.Interval, 1u);
+            m_CompiledTransitions[nextSlots[getStateId(desc.pStartState)]++] = CompiledTransition{ desc.pTransition, getStateId(desc.pToState),
+                RegisterTypeZone(typeid(*desc.pTransition), ""), budget, 0, 0.f, BudgetCounters{} };
+        }
+    }
+
+    // Every state gets its own profiling zones, named after its type
+    m_StateProfileZones.clear();
+    for (auto* pState : m_States)
+    {
+        pState->SetEventLog(m_pEventLog);
+        m_StateProfileZones.push_back(StateProfileZones{ RegisterTypeZone(typeid(*pState), "::OnEnter"),
+            RegisterTypeZone(typeid(*pState), "::Update"), RegisterTypeZone(typeid(*pState), "::OnExit") });
+    }
+    m_StateCounters.assign(m_States.size(), BudgetCounters{});
+
+    m_IsCompiled = true;
+    CacheCurrentState();
+}
+
+void FiniteStateMachine::SetState(uint32_t newStateId, const Perception& perception)
 {
     if (m_pCurrentState)
+    {
+        LOG_EVENT(EVENT_LOG_STATES, m_pEventLog, eLogEvent::StateExited, typeid(*m_pCurrentState).name(), 0);
+        PROFILE_ZONE_ID(m_StateProfileZones[m_CurrentStateId].OnExit);
         m_pCurrentState->OnExit(m_pInterface);
+    }
 	
-    m_pCurrentState = newState;
+    m_CurrentStateId = newStateId;
+    CacheCurrentState();
+
+    // The guards on a lower rate start over, spread out over their interval (so they don't all come due on the same tick)
+    for (auto* pTransition = m_pCurrentTransitions; pTransition != m_pCurrentTransitionsEnd; ++pTransition)
+    {
+        pTransition->TicksToWait = uint32_t(pTransition - m_pCurrentTransitions) % pTransition->Budget.Interval;
+        pTransition->PendingTime = 0.f;
+    }
 	
     if (m_pCurrentState)
     {
-        std::cout << "Entering state: " << typeid(*m_pCurrentState).name() << std::endl;
-        m_pCurrentState->OnEnter(m_pInterface);
+        LOG_EVENT(EVENT_LOG_STATES, m_pEventLog, eLogEvent::StateEntered, typeid(*m_pCurrentState).name(), 0);
+        PROFILE_ZONE_ID(m_StateProfileZones[m_CurrentStateId].OnEnter);
+        m_pCurrentState->OnEnter(m_pInterface, perception);
     }
 }
+
+void FiniteStateMachine::CacheCurrentState()
+{
+    if (m_CurrentStateId == m_InvalidStateId)
+    {
+        m_pCurrentState = nullptr;
+        m_pCurrentTransitions = m_pCurrentTransitionsEnd = nullptr;
+        return;
+    }
+
+    m_pCurrentState = m_States[m_CurrentStateId];
+    m_pCurrentTransitions = m_CompiledTransitions.data() + m_FirstTransitions[m_CurrentStateId];
+    m_pCurrentTransitionsEnd = m_CompiledTransitions.data() + m_FirstTransitions[m_CurrentStateId + 1];
+}
+
+vector<FSMBudgetStats> FiniteStateMachine::GetBudgetStats() const
+{
+    vector<FSMBudgetStats> stats;
+    const auto addStats = [&stats](const type_info& type, const string& fromState, const FSMBudget& budget, const BudgetCounters& counters)
+    {
+        stats.push_back(FSMBudgetStats{ Profiler::GetTypeName(type), fromState, budget, counters.Evaluations, counters.Skips,
+            counters.Overruns, counters.TotalMicroseconds, counters.WorstMicroseconds });
+    };
+
+    for (size_t stateId = 0; stateId < m_States.size() && stateId < m_StateCounters.size(); ++stateId)
+        addStats(typeid(*m_States[stateId]), string{}, m_States[stateId]->GetBudget(), m_StateCounters[stateId]);
+
+    for (size_t stateId = 0; stateId + 1 < m_FirstTransitions.size(); ++stateId)
+    {
+        const auto fromState = Profiler::GetTypeName(typeid(*m_States[stateId]));
+        for (auto transitionIdx = m_FirstTransitions[stateId]; transitionIdx < m_FirstTransitions[stateId + 1]; ++transitionIdx)
+        {
+            const auto& transition = m_CompiledTransitions[transitionIdx];
+            addStats(typeid(*transition.pTransition), fromState, transition.Budget, transition.Counters);
+        }
+    }
+
+    return stats;
+}
+
+uint64_t FiniteStateMachine::GetOverrunCount() const
+{
+    uint64_t overruns = 0;
+    for (const auto& counters : m_StateCounters)
+        overruns += counters.Overruns;
+    for (const auto& transition : m_CompiledTransitions)
+        overruns += transition.Counters.Overruns;
+    return overruns;
+}
+
+void FiniteStateMachine::PrintBudgetReport(ostream& stream, const vector<FSMBudgetStats>& stats)
+{
+    stream << left << setw(28) << "Name" << setw(24) << "From" << right << setw(10) << "Budget" << setw(10) << "Interval"
+        << setw(12) << "Evaluated" << setw(12) << "Skipped" << setw(10) << "Overruns" << setw(10) << "Mean" << setw(10) << "Worst" << '\n';
+    for (const auto& entry : stats)
+    {
+        const auto meanMicroseconds = entry.Evaluations > 0 && entry.Budget.Microseconds > 0.f ? entry.TotalMicroseconds / double(entry.Evaluations) : 0.0;
+        stream << left << setw(28) << entry.Name << setw(24) << (entry.FromState.empty() ? "-" : entry.FromState) << right << fixed << setprecision(1)
+            << setw(8) << entry.Budget.Microseconds << "us" << setw(10) << entry.Budget.Interval << setw(12) << entry.Evaluations << setw(12) << entry.Skips
+            << setw(10) << entry.Overruns << setw(8) << meanMicroseconds << "us" << setw(8) << entry.WorstMicroseconds << "us" << '\n';
+    }
+}
+
+bool FiniteStateMachine::BudgetCounters::Add(double microseconds, float budget)
+{
+    TotalMicroseconds += microseconds;
+    WorstMicroseconds = max(WorstMicroseconds, microseconds);
+    if (microseconds <= double(budget))
+        return false;
+
+    ++Overruns;
+    return true;
+}
@@ -1,8 +1,10 @@
 #pragma once
 #include <Exam_HelperStructs.h>
-#include <map>
+#include <cstdint>
 
-#include "Subject.h"
+#include "EventLog.h"
+#include "Profiler.h"
+#include "FSMArena.h"
 
 /*=============================================================================*/
 // Heavily inspired in the implementation from class
@@ -13,6 +15,17 @@
 
 
 class IExamInterface;
+class Perception;
+class DebugDrawList;
+
+// How much of a frame a state or transition gets
+// The microseconds are only measured against (and overruns reported), never acted upon: the interval's what makes a guard cheaper,
+// and it's in ticks instead of time so recorded runs replay the same
+struct FSMBudget
+{
+	float Microseconds{ 0.f }; // Per evaluation, 0 to not time it at all
+	uint32_t Interval{ 1 }; // Transitions only, evaluated once every this many ticks (Update() getting all the time that passed since)
+};
 
 class FSMState
 {
@@ -20,13 +33,19 @@ public:
 	FSMState() {}
 	virtual ~FSMState() = default;
 
-	virtual void OnEnter(IExamInterface* pInterface) {}
+	virtual void OnEnter(IExamInterface* pInterface, const Perception& perception) {}
 	virtual void OnExit(IExamInterface* pInterface) {}
-	virtual SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) { return SteeringPlugin_Output{}; }
-	Subject* GetSubject() const { return m_Subject;  }
+	virtual SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) { return SteeringPlugin_Output{}; }
+	virtual void DebugDraw(DebugDrawList& drawList, const Perception& perception) const {} // Only called on the current state, after its Update()
+	void SetEventLog(EventLog* pEventLog) { m_pEventLog = pEventLog; }
+	void SetBudget(const FSMBudget& budget) { m_Budget = budget; } // The interval's ignored, a state updates every tick
+	const FSMBudget& GetBudget() const { return m_Budget; }
 
 protected:
-	Subject* m_Subject{ new Subject() };
+	EventLog* m_pEventLog{ nullptr }; // Can be null, log through LOG_EVENT()
+
+private:
+	FSMBudget m_Budget{};
 };
 
 class FSMTransition
@@ -34,28 +53,112 @@ class FSMTransition
 public:
 	FSMTransition() = default;
 	virtual ~FSMTransition() = default;
-	virtual void Update(float deltaTime, IExamInterface* pInterface) = 0;
-	virtual bool ToTransition(IExamInterface* pInterface) = 0;
+	virtual void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) = 0;
+	virtual bool ToTransition(IExamInterface* pInterface, const Perception& perception) = 0;
+	void SetBudget(const FSMBudget& budget) { m_Budget = budget; } // Only picked up when the FSM's (re)compiled
+	const FSMBudget& GetBudget() const { return m_Budget; }
+
+private:
+	FSMBudget m_Budget{};
+};
+
+// How a state or transition's been doing against its budget, per FSM (a transition from several states gets one per state)
+struct FSMBudgetStats
+{
+	string Name; // Its type
+	string FromState; // Transitions only
+	FSMBudget Budget;
+	uint64_t Evaluations;
+	uint64_t Skips; // Ticks it wasn't evaluated on, because of its interval
+	uint64_t Overruns;
+	double TotalMicroseconds; // Only measured with a budget
+	double WorstMicroseconds;
 };
 
 
 class FiniteStateMachine
 {
 public:
-	FiniteStateMachine(FSMState* startState, IExamInterface* pInterface);
+	// The arena's whatever the states and transitions were created in (if they were), the FSM takes it over and releases it when it's gone
+	FiniteStateMachine(FSMState* startState, IExamInterface* pInterface, FSMArena&& arena = FSMArena{});
 	~FiniteStateMachine() = default;
 
+	FiniteStateMachine(const FiniteStateMachine&) = delete;
+	FiniteStateMachine& operator=(const FiniteStateMachine&) = delete;
+
+	// Transitions are only collected here, the graph gets compiled into a flat table on the next Update()
 	void AddTransition(FSMState* startState, FSMState* toState, FSMTransition* transition);
-	SteeringPlugin_Output Update(float deltaTime);
+	SteeringPlugin_Output Update(float deltaTime, const Perception& perception);
+	void SetEventLog(EventLog* pEventLog); // Also hands it to every state
+	FSMState* GetCurrentState() const { return m_pCurrentState; } // Null until the first Update()
+
+	vector<FSMBudgetStats> GetBudgetStats() const; // States first, then their transitions
+	uint64_t GetOverrunCount() const;
+	static void PrintBudgetReport(ostream& stream, const vector<FSMBudgetStats>& stats);
 
 private:
-	void SetState(FSMState* newState);
-	
-	typedef std::pair<FSMTransition*, FSMState*> TransitionStatePair;
-	typedef std::vector<TransitionStatePair> Transitions;
+	void Compile();
+	void SetState(uint32_t newStateId, const Perception& perception);
+	void CacheCurrentState();
 
-	map<FSMState*, Transitions> m_Transitions;
-	FSMState* m_pCurrentState;
+	struct BudgetCounters
+	{
+		uint64_t Evaluations;
+		uint64_t Skips;
+		uint64_t Overruns;
+		double TotalMicroseconds;
+		double WorstMicroseconds;
+
+		bool Add(double microseconds, float budget); // A timed evaluation, true when it went over budget
+	};
+
+	struct TransitionDesc
+	{
+		FSMState* pStartState;
+		FSMState* pToState;
+		FSMTransition* pTransition;
+	};
+
+	struct CompiledTransition
+	{
+		FSMTransition* pTransition;
+		uint32_t ToStateId;
+		ProfileZoneId ProfileZone; // Named after the transition's type, covers both its Update() and ToTransition()
+		FSMBudget Budget;
+		uint32_t TicksToWait; // Before it's evaluated again
+		float PendingTime; // Since it was last evaluated
+		BudgetCounters Counters;
+	};
+
+	struct StateProfileZones
+	{
+		ProfileZoneId OnEnter;
+		ProfileZoneId Update;
+		ProfileZoneId OnExit;
+	};
+
+	static const uint32_t m_InvalidStateId{ UINT32_MAX };
+
+	FSMArena m_Arena; // First, so it's released after everything else that points into it
+
+	vector<TransitionDesc> m_TransitionDescs; // As added
+	bool m_IsCompiled;
+
+	// Compiled graph: states are addressed by their index, and every state's transitions are stored next to each other
+	// (the ones of state i being m_CompiledTransitions[m_FirstTransitions[i]] up to m_CompiledTransitions[m_FirstTransitions[i + 1]])
+	vector<FSMState*> m_States;
+	vector<uint32_t> m_FirstTransitions;
+	vector<CompiledTransition> m_CompiledTransitions;
+	vector<StateProfileZones> m_StateProfileZones; // By state id (only filled in when profiling)
+	vector<BudgetCounters> m_StateCounters; // By state id, of their Update()
+
+	FSMState* m_pStartState; // Only entered on the first Update(), once there's a perception snapshot to enter it with
+	uint32_t m_CurrentStateId;
 	IExamInterface* m_pInterface;
-};
+	EventLog* m_pEventLog;
 
+	// The current state's entries, cached whenever it changes (so a tick doesn't have to go through the tables)
+	FSMState* m_pCurrentState;
+	CompiledTransition* m_pCurrentTransitions;
+	CompiledTransition* m_pCurrentTransitionsEnd;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include "EventBus.h"
+
+// What the bot's subsystems tell each other about (see EventBus.h), pushed where it happens and dispatched by the plugin once per frame
+
+// An item got stored in the inventory (Inventory::Add())
+struct ItemPickedEvent
+{
+	UINT Slot;
+	eItemType Type;
+	int Units;
+};
+
+// An item in the inventory got used (Inventory::Use()), 0 units left when that was its last (it's thrown away then)
+struct ItemConsumedEvent
+{
+	UINT Slot;
+	eItemType Type;
+	int UnitsLeft;
+};
+
+// An enemy got a track (EnemyTracks::Update()), it wasn't seen before or had been forgotten
+struct EnemyFirstSeenEvent
+{
+	int EnemyHash;
+	Elite::Vector2 Position;
+};
+
+// An enemy's track got forgotten (EnemyTracks::Update())
+struct EnemyLostEvent
+{
+	int EnemyHash;
+	Elite::Vector2 LastPosition;
+};
+
+// The agent walked into a house (HouseMemory::Update())
+struct HouseEnteredEvent
+{
+	int HouseIdx; // In the house memory
+	Elite::Vector2 Center;
+};
+
+// The movement FSM changed states, indices into its state list (MovementStates for the plugin's), the first state's entered from -1
+struct StateChangedEvent
+{
+	int FromState;
+	int ToState;
+};
+
+// Enough room for every enemy in the game showing up on the same frame
+using GameEventQueue = EventQueue<64, ItemPickedEvent, ItemConsumedEvent, EnemyFirstSeenEvent, EnemyLostEvent, HouseEnteredEvent, StateChangedEvent>;
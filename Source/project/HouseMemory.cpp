@@ -0,0 +1,198 @@
+#include "stdafx.h"
+#include "HouseMemory.h"
+#include "Perception.h"
+#include "EventLog.h"
+#include <cassert>
+
+namespace
+{
+	const float g_NotRansacked{ -1.f };
+}
+
+HouseMemory::HouseMemory(float forgetRansackedAfter, float cellSize)
+	: m_Cells()
+	, m_GridMin()
+	, m_CellSize(cellSize)
+	, m_Columns(0)
+	, m_Rows(0)
+	, m_Houses()
+	, m_Centers()
+	, m_Wheel(m_WheelSize)
+	, m_WheelTick(0)
+	, m_CurrentHouseIdx(-1)
+	, m_ForgetRansackedAfter(forgetRansackedAfter)
+	, m_pEventLog(nullptr)
+	, m_pEvents(nullptr)
+{
+	assert(forgetRansackedAfter + 1.f < float(m_WheelSize));
+}
+
+void HouseMemory::Update(const Perception& perception)
+{
+	if (m_Cells.empty())
+		SetUpGrid(perception.GetWorldInfo());
+
+	const auto time = perception.GetStats().TimeSurvived;
+	for (const auto& house : perception.GetHouses())
+	{
+		auto houseIdx = Find(house.Center);
+		if (houseIdx < 0)
+			houseIdx = Add(house);
+		m_Houses[houseIdx].LastSeenTime = time;
+	}
+
+	UpdateCurrentHouse(perception);
+	AdvanceWheel(time);
+}
+
+void HouseMemory::Clear()
+{
+	fill(m_Cells.begin(), m_Cells.end(), -1);
+	m_Houses.clear();
+	m_Centers.Clear();
+	for (auto& bucket : m_Wheel)
+		bucket.clear();
+	m_WheelTick = 0;
+	m_CurrentHouseIdx = -1;
+}
+
+int HouseMemory::Find(const Elite::Vector2& center) const
+{
+	if (m_Cells.empty())
+		return -1;
+
+	for (auto houseIdx = m_Cells[GetCell(center)]; houseIdx >= 0; houseIdx = m_Houses[houseIdx].NextInCell)
+	{
+		if (m_Houses[houseIdx].Info.Center == center)
+			return houseIdx;
+	}
+	return -1;
+}
+
+bool HouseMemory::IsRansacked(const Elite::Vector2& center) const
+{
+	const auto houseIdx = Find(center);
+	return houseIdx >= 0 && IsRansacked(houseIdx);
+}
+
+void HouseMemory::MarkRansacked(int houseIdx, float time)
+{
+	// Marking it again just moves its expiry, the entry it had in the wheel is skipped once its bucket comes up
+	m_Houses[houseIdx].RansackedTime = time;
+	m_Wheel[GetExpiryTick(time) % m_WheelSize].push_back(houseIdx);
+	LOG_EVENT(EVENT_LOG_VERBOSE, m_pEventLog, eLogEvent::HouseRansacked, "HouseMemory", houseIdx);
+}
+
+int HouseMemory::FindNearestUnlooted(const Elite::Vector2& position) const
+{
+	int nearestIdx = -1;
+	float nearestDistanceSquared = FLT_MAX;
+	for (size_t houseIdx = 0; houseIdx < m_Houses.size(); ++houseIdx)
+	{
+		if (IsRansacked(int(houseIdx)))
+			continue;
+
+		const auto distanceSquared = m_Centers[houseIdx].DistanceSquared(position);
+		if (distanceSquared < nearestDistanceSquared)
+		{
+			nearestDistanceSquared = distanceSquared;
+			nearestIdx = int(houseIdx);
+		}
+	}
+	return nearestIdx;
+}
+
+void HouseMemory::SetUpGrid(const WorldInfo& world)
+{
+	m_GridMin = world.Center - world.Dimensions / 2.f;
+	m_Columns = max(1u, uint32_t(ceilf(world.Dimensions.x / m_CellSize)));
+	m_Rows = max(1u, uint32_t(ceilf(world.Dimensions.y / m_CellSize)));
+	m_Cells.assign(size_t(m_Columns) * m_Rows, -1);
+}
+
+uint32_t HouseMemory::GetCell(const Elite::Vector2& center) const
+{
+	const auto local = (center - m_GridMin) / m_CellSize;
+	const auto column = uint32_t(Elite::Clamp(int(floorf(local.x)), 0, int(m_Columns) - 1));
+	const auto row = uint32_t(Elite::Clamp(int(floorf(local.y)), 0, int(m_Rows) - 1));
+	return row * m_Columns + column;
+}
+
+int HouseMemory::Add(const HouseInfo& house)
+{
+	const auto houseIdx = int(m_Houses.size());
+	auto& firstInCell = m_Cells[GetCell(house.Center)];
+	m_Houses.push_back(House{ house, 0.f, g_NotRansacked, 0, firstInCell });
+	m_Centers.PushBack(house.Center);
+	firstInCell = houseIdx;
+	return houseIdx;
+}
+
+uint32_t HouseMemory::GetExpiryTick(float ransackedTime) const
+{
+	return uint32_t(max(0.f, floorf(ransackedTime + m_ForgetRansackedAfter)));
+}
+
+void HouseMemory::AdvanceWheel(float time)
+{
+	// A ransack is forgotten once it's more than m_ForgetRansackedAfter old, so every bucket before the current second
+	// can be emptied completely, and the current one only has to be checked against the exact time
+	const auto currentTick = uint32_t(max(0.f, floorf(time)));
+	for (; m_WheelTick <= currentTick; ++m_WheelTick)
+	{
+		auto& bucket = m_Wheel[m_WheelTick % m_WheelSize];
+		size_t kept = 0;
+		for (const auto houseIdx : bucket)
+		{
+			auto& house = m_Houses[houseIdx];
+			if (house.RansackedTime < 0.f || GetExpiryTick(house.RansackedTime) != m_WheelTick)
+				continue; // Stale, it got forgotten or marked again since
+
+			if (house.RansackedTime + m_ForgetRansackedAfter < time)
+			{
+				house.RansackedTime = g_NotRansacked;
+				LOG_EVENT(EVENT_LOG_VERBOSE, m_pEventLog, eLogEvent::HouseForgotten, "HouseMemory", houseIdx);
+			}
+			else
+				bucket[kept++] = houseIdx;
+		}
+		bucket.resize(kept);
+
+		if (m_WheelTick == currentTick)
+			break; // Might still have ransacks that expire later this second
+	}
+}
+
+void HouseMemory::OnEvent(const ItemPickedEvent& event)
+{
+	// Whatever got picked up while inside a house counts towards that house's yield
+	if (m_CurrentHouseIdx >= 0)
+		++m_Houses[m_CurrentHouseIdx].LootYield;
+}
+
+void HouseMemory::UpdateCurrentHouse(const Perception& perception)
+{
+	const auto& agentInfo = perception.GetAgentInfo();
+	if (agentInfo.IsInHouse == false)
+	{
+		m_CurrentHouseIdx = -1;
+		return;
+	}
+
+	// Only looked for on the way in (until it shows up in the FOV), not on every frame the agent stays inside
+	if (m_CurrentHouseIdx >= 0)
+		return;
+
+	for (const auto& house : perception.GetHouses())
+	{
+		const auto offset = agentInfo.Position - house.Center;
+		if (abs(offset.x) <= house.Size.x / 2.f && abs(offset.y) <= house.Size.y / 2.f)
+		{
+			m_CurrentHouseIdx = Find(house.Center);
+			LOG_EVENT(EVENT_LOG_VERBOSE, m_pEventLog, eLogEvent::HouseEntered, "HouseMemory", m_CurrentHouseIdx);
+			if (m_pEvents)
+				m_pEvents->Push(HouseEnteredEvent{ m_CurrentHouseIdx, house.Center });
+			return;
+		}
+	}
+}
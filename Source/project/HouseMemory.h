@@ -0,0 +1,78 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include "GameEvents.h"
+
+class Perception;
+class EventLog;
+
+// Every house the agent has seen, kept for the whole run (houses don't move), with when it was last seen,
+// when it was last ransacked and how many items got picked up inside it (counted off the pickup events, while it knows which house the agent's in)
+// Houses are found by their center through a uniform grid over the world (every cell chains the houses whose center falls in it),
+// so checking whether a house in the FOV was ransacked already is O(1)
+// A ransacked house is forgotten (counts as unlooted again) after a while, as new items might've spawned in it in the meantime:
+// ransacks are dropped in an expiry wheel (one bucket per second) that Update() advances, instead of going through every house every frame
+class HouseMemory final
+{
+public:
+	explicit HouseMemory(float forgetRansackedAfter = 90.f, float cellSize = 8.f);
+	~HouseMemory() = default;
+
+	void Update(const Perception& perception); // Once per frame, after the perception got refreshed
+	void Clear();
+	void SetEventLog(EventLog* pEventLog) { m_pEventLog = pEventLog; }
+	void SetEventQueue(GameEventQueue* pEvents) { m_pEvents = pEvents; } // Can be null, raises every house the agent walks into
+	void OnEvent(const ItemPickedEvent& event);
+
+	size_t GetCount() const { return m_Houses.size(); }
+	int Find(const Elite::Vector2& center) const; // Index of the house, -1 if it was never seen
+	int GetCurrentHouse() const { return m_CurrentHouseIdx; } // The one the agent's in, -1 when it isn't (or its house wasn't in the FOV yet)
+
+	// Indexed by house, in the order they were first seen
+	const HouseInfo& GetHouse(int houseIdx) const { return m_Houses[houseIdx].Info; }
+	float GetLastSeenTime(int houseIdx) const { return m_Houses[houseIdx].LastSeenTime; } // In TimeSurvived
+	float GetRansackedTime(int houseIdx) const { return m_Houses[houseIdx].RansackedTime; } // -1 if it isn't (anymore)
+	int GetLootYield(int houseIdx) const { return m_Houses[houseIdx].LootYield; } // Items picked up inside it, over every visit
+	bool IsRansacked(int houseIdx) const { return m_Houses[houseIdx].RansackedTime >= 0.f; }
+	bool IsRansacked(const Elite::Vector2& center) const; // False for houses that were never seen
+
+	void MarkRansacked(int houseIdx, float time);
+	int FindNearestUnlooted(const Elite::Vector2& position) const; // Closest known house that isn't ransacked, -1 if there's none
+
+private:
+	struct House
+	{
+		HouseInfo Info;
+		float LastSeenTime;
+		float RansackedTime;
+		int LootYield;
+		int NextInCell; // Next house in the same grid cell, -1 for the last one
+	};
+
+	void SetUpGrid(const WorldInfo& world);
+	uint32_t GetCell(const Elite::Vector2& center) const;
+	int Add(const HouseInfo& house);
+	uint32_t GetExpiryTick(float ransackedTime) const;
+	void AdvanceWheel(float time);
+	void UpdateCurrentHouse(const Perception& perception);
+
+	// Uniform grid over the world (houses outside of it end up in the border cells)
+	vector<int> m_Cells; // First house in every cell, -1 when empty
+	Elite::Vector2 m_GridMin;
+	float m_CellSize;
+	uint32_t m_Columns;
+	uint32_t m_Rows;
+
+	vector<House> m_Houses;
+	Elite::Vector2SoA m_Centers; // Of m_Houses
+
+	// Expiry wheel: every bucket holds the houses whose ransack expires in that second (modulo the wheel's size)
+	vector<vector<int>> m_Wheel;
+	uint32_t m_WheelTick; // First second that wasn't completely expired yet
+
+	int m_CurrentHouseIdx;
+	const float m_ForgetRansackedAfter;
+	EventLog* m_pEventLog;
+	GameEventQueue* m_pEvents;
+
+	static const uint32_t m_WheelSize{ 128 }; // In seconds, has to be longer than m_ForgetRansackedAfter
+};
@@ -0,0 +1,245 @@
+#include "stdafx.h"
+#include "InfluenceMap.h"
+#include "Perception.h"
+#include "HouseMemory.h"
+#include "DebugDrawList.h"
+
+namespace
+{
+	const size_t g_CacheLineFloats{ 64 / sizeof(float) };
+
+	size_t RoundUpToCacheLine(size_t floats)
+	{
+		return (floats + g_CacheLineFloats - 1) / g_CacheLineFloats * g_CacheLineFloats;
+	}
+
+	float GetThreat(eEnemyType type)
+	{
+		switch (type)
+		{
+		case eEnemyType::ZOMBIE_RUNNER:
+			return 0.75f; // Catches up
+		case eEnemyType::ZOMBIE_HEAVY:
+			return 1.f; // Takes the most shots
+		default:
+			return 0.5f;
+		}
+	}
+
+	// Every cell takes the most of itself and its (spread out) neighbors, then fades
+	void SweepCells(float* pCells, const float* pOld, const float* pBelow, const float* pAbove, int count, float spread, float fade)
+	{
+		int x = 0;
+
+#ifdef ELITE_SIMD
+		using Elite::Detail::FloatLanes;
+		const auto spreads = FloatLanes::Set(spread);
+		const auto fades = FloatLanes::Set(fade);
+		for (; x + FloatLanes::Width <= count; x += FloatLanes::Width)
+		{
+			const auto sides = FloatLanes::Max(FloatLanes::Load(pOld + x - 1), FloatLanes::Load(pOld + x + 1));
+			const auto aboveBelow = FloatLanes::Max(FloatLanes::Load(pBelow + x), FloatLanes::Load(pAbove + x));
+			const auto neighbors = FloatLanes::Mul(FloatLanes::Max(sides, aboveBelow), spreads);
+			FloatLanes::Store(pCells + x, FloatLanes::Mul(FloatLanes::Max(FloatLanes::Load(pOld + x), neighbors), fades));
+		}
+#endif
+
+		for (; x < count; ++x)
+		{
+			const auto neighbors = max(max(pOld[x - 1], pOld[x + 1]), max(pBelow[x], pAbove[x])) * spread;
+			pCells[x] = max(pOld[x], neighbors) * fade;
+		}
+	}
+}
+
+InfluenceMap::InfluenceMap(float cellSize, int cellsPerFrame)
+	: m_Storage()
+	, m_pCells(nullptr)
+	, m_pScratchRows(nullptr)
+	, m_pZeroRow(nullptr)
+	, m_LayerSize(0)
+	, m_RowStride(0)
+	, m_RowPadding(g_CacheLineFloats)
+	, m_GridMin()
+	, m_CellSize(cellSize)
+	, m_Columns(0)
+	, m_Rows(0)
+	, m_RowSweepTimes()
+	, m_CellsPerFrame(cellsPerFrame)
+	, m_NextRow(0)
+	, m_Time(0.f)
+{
+}
+
+void InfluenceMap::Update(float deltaTime, const Perception& perception, const HouseMemory& houseMemory)
+{
+	if (m_pCells == nullptr)
+		SetUpGrid(perception.GetWorldInfo());
+	m_Time += deltaTime;
+
+	// Stamp in whatever's in the FOV
+	for (const auto& enemy : perception.GetEnemies())
+		Stamp(eInfluenceLayer::Threat, enemy.Location, GetThreat(enemy.Type));
+	for (const auto& item : perception.GetItems())
+		Stamp(eInfluenceLayer::Loot, item.Location, 1.f);
+	for (const auto& house : perception.GetHouses())
+	{
+		if (houseMemory.IsRansacked(house.Center))
+			Erase(eInfluenceLayer::Loot, house.Center);
+		else
+			Stamp(eInfluenceLayer::Loot, house.Center, m_UnlootedHouseLoot);
+	}
+	for (const auto& purgeZone : perception.GetPurgeZones())
+		StampCircle(eInfluenceLayer::PurgeDanger, purgeZone.Center, purgeZone.Radius, 1.f);
+
+	// Then sweep this frame's share of the rows
+	const auto rowsPerFrame = max(1, m_CellsPerFrame / m_Columns);
+	for (int i = 0; i < rowsPerFrame && i < m_Rows; ++i)
+	{
+		SweepRow(m_NextRow);
+		m_NextRow = (m_NextRow + 1) % m_Rows;
+	}
+}
+
+void InfluenceMap::Clear()
+{
+	fill(m_Storage.begin(), m_Storage.end(), 0.f);
+	fill(m_RowSweepTimes.begin(), m_RowSweepTimes.end(), m_Time);
+	m_NextRow = 0;
+}
+
+void InfluenceMap::DebugDraw(DebugDrawList& drawList) const
+{
+	if (m_pCells == nullptr || drawList.IsEnabled(eDebugDrawCategory::Influence) == false)
+		return;
+
+	// A dot per cell, as big as its strongest layer's influence (red for threat, green for loot, orange for purge zones)
+	const Elite::Vector3 layerColors[size_t(eInfluenceLayer::Count)]{ { 1, 0, 0 }, { 0, 1, 0 }, { 1, 0.5f, 0 } };
+	for (int row = 0; row < m_Rows; ++row)
+	{
+		for (int column = 0; column < m_Columns; ++column)
+		{
+			size_t strongestLayer = 0;
+			float strongestInfluence = 0.f;
+			for (size_t layerIdx = 0; layerIdx < size_t(eInfluenceLayer::Count); ++layerIdx)
+			{
+				const auto influence = GetRow(eInfluenceLayer(layerIdx), row)[column];
+				if (influence > strongestInfluence)
+				{
+					strongestInfluence = influence;
+					strongestLayer = layerIdx;
+				}
+			}
+
+			if (strongestInfluence >= m_MinDrawnInfluence)
+			{
+				const auto cellCenter = m_GridMin + Elite::Vector2{ float(column) + 0.5f, float(row) + 0.5f } * m_CellSize;
+				drawList.AddCircle(eDebugDrawCategory::Influence, cellCenter, strongestInfluence * m_CellSize / 2.f, layerColors[strongestLayer], true);
+			}
+		}
+	}
+}
+
+float InfluenceMap::Get(eInfluenceLayer layer, const Elite::Vector2& position) const
+{
+	int column, row;
+	if (m_pCells == nullptr || GetCell(position, column, row) == false)
+		return 0.f;
+	return GetRow(layer, row)[column];
+}
+
+bool InfluenceMap::IsInWorld(const Elite::Vector2& position) const
+{
+	int column, row;
+	return m_pCells != nullptr && GetCell(position, column, row);
+}
+
+void InfluenceMap::SetUpGrid(const WorldInfo& world)
+{
+	m_GridMin = world.Center - world.Dimensions / 2.f;
+	m_Columns = max(1, int(ceilf(world.Dimensions.x / m_CellSize)));
+	m_Rows = max(1, int(ceilf(world.Dimensions.y / m_CellSize)));
+	m_RowStride = RoundUpToCacheLine(size_t(m_Columns) + 1); // At least one 0 past the last cell, for its right neighbor
+	m_LayerSize = m_RowPadding + size_t(m_Rows) * m_RowStride;
+
+	const auto nrOfLayers = size_t(eInfluenceLayer::Count);
+	const auto scratchRowSize = m_RowPadding + m_RowStride;
+	m_Storage.assign(nrOfLayers * m_LayerSize + 2 * nrOfLayers * scratchRowSize + m_RowStride + g_CacheLineFloats, 0.f);
+	const auto misalignment = (reinterpret_cast<uintptr_t>(m_Storage.data()) / sizeof(float)) % g_CacheLineFloats;
+	m_pCells = m_Storage.data() + (misalignment == 0 ? 0 : g_CacheLineFloats - misalignment);
+	m_pScratchRows = m_pCells + nrOfLayers * m_LayerSize;
+	m_pZeroRow = m_pScratchRows + 2 * nrOfLayers * scratchRowSize;
+
+	m_RowSweepTimes.assign(m_Rows, m_Time);
+	m_NextRow = 0;
+}
+
+bool InfluenceMap::GetCell(const Elite::Vector2& position, int& column, int& row) const
+{
+	const auto local = (position - m_GridMin) / m_CellSize;
+	column = int(floorf(local.x));
+	row = int(floorf(local.y));
+	return column >= 0 && column < m_Columns && row >= 0 && row < m_Rows;
+}
+
+void InfluenceMap::Stamp(eInfluenceLayer layer, const Elite::Vector2& position, float value)
+{
+	int column, row;
+	if (GetCell(position, column, row))
+	{
+		auto& cell = GetRow(layer, row)[column];
+		cell = max(cell, value);
+	}
+}
+
+void InfluenceMap::StampCircle(eInfluenceLayer layer, const Elite::Vector2& center, float radius, float value)
+{
+	// Every cell whose center is inside
+	const auto local = (center - m_GridMin) / m_CellSize;
+	const auto localRadius = radius / m_CellSize;
+	const auto minRow = max(0, int(floorf(local.y - localRadius)));
+	const auto maxRow = min(m_Rows - 1, int(floorf(local.y + localRadius)));
+	const auto minColumn = max(0, int(floorf(local.x - localRadius)));
+	const auto maxColumn = min(m_Columns - 1, int(floorf(local.x + localRadius)));
+	for (int row = minRow; row <= maxRow; ++row)
+	{
+		auto* pRow = GetRow(layer, row);
+		const auto dy = float(row) + 0.5f - local.y;
+		for (int column = minColumn; column <= maxColumn; ++column)
+		{
+			const auto dx = float(column) + 0.5f - local.x;
+			if (dx * dx + dy * dy <= localRadius * localRadius)
+				pRow[column] = max(pRow[column], value);
+		}
+	}
+}
+
+void InfluenceMap::Erase(eInfluenceLayer layer, const Elite::Vector2& position)
+{
+	int column, row;
+	if (GetCell(position, column, row))
+		GetRow(layer, row)[column] = 0.f;
+}
+
+void InfluenceMap::SweepRow(int row)
+{
+	const auto elapsedTime = m_Time - m_RowSweepTimes[row];
+	m_RowSweepTimes[row] = m_Time;
+
+	const auto scratchRowSize = m_RowPadding + m_RowStride;
+	for (size_t layerIdx = 0; layerIdx < size_t(eInfluenceLayer::Count); ++layerIdx)
+	{
+		const auto layer = eInfluenceLayer(layerIdx);
+		auto* pRow = GetRow(layer, row);
+
+		// The row gets swept in place, so what it held is kept aside (for its own sides, and as the next row's neighbor below)
+		// The row below's was kept aside when that one got swept, except along the border
+		auto* pOld = m_pScratchRows + (2 * layerIdx + (row & 1)) * scratchRowSize + m_RowPadding;
+		const auto* pBelow = row > 0 ? m_pScratchRows + (2 * layerIdx + ((row - 1) & 1)) * scratchRowSize + m_RowPadding : m_pZeroRow;
+		const auto* pAbove = row + 1 < m_Rows ? GetRow(layer, row + 1) : m_pZeroRow;
+		copy(pRow, pRow + m_RowStride, pOld);
+
+		const auto fade = exp2f(-elapsedTime / m_HalfLives[layerIdx]);
+		SweepCells(pRow, pOld, pBelow, pAbove, m_Columns, m_Spreads[layerIdx], fade);
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+
+class Perception;
+class HouseMemory;
+class DebugDrawList;
+
+enum class eInfluenceLayer
+{
+	Threat, // Enemies seen around there, weighed by their type
+	Loot, // Items and unlooted houses seen around there
+	PurgeDanger, // Inside (or close to) a purge zone
+	Count
+};
+
+// What the agent saw around the world lately, remembered on coarse grids (one per layer) instead of only going by the FOV
+// Whatever's in the FOV gets stamped in every frame, then the grids get swept: every cell takes the most of itself and its neighbors
+// (the neighbors falling off by the layer's spread), and fades away with the layer's half-life
+// Every row starts on a cache line and the sweep goes through it a SIMD width at a time (see FloatLanes in EVector2SoA.h)
+// A frame only sweeps a fixed amount of cells (picking up the next frame where it left off), so the cost per frame is fixed whatever the world's size
+// That budget's in cells instead of microseconds, so recorded runs replay the same
+class InfluenceMap final
+{
+public:
+	explicit InfluenceMap(float cellSize = 4.f, int cellsPerFrame = 1024);
+	~InfluenceMap() = default;
+
+	InfluenceMap(const InfluenceMap&) = delete;
+	InfluenceMap& operator=(const InfluenceMap&) = delete;
+
+	void Update(float deltaTime, const Perception& perception, const HouseMemory& houseMemory); // Once per frame, after the house memory
+	void Clear();
+	void DebugDraw(DebugDrawList& drawList) const; // The strongest layer of every cell that has any influence
+
+	float Get(eInfluenceLayer layer, const Elite::Vector2& position) const; // Between 0 and 1, 0 outside of the world
+	bool IsInWorld(const Elite::Vector2& position) const;
+
+private:
+	void SetUpGrid(const WorldInfo& world);
+	float* GetRow(eInfluenceLayer layer, int row) const { return m_pCells + size_t(layer) * m_LayerSize + m_RowPadding + size_t(row) * m_RowStride; }
+	bool GetCell(const Elite::Vector2& position, int& column, int& row) const; // False outside of the grid
+	void Stamp(eInfluenceLayer layer, const Elite::Vector2& position, float value); // Keeps the most of both
+	void StampCircle(eInfluenceLayer layer, const Elite::Vector2& center, float radius, float value);
+	void Erase(eInfluenceLayer layer, const Elite::Vector2& position);
+	void SweepRow(int row);
+
+	// Grid, every layer is m_Rows rows of m_RowStride floats (the cells past m_Columns stay 0), after m_RowPadding floats of 0
+	// so the first cell's left neighbor can be read as well
+	vector<float> m_Storage; // Layers, then the scratch rows, then a row of 0 (with a cache line of slack to align them)
+	float* m_pCells; // Where the layers start in m_Storage, on a cache line
+	float* m_pScratchRows; // Two per layer, what the previous and current row held before they got swept
+	const float* m_pZeroRow; // Neighbors of the rows along the border
+	size_t m_LayerSize;
+	size_t m_RowStride;
+	size_t m_RowPadding;
+	Elite::Vector2 m_GridMin;
+	const float m_CellSize;
+	int m_Columns;
+	int m_Rows;
+
+	// Sweeping
+	vector<float> m_RowSweepTimes; // When every row was last swept, to fade it by the time that passed since
+	const int m_CellsPerFrame;
+	int m_NextRow;
+	float m_Time;
+
+	// Per layer
+	const float m_HalfLives[size_t(eInfluenceLayer::Count)]{ 5.f, 60.f, 10.f }; // In seconds
+	const float m_Spreads[size_t(eInfluenceLayer::Count)]{ 0.7f, 0.5f, 0.4f }; // What's left of a cell's influence one cell further
+
+	const float m_UnlootedHouseLoot{ 0.75f }; // An item seen lying there is a sure 1
+	const float m_MinDrawnInfluence{ 0.05f };
+};
@@ -0,0 +1,246 @@
+#include "stdafx.h"
+#include "InterfaceCallCounter.h"
+
+InterfaceCallCounter::InterfaceCallCounter(IExamInterface* pInterface)
+	: m_pInterface(pInterface)
+	, m_CallsThisTick(0)
+	, m_FovCallsThisTick(0)
+	, m_CallsLastTick(0)
+	, m_FovCallsLastTick(0)
+	, m_TotalCalls(0)
+	, m_TotalTicks(0)
+{
+}
+
+void InterfaceCallCounter::BeginTick()
+{
+	m_CallsLastTick = m_CallsThisTick;
+	m_FovCallsLastTick = m_FovCallsThisTick;
+	m_TotalCalls += m_CallsThisTick;
+	++m_TotalTicks;
+
+	m_CallsThisTick = 0;
+	m_FovCallsThisTick = 0;
+}
+
+
+//WORLD & ENTITIES
+WorldInfo InterfaceCallCounter::World_GetInfo() const
+{
+	Count();
+	return m_pInterface->World_GetInfo();
+}
+
+StatisticsInfo InterfaceCallCounter::World_GetStats() const
+{
+	Count();
+	return m_pInterface->World_GetStats();
+}
+
+bool InterfaceCallCounter::Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const
+{
+	CountFov();
+	return m_pInterface->Fov_GetHouseByIndex(index, houseInfo);
+}
+
+bool InterfaceCallCounter::Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const
+{
+	CountFov();
+	return m_pInterface->Fov_GetEntityByIndex(index, enemyInfo);
+}
+
+AgentInfo InterfaceCallCounter::Agent_GetInfo() const
+{
+	Count();
+	return m_pInterface->Agent_GetInfo();
+}
+
+bool InterfaceCallCounter::Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy)
+{
+	CountFov();
+	return m_pInterface->Enemy_GetInfo(entity, enemy);
+}
+
+
+//NAVMESH
+Elite::Vector2 InterfaceCallCounter::NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const
+{
+	Count();
+	return m_pInterface->NavMesh_GetClosestPathPoint(goal);
+}
+
+
+//INVENTORY
+bool InterfaceCallCounter::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+	Count();
+	return m_pInterface->Inventory_AddItem(slotId, item);
+}
+
+bool InterfaceCallCounter::Inventory_UseItem(UINT slotId)
+{
+	Count();
+	return m_pInterface->Inventory_UseItem(slotId);
+}
+
+bool InterfaceCallCounter::Inventory_RemoveItem(UINT slotId)
+{
+	Count();
+	return m_pInterface->Inventory_RemoveItem(slotId);
+}
+
+bool InterfaceCallCounter::Inventory_GetItem(UINT slotId, ItemInfo& item)
+{
+	Count();
+	return m_pInterface->Inventory_GetItem(slotId, item);
+}
+
+UINT InterfaceCallCounter::Inventory_GetCapacity() const
+{
+	Count();
+	return m_pInterface->Inventory_GetCapacity();
+}
+
+bool InterfaceCallCounter::Item_GetInfo(EntityInfo entity, ItemInfo& item)
+{
+	Count();
+	return m_pInterface->Item_GetInfo(entity, item);
+}
+
+bool InterfaceCallCounter::Item_Grab(EntityInfo entity, ItemInfo& item)
+{
+	Count();
+	return m_pInterface->Item_Grab(entity, item);
+}
+
+bool InterfaceCallCounter::Item_Destroy(EntityInfo entity)
+{
+	Count();
+	return m_pInterface->Item_Destroy(entity);
+}
+
+int InterfaceCallCounter::Weapon_GetAmmo(ItemInfo& item)
+{
+	Count();
+	return m_pInterface->Weapon_GetAmmo(item);
+}
+
+int InterfaceCallCounter::Medkit_GetHealth(ItemInfo& item)
+{
+	Count();
+	return m_pInterface->Medkit_GetHealth(item);
+}
+
+int InterfaceCallCounter::Food_GetEnergy(ItemInfo& item)
+{
+	Count();
+	return m_pInterface->Food_GetEnergy(item);
+}
+
+
+//PURGEZONE
+bool InterfaceCallCounter::PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone)
+{
+	CountFov();
+	return m_pInterface->PurgeZone_GetInfo(entity, zone);
+}
+
+
+//DEBUG
+Elite::Vector2 InterfaceCallCounter::Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const
+{
+	Count();
+	return m_pInterface->Debug_ConvertScreenToWorld(screenPos);
+}
+
+Elite::Vector2 InterfaceCallCounter::Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const
+{
+	Count();
+	return m_pInterface->Debug_ConvertWorldToScreen(worldPos);
+}
+
+
+//INPUT
+bool InterfaceCallCounter::Input_IsKeyboardKeyDown(Elite::InputScancode key) const
+{
+	Count();
+	return m_pInterface->Input_IsKeyboardKeyDown(key);
+}
+
+bool InterfaceCallCounter::Input_IsKeyboardKeyUp(Elite::InputScancode key) const
+{
+	Count();
+	return m_pInterface->Input_IsKeyboardKeyUp(key);
+}
+
+bool InterfaceCallCounter::Input_IsMouseButtonDown(Elite::InputMouseButton button) const
+{
+	Count();
+	return m_pInterface->Input_IsMouseButtonDown(button);
+}
+
+bool InterfaceCallCounter::Input_IsMouseButtonUp(Elite::InputMouseButton button) const
+{
+	Count();
+	return m_pInterface->Input_IsMouseButtonUp(button);
+}
+
+Elite::MouseData InterfaceCallCounter::Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button) const
+{
+	Count();
+	return m_pInterface->Input_GetMouseData(type, button);
+}
+
+
+//EVENT
+void InterfaceCallCounter::RequestShutdown() const
+{
+	m_pInterface->RequestShutdown();
+}
+
+
+//RENDERER
+void InterfaceCallCounter::Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Polygon(points, count, color, depth);
+}
+
+void InterfaceCallCounter::Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate)
+{
+	m_pInterface->Draw_SolidPolygon(points, count, color, depth, triangulate);
+}
+
+void InterfaceCallCounter::Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Circle(center, radius, color, depth);
+}
+
+void InterfaceCallCounter::Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_SolidCircle(center, radius, axis, color, depth);
+}
+
+void InterfaceCallCounter::Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Segment(p1, p2, color, depth);
+}
+
+void InterfaceCallCounter::Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Direction(p, dir, length, color, depth);
+}
+
+void InterfaceCallCounter::Draw_Transform(const b2Transform& xf, float depth)
+{
+	m_pInterface->Draw_Transform(xf, depth);
+}
+
+void InterfaceCallCounter::Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Point(p, size, color, depth);
+}
+
+float InterfaceCallCounter::NextDepthSlice()
+{
+	return m_pInterface->NextDepthSlice();
+}
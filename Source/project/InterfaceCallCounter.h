@@ -0,0 +1,87 @@
+#pragma once
+#include <IExamInterface.h>
+
+// Decorator around the AI Framework's interface, forwarding every call while counting them
+// Used to measure how many times the plugin crosses the interface each tick
+class InterfaceCallCounter final : public IExamInterface
+{
+public:
+	InterfaceCallCounter(IExamInterface* pInterface);
+	~InterfaceCallCounter() = default;
+
+	void BeginTick(); // Closes the previous tick's count and starts a new one
+
+	IExamInterface* GetWrappedInterface() const { return m_pInterface; }
+	unsigned int GetCallsLastTick() const { return m_CallsLastTick; }
+	unsigned int GetFovCallsLastTick() const { return m_FovCallsLastTick; }
+	unsigned long long GetTotalCalls() const { return m_TotalCalls; }
+	unsigned long long GetTotalTicks() const { return m_TotalTicks; }
+
+	//WORLD & ENTITIES
+	WorldInfo World_GetInfo() const override;
+	StatisticsInfo World_GetStats() const override;
+	bool Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const override;
+	bool Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const override;
+	AgentInfo Agent_GetInfo() const override;
+	bool Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy) override;
+
+	//NAVMESH
+	Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override;
+
+	//INVENTORY
+	bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+	bool Inventory_UseItem(UINT slotId) override;
+	bool Inventory_RemoveItem(UINT slotId) override;
+	bool Inventory_GetItem(UINT slotId, ItemInfo& item) override;
+	UINT Inventory_GetCapacity() const override;
+
+	bool Item_GetInfo(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Grab(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Destroy(EntityInfo entity) override;
+
+	int Weapon_GetAmmo(ItemInfo& item) override;
+	int Medkit_GetHealth(ItemInfo& item) override;
+	int Food_GetEnergy(ItemInfo& item) override;
+
+	//PURGEZONE
+	bool PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone) override;
+
+	//DEBUG
+	Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override;
+	Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override;
+
+	//INPUT
+	bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override;
+	bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override;
+	bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override;
+	bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override;
+	Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button = Elite::InputMouseButton(0)) const override;
+
+	//EVENT
+	void RequestShutdown() const override;
+
+	//RENDERER (not counted, rendering isn't part of the tick)
+	void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override;
+	void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate = false) override;
+	void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override;
+	void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override;
+	void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override;
+	void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth = 0.9f) override;
+	void Draw_Transform(const b2Transform& xf, float depth) override;
+	void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override;
+	float NextDepthSlice() override;
+
+private:
+	void Count() const { ++m_CallsThisTick; }
+	void CountFov() const { ++m_CallsThisTick; ++m_FovCallsThisTick; }
+
+	IExamInterface* m_pInterface;
+
+	// Mutable since most interface queries are const
+	mutable unsigned int m_CallsThisTick;
+	mutable unsigned int m_FovCallsThisTick;
+	unsigned int m_CallsLastTick;
+	unsigned int m_FovCallsLastTick;
+	unsigned long long m_TotalCalls;
+	unsigned long long m_TotalTicks;
+};
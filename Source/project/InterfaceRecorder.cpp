@@ -0,0 +1,288 @@
+#include "stdafx.h"
+#include "InterfaceRecorder.h"
+
+InterfaceRecorder::InterfaceRecorder(IExamInterface* pInterface)
+	: m_pInterface(pInterface)
+	, m_Writer()
+{
+}
+
+bool InterfaceRecorder::Start(const string& filePath, int seed)
+{
+	RecordingHeader header{};
+	header.Seed = seed;
+	return m_Writer.Open(filePath, header);
+}
+
+void InterfaceRecorder::Stop()
+{
+	m_Writer.Close();
+}
+
+void InterfaceRecorder::BeginFrame(float deltaTime)
+{
+	Record(eRecordedCall::Frame, 0, deltaTime);
+}
+
+void InterfaceRecorder::EndFrame(const SteeringPlugin_Output& steering)
+{
+	Record(eRecordedCall::Steering, 0, steering);
+}
+
+bool InterfaceRecorder::BeginRecord(eRecordedCall call, uint32_t key) const
+{
+	if (m_Writer.IsOpen() == false)
+		return false;
+
+	m_Writer.BeginRecord(call, key);
+	return true;
+}
+
+
+//WORLD & ENTITIES
+WorldInfo InterfaceRecorder::World_GetInfo() const
+{
+	const auto world = m_pInterface->World_GetInfo();
+	Record(eRecordedCall::World_GetInfo, 0, world);
+	return world;
+}
+
+StatisticsInfo InterfaceRecorder::World_GetStats() const
+{
+	const auto stats = m_pInterface->World_GetStats();
+	Record(eRecordedCall::World_GetStats, 0, stats);
+	return stats;
+}
+
+bool InterfaceRecorder::Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const
+{
+	const auto found = m_pInterface->Fov_GetHouseByIndex(index, houseInfo);
+	RecordIfFound(eRecordedCall::Fov_GetHouseByIndex, index, found, houseInfo);
+	return found;
+}
+
+bool InterfaceRecorder::Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const
+{
+	const auto found = m_pInterface->Fov_GetEntityByIndex(index, enemyInfo);
+	RecordIfFound(eRecordedCall::Fov_GetEntityByIndex, index, found, enemyInfo);
+	return found;
+}
+
+AgentInfo InterfaceRecorder::Agent_GetInfo() const
+{
+	const auto agent = m_pInterface->Agent_GetInfo();
+	Record(eRecordedCall::Agent_GetInfo, 0, agent);
+	return agent;
+}
+
+bool InterfaceRecorder::Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy)
+{
+	const auto found = m_pInterface->Enemy_GetInfo(entity, enemy);
+	RecordIfFound(eRecordedCall::Enemy_GetInfo, 0, found, enemy);
+	return found;
+}
+
+
+//NAVMESH
+Elite::Vector2 InterfaceRecorder::NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const
+{
+	const auto pathPoint = m_pInterface->NavMesh_GetClosestPathPoint(goal);
+	Record(eRecordedCall::NavMesh_GetClosestPathPoint, 0, pathPoint);
+	return pathPoint;
+}
+
+
+//INVENTORY
+bool InterfaceRecorder::Inventory_AddItem(UINT slotId, ItemInfo item)
+{
+	const auto added = m_pInterface->Inventory_AddItem(slotId, item);
+	Record(eRecordedCall::Inventory_AddItem, slotId, added);
+	return added;
+}
+
+bool InterfaceRecorder::Inventory_UseItem(UINT slotId)
+{
+	const auto used = m_pInterface->Inventory_UseItem(slotId);
+	Record(eRecordedCall::Inventory_UseItem, slotId, used);
+	return used;
+}
+
+bool InterfaceRecorder::Inventory_RemoveItem(UINT slotId)
+{
+	const auto removed = m_pInterface->Inventory_RemoveItem(slotId);
+	Record(eRecordedCall::Inventory_RemoveItem, slotId, removed);
+	return removed;
+}
+
+bool InterfaceRecorder::Inventory_GetItem(UINT slotId, ItemInfo& item)
+{
+	const auto found = m_pInterface->Inventory_GetItem(slotId, item);
+	RecordIfFound(eRecordedCall::Inventory_GetItem, slotId, found, item);
+	return found;
+}
+
+UINT InterfaceRecorder::Inventory_GetCapacity() const
+{
+	const auto capacity = m_pInterface->Inventory_GetCapacity();
+	Record(eRecordedCall::Inventory_GetCapacity, 0, int(capacity));
+	return capacity;
+}
+
+bool InterfaceRecorder::Item_GetInfo(EntityInfo entity, ItemInfo& item)
+{
+	const auto found = m_pInterface->Item_GetInfo(entity, item);
+	RecordIfFound(eRecordedCall::Item_GetInfo, 0, found, item);
+	return found;
+}
+
+bool InterfaceRecorder::Item_Grab(EntityInfo entity, ItemInfo& item)
+{
+	const auto grabbed = m_pInterface->Item_Grab(entity, item);
+	RecordIfFound(eRecordedCall::Item_Grab, 0, grabbed, item);
+	return grabbed;
+}
+
+bool InterfaceRecorder::Item_Destroy(EntityInfo entity)
+{
+	const auto destroyed = m_pInterface->Item_Destroy(entity);
+	Record(eRecordedCall::Item_Destroy, 0, destroyed);
+	return destroyed;
+}
+
+int InterfaceRecorder::Weapon_GetAmmo(ItemInfo& item)
+{
+	const auto ammo = m_pInterface->Weapon_GetAmmo(item);
+	Record(eRecordedCall::Weapon_GetAmmo, 0, ammo);
+	return ammo;
+}
+
+int InterfaceRecorder::Medkit_GetHealth(ItemInfo& item)
+{
+	const auto health = m_pInterface->Medkit_GetHealth(item);
+	Record(eRecordedCall::Medkit_GetHealth, 0, health);
+	return health;
+}
+
+int InterfaceRecorder::Food_GetEnergy(ItemInfo& item)
+{
+	const auto energy = m_pInterface->Food_GetEnergy(item);
+	Record(eRecordedCall::Food_GetEnergy, 0, energy);
+	return energy;
+}
+
+
+//PURGEZONE
+bool InterfaceRecorder::PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone)
+{
+	const auto found = m_pInterface->PurgeZone_GetInfo(entity, zone);
+	RecordIfFound(eRecordedCall::PurgeZone_GetInfo, 0, found, zone);
+	return found;
+}
+
+
+//DEBUG
+Elite::Vector2 InterfaceRecorder::Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const
+{
+	const auto worldPos = m_pInterface->Debug_ConvertScreenToWorld(screenPos);
+	Record(eRecordedCall::Debug_ConvertScreenToWorld, 0, worldPos);
+	return worldPos;
+}
+
+Elite::Vector2 InterfaceRecorder::Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const
+{
+	const auto screenPos = m_pInterface->Debug_ConvertWorldToScreen(worldPos);
+	Record(eRecordedCall::Debug_ConvertWorldToScreen, 0, screenPos);
+	return screenPos;
+}
+
+
+//INPUT
+bool InterfaceRecorder::Input_IsKeyboardKeyDown(Elite::InputScancode key) const
+{
+	const auto down = m_pInterface->Input_IsKeyboardKeyDown(key);
+	Record(eRecordedCall::Input_IsKeyboardKeyDown, uint32_t(key), down);
+	return down;
+}
+
+bool InterfaceRecorder::Input_IsKeyboardKeyUp(Elite::InputScancode key) const
+{
+	const auto up = m_pInterface->Input_IsKeyboardKeyUp(key);
+	Record(eRecordedCall::Input_IsKeyboardKeyUp, uint32_t(key), up);
+	return up;
+}
+
+bool InterfaceRecorder::Input_IsMouseButtonDown(Elite::InputMouseButton button) const
+{
+	const auto down = m_pInterface->Input_IsMouseButtonDown(button);
+	Record(eRecordedCall::Input_IsMouseButtonDown, uint32_t(button), down);
+	return down;
+}
+
+bool InterfaceRecorder::Input_IsMouseButtonUp(Elite::InputMouseButton button) const
+{
+	const auto up = m_pInterface->Input_IsMouseButtonUp(button);
+	Record(eRecordedCall::Input_IsMouseButtonUp, uint32_t(button), up);
+	return up;
+}
+
+Elite::MouseData InterfaceRecorder::Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button) const
+{
+	const auto mouseData = m_pInterface->Input_GetMouseData(type, button);
+	Record(eRecordedCall::Input_GetMouseData, uint32_t(type), mouseData);
+	return mouseData;
+}
+
+
+//EVENT
+void InterfaceRecorder::RequestShutdown() const
+{
+	BeginRecord(eRecordedCall::RequestShutdown);
+	m_pInterface->RequestShutdown();
+}
+
+
+//RENDERER
+void InterfaceRecorder::Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Polygon(points, count, color, depth);
+}
+
+void InterfaceRecorder::Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate)
+{
+	m_pInterface->Draw_SolidPolygon(points, count, color, depth, triangulate);
+}
+
+void InterfaceRecorder::Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Circle(center, radius, color, depth);
+}
+
+void InterfaceRecorder::Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_SolidCircle(center, radius, axis, color, depth);
+}
+
+void InterfaceRecorder::Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Segment(p1, p2, color, depth);
+}
+
+void InterfaceRecorder::Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Direction(p, dir, length, color, depth);
+}
+
+void InterfaceRecorder::Draw_Transform(const b2Transform& xf, float depth)
+{
+	m_pInterface->Draw_Transform(xf, depth);
+}
+
+void InterfaceRecorder::Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth)
+{
+	m_pInterface->Draw_Point(p, size, color, depth);
+}
+
+float InterfaceRecorder::NextDepthSlice()
+{
+	return m_pInterface->NextDepthSlice();
+}
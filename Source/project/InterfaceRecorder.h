@@ -0,0 +1,105 @@
+#pragma once
+#include <IExamInterface.h>
+#include "InterfaceRecording.h"
+
+// Decorator around the AI Framework's interface, forwarding every call while recording what came back (see InterfaceRecording.h)
+// The plugin only depends on its seed and on what the interface tells it, so a recording is enough to replay a whole run without the game
+// Define RECORDING_ENABLED=0 project-wide to stop the plugin from recording itself (the headless tools do, they can record on request)
+#ifndef RECORDING_ENABLED
+#define RECORDING_ENABLED 1
+#endif
+
+class InterfaceRecorder final : public IExamInterface
+{
+public:
+	InterfaceRecorder(IExamInterface* pInterface);
+	~InterfaceRecorder() = default;
+
+	bool Start(const string& filePath, int seed); // Until then, calls only get forwarded
+	void Stop(); // Writes out whatever is still buffered
+	bool IsRecording() const { return m_Writer.IsOpen(); }
+	uint64_t GetBytesRecorded() const { return m_Writer.GetBytesWritten(); }
+
+	// Around every plugin update
+	void BeginFrame(float deltaTime);
+	void EndFrame(const SteeringPlugin_Output& steering);
+
+	//WORLD & ENTITIES
+	WorldInfo World_GetInfo() const override;
+	StatisticsInfo World_GetStats() const override;
+	bool Fov_GetHouseByIndex(UINT index, HouseInfo& houseInfo) const override;
+	bool Fov_GetEntityByIndex(UINT index, EntityInfo& enemyInfo) const override;
+	AgentInfo Agent_GetInfo() const override;
+	bool Enemy_GetInfo(EntityInfo entity, EnemyInfo& enemy) override;
+
+	//NAVMESH
+	Elite::Vector2 NavMesh_GetClosestPathPoint(Elite::Vector2 goal) const override;
+
+	//INVENTORY
+	bool Inventory_AddItem(UINT slotId, ItemInfo item) override;
+	bool Inventory_UseItem(UINT slotId) override;
+	bool Inventory_RemoveItem(UINT slotId) override;
+	bool Inventory_GetItem(UINT slotId, ItemInfo& item) override;
+	UINT Inventory_GetCapacity() const override;
+
+	bool Item_GetInfo(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Grab(EntityInfo entity, ItemInfo& item) override;
+	bool Item_Destroy(EntityInfo entity) override;
+
+	int Weapon_GetAmmo(ItemInfo& item) override;
+	int Medkit_GetHealth(ItemInfo& item) override;
+	int Food_GetEnergy(ItemInfo& item) override;
+
+	//PURGEZONE
+	bool PurgeZone_GetInfo(EntityInfo entity, PurgeZoneInfo& zone) override;
+
+	//DEBUG
+	Elite::Vector2 Debug_ConvertScreenToWorld(Elite::Vector2 screenPos) const override;
+	Elite::Vector2 Debug_ConvertWorldToScreen(Elite::Vector2 worldPos) const override;
+
+	//INPUT
+	bool Input_IsKeyboardKeyDown(Elite::InputScancode key) const override;
+	bool Input_IsKeyboardKeyUp(Elite::InputScancode key) const override;
+	bool Input_IsMouseButtonDown(Elite::InputMouseButton button) const override;
+	bool Input_IsMouseButtonUp(Elite::InputMouseButton button) const override;
+	Elite::MouseData Input_GetMouseData(Elite::InputType type, Elite::InputMouseButton button = Elite::InputMouseButton(0)) const override;
+
+	//EVENT
+	void RequestShutdown() const override;
+
+	//RENDERER (not recorded, nothing comes back from drawing)
+	void Draw_Polygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth) override;
+	void Draw_SolidPolygon(const Elite::Vector2* points, int count, const Elite::Vector3& color, float depth, bool triangulate = false) override;
+	void Draw_Circle(const Elite::Vector2& center, float radius, const Elite::Vector3& color, float depth) override;
+	void Draw_SolidCircle(const Elite::Vector2& center, float32 radius, const Elite::Vector2& axis, const Elite::Vector3& color, float depth) override;
+	void Draw_Segment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Elite::Vector3& color, float depth) override;
+	void Draw_Direction(const Elite::Vector2& p, Elite::Vector2 dir, float length, const Elite::Vector3& color, float depth = 0.9f) override;
+	void Draw_Transform(const b2Transform& xf, float depth) override;
+	void Draw_Point(const Elite::Vector2& p, float size, const Elite::Vector3& color, float depth) override;
+	float NextDepthSlice() override;
+
+private:
+	bool BeginRecord(eRecordedCall call, uint32_t key = 0) const; // False when not recording
+
+	template<typename T>
+	void Record(eRecordedCall call, uint32_t key, T result) const
+	{
+		if (BeginRecord(call, key))
+			SerializeValue(m_Writer, result);
+	}
+
+	// For the queries that can fail, the result only gets recorded when they didn't
+	template<typename T>
+	void RecordIfFound(eRecordedCall call, uint32_t key, bool found, T result) const
+	{
+		if (BeginRecord(call, key))
+		{
+			m_Writer.Value(found);
+			if (found)
+				SerializeValue(m_Writer, result);
+		}
+	}
+
+	IExamInterface* m_pInterface;
+	mutable RecordingWriter m_Writer; // Mutable since most interface queries are const
+};
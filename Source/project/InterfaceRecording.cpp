@@ -0,0 +1,236 @@
+#include "stdafx.h"
+#include "InterfaceRecording.h"
+#include <cstring>
+
+namespace
+{
+	const char g_Magic[4]{ 'Z', 'S', 'R', 'C' };
+	const uint8_t g_Version{ 1 };
+
+	// Channels: per call, per index argument (the higher ones share the last) and per field
+	const uint32_t g_MaxKeys{ 64 };
+	const uint32_t g_MaxFields{ 32 };
+
+	const size_t g_FlushSize{ 1 << 16 };
+
+	uint32_t ZigZag(int32_t value)
+	{
+		return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+	}
+
+	int32_t UnZigZag(uint32_t value)
+	{
+		return int32_t(value >> 1) ^ -int32_t(value & 1);
+	}
+
+	uint32_t ToBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	float FromBits(uint32_t bits)
+	{
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+
+// CODEC
+RecordingCodec::RecordingCodec()
+	: m_Channels(size_t(eRecordedCall::_Count) * g_MaxKeys * g_MaxFields, 0)
+	, m_RecordChannel(0)
+	, m_Field(0)
+{
+}
+
+void RecordingCodec::SelectRecord(eRecordedCall call, uint32_t key)
+{
+	m_RecordChannel = (uint32_t(call) * g_MaxKeys + min(key, g_MaxKeys - 1)) * g_MaxFields;
+	m_Field = 0;
+}
+
+uint32_t& RecordingCodec::NextChannel()
+{
+	assert(m_Field < g_MaxFields);
+	return m_Channels[m_RecordChannel + min(m_Field++, g_MaxFields - 1)];
+}
+
+
+// WRITER
+RecordingWriter::~RecordingWriter()
+{
+	Close();
+}
+
+bool RecordingWriter::Open(const string& filePath, const RecordingHeader& header)
+{
+	Close();
+
+	m_File.open(filePath, ios::binary | ios::trunc);
+	if (!m_File)
+		return false;
+
+	m_Buffer.reserve(g_FlushSize * 2);
+	m_Buffer.insert(m_Buffer.end(), begin(g_Magic), end(g_Magic));
+	m_Buffer.push_back(g_Version);
+	WriteVarint(ZigZag(header.Seed));
+	return true;
+}
+
+void RecordingWriter::Close()
+{
+	if (m_File.is_open() == false)
+		return;
+
+	Flush();
+	m_File.close();
+}
+
+void RecordingWriter::BeginRecord(eRecordedCall call, uint32_t key)
+{
+	// Only whole frames get written out, so a recording that got cut off still ends cleanly (apart from its last frame)
+	if (call == eRecordedCall::Frame && m_Buffer.size() >= g_FlushSize)
+		Flush();
+
+	SelectRecord(call, key);
+	m_Buffer.push_back(uint8_t(call));
+	WriteVarint(key);
+}
+
+void RecordingWriter::Value(int& value)
+{
+	auto& previous = NextChannel();
+	WriteVarint(ZigZag(int32_t(uint32_t(value) - previous)));
+	previous = uint32_t(value);
+}
+
+void RecordingWriter::Value(float& value)
+{
+	auto& previous = NextChannel();
+	const auto bits = ToBits(value);
+	WriteVarint(bits ^ previous);
+	previous = bits;
+}
+
+void RecordingWriter::Value(bool& value)
+{
+	m_Buffer.push_back(value ? 1 : 0);
+}
+
+void RecordingWriter::Value(Elite::Vector2& value)
+{
+	Value(value.x);
+	Value(value.y);
+}
+
+void RecordingWriter::WriteVarint(uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		m_Buffer.push_back(uint8_t(value) | 0x80);
+		value >>= 7;
+	}
+	m_Buffer.push_back(uint8_t(value));
+}
+
+void RecordingWriter::Flush()
+{
+	m_File.write(reinterpret_cast<const char*>(m_Buffer.data()), streamsize(m_Buffer.size()));
+	m_File.flush();
+	m_BytesWritten += m_Buffer.size();
+	m_Buffer.clear();
+}
+
+
+// READER
+RecordingReader::RecordingReader()
+	: m_File()
+	, m_Position(0)
+	, m_Diverged(false)
+	, m_CutOff(false)
+{
+}
+
+bool RecordingReader::Open(const string& filePath, RecordingHeader& header)
+{
+	m_Position = 0;
+	m_Diverged = false;
+	m_CutOff = false;
+	if (m_File.Open(filePath) == false)
+		return false;
+
+	if (m_File.GetSize() < sizeof(g_Magic) + 1 || memcmp(m_File.GetData(), g_Magic, sizeof(g_Magic)) != 0 || m_File.GetData()[sizeof(g_Magic)] != g_Version)
+	{
+		m_File.Close();
+		return false;
+	}
+
+	m_Position = sizeof(g_Magic) + 1;
+	header.Seed = UnZigZag(uint32_t(ReadVarint()));
+	return m_CutOff == false;
+}
+
+bool RecordingReader::BeginRecord(eRecordedCall call, uint32_t key)
+{
+	if (m_Diverged || m_CutOff || IsAtEnd())
+		return false;
+
+	const auto recordedCall = eRecordedCall(m_File.GetData()[m_Position++]);
+	const auto recordedKey = uint32_t(ReadVarint());
+	if (recordedCall != call || recordedKey != key)
+	{
+		m_Diverged = true;
+		return false;
+	}
+
+	SelectRecord(call, key);
+	return true;
+}
+
+void RecordingReader::Value(int& value)
+{
+	auto& previous = NextChannel();
+	previous += uint32_t(UnZigZag(uint32_t(ReadVarint())));
+	value = int(previous);
+}
+
+void RecordingReader::Value(float& value)
+{
+	auto& previous = NextChannel();
+	previous ^= uint32_t(ReadVarint());
+	value = FromBits(previous);
+}
+
+void RecordingReader::Value(bool& value)
+{
+	value = ReadVarint() != 0;
+}
+
+void RecordingReader::Value(Elite::Vector2& value)
+{
+	Value(value.x);
+	Value(value.y);
+}
+
+uint64_t RecordingReader::ReadVarint()
+{
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (IsAtEnd())
+			break;
+
+		const auto byte = m_File.GetData()[m_Position++];
+		value |= uint64_t(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+			return value;
+	}
+
+	// Cut off (or corrupt)
+	m_CutOff = true;
+	return 0;
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include <cstdint>
+#include <Exam_HelperStructs.h>
+#include "MappedFile.h"
+
+// Binary format of interface recordings (see InterfaceRecorder, written in the game or headless, and InterfaceReplayer, which plays them back)
+// After the header, a recording is a stream of records: the call (1 byte), its index or slot argument (varint, 0 when it has none)
+// and then its results. Every frame starts with a Frame record (the delta time) and ends with the plugin's Steering
+//
+// Every field of every record gets its own channel, keyed by the call, its index argument and the field, and is stored as a varint
+// delta against the previous value in that channel (ints zigzag-encoded, floats XOR'ed bit for bit, so it's lossless)
+// Since most of what the plugin sees barely changes between frames, most fields end up being a single byte
+enum class eRecordedCall : uint8_t
+{
+	// Frame markers
+	Frame,
+	Steering,
+
+	// One per IExamInterface query or action
+	World_GetInfo,
+	World_GetStats,
+	Fov_GetHouseByIndex,
+	Fov_GetEntityByIndex,
+	Agent_GetInfo,
+	Enemy_GetInfo,
+	NavMesh_GetClosestPathPoint,
+	Inventory_AddItem,
+	Inventory_UseItem,
+	Inventory_RemoveItem,
+	Inventory_GetItem,
+	Inventory_GetCapacity,
+	Item_GetInfo,
+	Item_Grab,
+	Item_Destroy,
+	Weapon_GetAmmo,
+	Medkit_GetHealth,
+	Food_GetEnergy,
+	PurgeZone_GetInfo,
+	Debug_ConvertScreenToWorld,
+	Debug_ConvertWorldToScreen,
+	Input_IsKeyboardKeyDown,
+	Input_IsKeyboardKeyUp,
+	Input_IsMouseButtonDown,
+	Input_IsMouseButtonUp,
+	Input_GetMouseData,
+	RequestShutdown,
+
+	_Count
+};
+
+struct RecordingHeader
+{
+	int Seed = 0; // The game's, which the plugin seeds itself with
+};
+
+// Delta state, shared by the writer and the reader (they have to end up with the same channels)
+class RecordingCodec
+{
+public:
+	RecordingCodec();
+	virtual ~RecordingCodec() = default;
+
+protected:
+	void SelectRecord(eRecordedCall call, uint32_t key);
+	uint32_t& NextChannel(); // Previous value of the next field in the current record
+
+private:
+	vector<uint32_t> m_Channels;
+	uint32_t m_RecordChannel;
+	uint32_t m_Field;
+};
+
+// Appends records to a recording file (buffered, it gets written out in chunks)
+class RecordingWriter final : public RecordingCodec
+{
+public:
+	RecordingWriter() = default;
+	~RecordingWriter() override;
+
+	RecordingWriter(const RecordingWriter&) = delete;
+	RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+	bool Open(const string& filePath, const RecordingHeader& header);
+	void Close(); // Flushes whatever is still buffered
+	bool IsOpen() const { return m_File.is_open(); }
+	uint64_t GetBytesWritten() const { return m_BytesWritten + m_Buffer.size(); }
+
+	void BeginRecord(eRecordedCall call, uint32_t key = 0);
+	void Value(int& value);
+	void Value(float& value);
+	void Value(bool& value);
+	void Value(Elite::Vector2& value);
+	template<typename Enum>
+	void Value(Enum& value) { static_assert(is_enum<Enum>::value, "Only enums"); int intValue = int(value); Value(intValue); }
+
+private:
+	void WriteVarint(uint64_t value);
+	void Flush();
+
+	ofstream m_File;
+	vector<uint8_t> m_Buffer;
+	uint64_t m_BytesWritten{};
+};
+
+// Reads records back, in the order they were written
+// Asking for a different record than the next one marks the recording as diverged, after which every read fails (same once it runs out mid-record)
+class RecordingReader final : public RecordingCodec
+{
+public:
+	RecordingReader();
+	~RecordingReader() override = default;
+
+	bool Open(const string& filePath, RecordingHeader& header);
+
+	bool BeginRecord(eRecordedCall call, uint32_t key = 0); // False at the end of the recording, or once it diverged or got cut off
+	void Value(int& value);
+	void Value(float& value);
+	void Value(bool& value);
+	void Value(Elite::Vector2& value);
+	template<typename Enum>
+	void Value(Enum& value) { static_assert(is_enum<Enum>::value, "Only enums"); int intValue = int(value); Value(intValue); value = Enum(intValue); }
+
+	bool HasDiverged() const { return m_Diverged; }
+	bool IsCutOff() const { return m_CutOff; } // It ended in the middle of a record
+	bool IsAtEnd() const { return m_Position >= m_File.GetSize(); }
+	uint64_t GetSize() const { return m_File.GetSize(); }
+
+private:
+	uint64_t ReadVarint();
+
+	MappedFile m_File;
+	size_t m_Position;
+	bool m_Diverged;
+	bool m_CutOff;
+};
+
+// Every record's fields, the same code for writing and reading
+template<typename Archive>
+void SerializeValue(Archive& archive, int& value) { archive.Value(value); }
+
+template<typename Archive>
+void SerializeValue(Archive& archive, float& value) { archive.Value(value); }
+
+template<typename Archive>
+void SerializeValue(Archive& archive, bool& value) { archive.Value(value); }
+
+template<typename Archive>
+void SerializeValue(Archive& archive, Elite::Vector2& value) { archive.Value(value); }
+
+template<typename Archive>
+void SerializeValue(Archive& archive, SteeringPlugin_Output& steering)
+{
+	archive.Value(steering.LinearVelocity);
+	archive.Value(steering.AngularVelocity);
+	archive.Value(steering.AutoOrient);
+	archive.Value(steering.RunMode);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, WorldInfo& world)
+{
+	archive.Value(world.Center);
+	archive.Value(world.Dimensions);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, StatisticsInfo& stats)
+{
+	archive.Value(stats.Score);
+	archive.Value(stats.Difficulty);
+	archive.Value(stats.TimeSurvived);
+	archive.Value(stats.KillCountdown);
+	archive.Value(stats.NumEnemiesKilled);
+	archive.Value(stats.NumEnemiesHit);
+	archive.Value(stats.NumItemsPickUp);
+	archive.Value(stats.NumMissedShots);
+	archive.Value(stats.NumChkpntsReached);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, HouseInfo& house)
+{
+	archive.Value(house.Center);
+	archive.Value(house.Size);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, EntityInfo& entity)
+{
+	archive.Value(entity.Type);
+	archive.Value(entity.Location);
+	archive.Value(entity.EntityHash);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, AgentInfo& agent)
+{
+	archive.Value(agent.Stamina);
+	archive.Value(agent.Health);
+	archive.Value(agent.Energy);
+	archive.Value(agent.RunMode);
+	archive.Value(agent.IsInHouse);
+	archive.Value(agent.Bitten);
+	archive.Value(agent.WasBitten);
+	archive.Value(agent.Death);
+	archive.Value(agent.FOV_Angle);
+	archive.Value(agent.FOV_Range);
+	archive.Value(agent.LinearVelocity);
+	archive.Value(agent.AngularVelocity);
+	archive.Value(agent.CurrentLinearSpeed);
+	archive.Value(agent.Position);
+	archive.Value(agent.Orientation);
+	archive.Value(agent.MaxLinearSpeed);
+	archive.Value(agent.MaxAngularSpeed);
+	archive.Value(agent.GrabRange);
+	archive.Value(agent.AgentSize);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, EnemyInfo& enemy)
+{
+	archive.Value(enemy.Type);
+	archive.Value(enemy.Location);
+	archive.Value(enemy.LinearVelocity);
+	archive.Value(enemy.EnemyHash);
+	archive.Value(enemy.Size);
+	archive.Value(enemy.Health);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, ItemInfo& item)
+{
+	archive.Value(item.Type);
+	archive.Value(item.Location);
+	archive.Value(item.ItemHash);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, PurgeZoneInfo& zone)
+{
+	archive.Value(zone.Center);
+	archive.Value(zone.Radius);
+	archive.Value(zone.ZoneHash);
+}
+
+template<typename Archive>
+void SerializeValue(Archive& archive, Elite::MouseData& mouse)
+{
+	archive.Value(mouse.TimeStamp);
+	archive.Value(mouse.Button);
+	archive.Value(mouse.X);
+	archive.Value(mouse.Y);
+	archive.Value(mouse.XRel);
+	archive.Value(mouse.YRel);
+}
@@ -0,0 +1,238 @@
+#include "stdafx.h"
+#include "Inventory.h"
+#include <IExamInterface.h>
+#include <cassert>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	int GetLowestBit(uint32_t mask) // -1 if none is set
+	{
+		if (mask == 0)
+			return -1;
+#if defined(_MSC_VER)
+		unsigned long bit = 0;
+		_BitScanForward(&bit, mask);
+		return int(bit);
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	int CountBits(uint32_t mask)
+	{
+		int count = 0;
+		for (; mask != 0; mask &= mask - 1)
+			++count;
+		return count;
+	}
+}
+
+Inventory::Inventory(IExamInterface* pInterface)
+	: m_pInterface(pInterface)
+	, m_pEvents(nullptr)
+	, m_Capacity(0)
+	, m_Slots()
+	, m_OccupiedMask(0)
+	, m_TypeMasks()
+	, m_Heaps()
+	, m_HeapSizes()
+{
+	const auto capacity = m_pInterface->Inventory_GetCapacity();
+	assert(capacity <= UINT(m_MaxSlots));
+	m_Capacity = min(capacity, UINT(m_MaxSlots));
+
+	for (UINT slot = 0; slot < m_Capacity; ++slot)
+	{
+		ItemInfo item{};
+		if (m_pInterface->Inventory_GetItem(slot, item))
+			Store(slot, item, QueryUnits(item));
+	}
+}
+
+int Inventory::GetEmptySlot() const
+{
+	const auto emptyMask = ~m_OccupiedMask & (m_Capacity < 32 ? (1u << m_Capacity) - 1u : UINT32_MAX);
+	return GetLowestBit(emptyMask);
+}
+
+int Inventory::GetCount(eItemType type) const
+{
+	return CountBits(m_TypeMasks[int(type)]);
+}
+
+int Inventory::GetFirstSlot(eItemType type) const
+{
+	return GetLowestBit(m_TypeMasks[int(type)]);
+}
+
+int Inventory::GetWeakestSlot(eItemType type) const
+{
+	const int typeIdx = int(type);
+	return m_HeapSizes[typeIdx] > 0 ? int(m_Heaps[typeIdx][0]) : -1;
+}
+
+int Inventory::QueryUnits(const ItemInfo& item) const
+{
+	auto itemCopy = item; // The getters take it by non-const reference
+	switch (item.Type)
+	{
+	case eItemType::MEDKIT:
+		return m_pInterface->Medkit_GetHealth(itemCopy);
+	case eItemType::FOOD:
+		return m_pInterface->Food_GetEnergy(itemCopy);
+	case eItemType::PISTOL:
+		return m_pInterface->Weapon_GetAmmo(itemCopy);
+	default:
+		return 0;
+	}
+}
+
+bool Inventory::Add(UINT slot, const ItemInfo& item, int units)
+{
+	if (slot >= m_Capacity || IsOccupied(slot) || m_pInterface->Inventory_AddItem(slot, item) == false)
+		return false;
+
+	Store(slot, item, units);
+	if (m_pEvents)
+		m_pEvents->Push(ItemPickedEvent{ slot, item.Type, units });
+	return true;
+}
+
+bool Inventory::Use(UINT slot)
+{
+	if (slot >= m_Capacity || IsOccupied(slot) == false)
+		return false;
+
+	// Will only work if the item has enough units left, if it doesn't, throw it away
+	if (m_pInterface->Inventory_UseItem(slot) == false)
+	{
+		Remove(slot);
+		return false;
+	}
+
+	// How much got used is up to the game, so only the used item gets asked again
+	const auto unitsLeft = QueryUnits(m_Slots[slot].Item);
+	if (m_pEvents)
+		m_pEvents->Push(ItemConsumedEvent{ slot, m_Slots[slot].Item.Type, max(unitsLeft, 0) });
+	if (unitsLeft <= 0)
+		Remove(slot);
+	else
+		SetUnits(slot, unitsLeft);
+
+	return true;
+}
+
+bool Inventory::Remove(UINT slot)
+{
+	if (slot >= m_Capacity || IsOccupied(slot) == false)
+		return false;
+
+	m_pInterface->Inventory_RemoveItem(slot);
+	Clear(slot);
+	return true;
+}
+
+void Inventory::Store(UINT slot, const ItemInfo& item, int units)
+{
+	const int typeIdx = int(item.Type);
+	m_Slots[slot].Item = item;
+	m_Slots[slot].Units = units;
+	m_OccupiedMask |= 1u << slot;
+	m_TypeMasks[typeIdx] |= 1u << slot;
+	HeapPush(typeIdx, slot);
+}
+
+void Inventory::Clear(UINT slot)
+{
+	const int typeIdx = int(m_Slots[slot].Item.Type);
+	HeapErase(typeIdx, slot);
+	m_OccupiedMask &= ~(1u << slot);
+	m_TypeMasks[typeIdx] &= ~(1u << slot);
+	m_Slots[slot] = Slot{};
+}
+
+void Inventory::SetUnits(UINT slot, int units)
+{
+	const int typeIdx = int(m_Slots[slot].Item.Type);
+	const bool decreased = units < m_Slots[slot].Units;
+	m_Slots[slot].Units = units;
+
+	if (decreased)
+		SiftUp(typeIdx, m_Slots[slot].HeapIdx);
+	else
+		SiftDown(typeIdx, m_Slots[slot].HeapIdx);
+}
+
+bool Inventory::IsWeaker(UINT slotA, UINT slotB) const
+{
+	const auto unitsA = m_Slots[slotA].Units;
+	const auto unitsB = m_Slots[slotB].Units;
+	return unitsA < unitsB || (unitsA == unitsB && slotA < slotB);
+}
+
+void Inventory::HeapPush(int typeIdx, UINT slot)
+{
+	const int heapIdx = m_HeapSizes[typeIdx]++;
+	m_Heaps[typeIdx][heapIdx] = slot;
+	m_Slots[slot].HeapIdx = heapIdx;
+	SiftUp(typeIdx, heapIdx);
+}
+
+void Inventory::HeapErase(int typeIdx, UINT slot)
+{
+	// Move the last one in its place, and let that one find its spot
+	const int heapIdx = m_Slots[slot].HeapIdx;
+	const int lastIdx = --m_HeapSizes[typeIdx];
+	if (heapIdx == lastIdx)
+		return;
+
+	HeapSwap(typeIdx, heapIdx, lastIdx);
+	SiftUp(typeIdx, heapIdx);
+	SiftDown(typeIdx, heapIdx);
+}
+
+void Inventory::SiftUp(int typeIdx, int heapIdx)
+{
+	const auto* pHeap = m_Heaps[typeIdx];
+	while (heapIdx > 0)
+	{
+		const int parentIdx = (heapIdx - 1) / 2;
+		if (IsWeaker(pHeap[heapIdx], pHeap[parentIdx]) == false)
+			break;
+
+		HeapSwap(typeIdx, heapIdx, parentIdx);
+		heapIdx = parentIdx;
+	}
+}
+
+void Inventory::SiftDown(int typeIdx, int heapIdx)
+{
+	const auto* pHeap = m_Heaps[typeIdx];
+	const int heapSize = m_HeapSizes[typeIdx];
+	while (true)
+	{
+		int weakestIdx = heapIdx;
+		for (const int childIdx : { 2 * heapIdx + 1, 2 * heapIdx + 2 })
+		{
+			if (childIdx < heapSize && IsWeaker(pHeap[childIdx], pHeap[weakestIdx]))
+				weakestIdx = childIdx;
+		}
+
+		if (weakestIdx == heapIdx)
+			break;
+
+		HeapSwap(typeIdx, heapIdx, weakestIdx);
+		heapIdx = weakestIdx;
+	}
+}
+
+void Inventory::HeapSwap(int typeIdx, int heapIdxA, int heapIdxB)
+{
+	auto* pHeap = m_Heaps[typeIdx];
+	swap(pHeap[heapIdxA], pHeap[heapIdxB]);
+	m_Slots[pHeap[heapIdxA]].HeapIdx = heapIdxA;
+	m_Slots[pHeap[heapIdxB]].HeapIdx = heapIdxB;
+}
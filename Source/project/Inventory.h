@@ -0,0 +1,68 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include "GameEvents.h"
+
+class IExamInterface;
+
+// Plugin-side mirror of the agent's inventory, so deciding what to use or replace doesn't mean polling every slot through the interface
+// Every slot keeps its item and remaining units (health, energy or ammo), every item type a bitmask of the slots holding it
+// and a min-heap of those slots by units (weakest on top), so all the queries are O(1)
+// It only stays coherent as long as every add, use and remove goes through it, which is also where pickups and uses get raised as events
+class Inventory final
+{
+public:
+	explicit Inventory(IExamInterface* pInterface); // Reads whatever is in the inventory already, once
+	~Inventory() = default;
+
+	// Queries, none of them touch the interface
+	UINT GetCapacity() const { return m_Capacity; }
+	bool IsOccupied(UINT slot) const { return (m_OccupiedMask >> slot) & 1u; }
+	const ItemInfo& GetItem(UINT slot) const { return m_Slots[slot].Item; }
+	int GetUnits(UINT slot) const { return m_Slots[slot].Units; }
+	int GetEmptySlot() const; // Lowest empty slot, -1 when full
+	int GetCount(eItemType type) const;
+	bool Has(eItemType type) const { return m_TypeMasks[int(type)] != 0; }
+	int GetFirstSlot(eItemType type) const; // Lowest slot holding that type, -1 if there's none
+	int GetWeakestSlot(eItemType type) const; // Slot holding the fewest units of that type (the lowest on a tie), -1 if there's none
+	void SetEventQueue(GameEventQueue* pEvents) { m_pEvents = pEvents; } // Can be null
+
+	// Units of an item that isn't stored yet (through the interface)
+	int QueryUnits(const ItemInfo& item) const;
+
+	// Actions, performed through the interface
+	bool Add(UINT slot, const ItemInfo& item, int units); // Units as given by QueryUnits() when the item got grabbed
+	bool Use(UINT slot); // Throws the item away when it fails, or when it's used up
+	bool Remove(UINT slot);
+
+private:
+	struct Slot
+	{
+		ItemInfo Item;
+		int Units;
+		int HeapIdx; // Where the slot sits in its type's heap
+	};
+
+	void Store(UINT slot, const ItemInfo& item, int units);
+	void Clear(UINT slot);
+	void SetUnits(UINT slot, int units);
+
+	// Min-heaps of slots, by units
+	bool IsWeaker(UINT slotA, UINT slotB) const;
+	void HeapPush(int typeIdx, UINT slot);
+	void HeapErase(int typeIdx, UINT slot);
+	void SiftUp(int typeIdx, int heapIdx);
+	void SiftDown(int typeIdx, int heapIdx);
+	void HeapSwap(int typeIdx, int heapIdxA, int heapIdxB);
+
+	static const int m_MaxSlots{ 32 }; // One bit per slot
+	static const int m_NrOfTypes{ int(eItemType::_LAST) + 1 };
+
+	IExamInterface* m_pInterface;
+	GameEventQueue* m_pEvents;
+	UINT m_Capacity;
+	Slot m_Slots[m_MaxSlots];
+	uint32_t m_OccupiedMask;
+	uint32_t m_TypeMasks[m_NrOfTypes];
+	UINT m_Heaps[m_NrOfTypes][m_MaxSlots];
+	int m_HeapSizes[m_NrOfTypes];
+};
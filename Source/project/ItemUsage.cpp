@@ -1,14 +1,17 @@
 #include "stdafx.h"
 #include "ItemUsage.h"
-#include <IExamInterface.h>
-
-ItemUsage::ItemUsage(IExamInterface* pInterface)
-	: m_pInterface(pInterface)
-	, m_MedkitAvailable(false)
-	, m_FoodAvailable(false)
-	, m_PistolAvailable(false)
+#include "Perception.h"
+#include "Inventory.h"
+#include "EnemyTracks.h"
+#include "GameEvents.h"
+#include "Profiler.h"
+
+ItemUsage::ItemUsage(Inventory* pInventory, const EnemyTracks* pEnemyTracks)
+	: m_pInventory(pInventory)
+	, m_pEnemyTracks(pEnemyTracks)
 	, m_TargetedEnemy()
 	, m_ShottingDistance(12.f)
+	, m_ShotLatency(0.f)
 	, m_FaceSteering()
 	, m_ReadyToShoot(true)
 	, m_ShootingPauseCounter(0.f)
@@ -18,132 +21,60 @@ ItemUsage::ItemUsage(IExamInterface* pInterface)
 
 ItemUsage::~ItemUsage()
 {
-	m_pInterface = nullptr;
+	m_pInventory = nullptr;
 }
 
 
-void ItemUsage::Update(float deltaTime, SteeringPlugin_Output& steering, bool& currentlyAiming)
+void ItemUsage::Update(float deltaTime, const Perception& perception, SteeringPlugin_Output& steering, bool& currentlyAiming)
+{
+	PROFILE_ZONE("ItemUsage::Update");
+
+	ManageMedkits(perception.GetAgentInfo());
+	ManageFood(perception.GetAgentInfo());
+	ManagePistol(perception, steering, currentlyAiming, deltaTime);
+}
+
+void ItemUsage::OnEvent(const EnemyLostEvent& event)
 {
-	ManageMedkits();
-	ManageFood();
-	ManagePistol(steering, currentlyAiming, deltaTime);
+	if (event.EnemyHash == m_TargetedEnemy.EnemyHash)
+		m_TargetedEnemy = EnemyInfo{};
 }
 
-void ItemUsage::ManageMedkits()
+void ItemUsage::ManageMedkits(const AgentInfo& agentInfo)
 {
 	const auto agentMaxHP = 10.f;
 	
 	// Check if the agent needs healing
-	const auto agentInfo = m_pInterface->Agent_GetInfo();
 	if (agentInfo.Health < agentMaxHP - 1.f)
 	{
-		// Check if there are medkits in the inventory
-		if (m_MedkitAvailable)
+		// Heal up with the first medkit in the inventory that works
+		// (one that doesn't, or that just gave its last unit, gets thrown away by the inventory)
+		for (auto medkitSlot = m_pInventory->GetFirstSlot(eItemType::MEDKIT); medkitSlot != -1; medkitSlot = m_pInventory->GetFirstSlot(eItemType::MEDKIT))
 		{
-			// Change the member variable bool preemptively
-			// (it will be changed back to true if, after using this one medkit, more medkits remain in the inventory)
-			m_MedkitAvailable = false;
-			
-			// Go through each slot in the inventory
-			bool firstMedkitFound = false;
-			const int nrOfSlots = m_pInterface->Inventory_GetCapacity();
-			for (auto currentSlot = 0; currentSlot < nrOfSlots; currentSlot++)
-			{
-				// If a slot has an item
-				ItemInfo itemInSlot;
-				if (m_pInterface->Inventory_GetItem(currentSlot, itemInSlot))
-				{
-					// If that item is a medkit
-					if (itemInSlot.Type == eItemType::MEDKIT)
-					{
-						// If the agent has not been healed yet
-						if (firstMedkitFound == false)
-						{
-							// Try to heal up (will only work if the medkit has enough units)
-							if (m_pInterface->Inventory_UseItem(currentSlot) == false)
-							{
-								// If it fails, throw the empty medkit away
-								m_pInterface->Inventory_RemoveItem(currentSlot);
-							}
-							else // If it works
-							{
-								// If it was the last unit in the medkit, throw it away
-								if(m_pInterface->Medkit_GetHealth(itemInSlot) == 0)
-									m_pInterface->Inventory_RemoveItem(currentSlot);
-								
-								firstMedkitFound = true; // Change the bool so the agent won't be healed again in this same Update(), in case there are more medkits in the inventory
-							}
-						}
-						else
-						{
-							m_MedkitAvailable = true;
-							break;
-						}
-					}
-				}
-			}
+			if (m_pInventory->Use(UINT(medkitSlot)))
+				break;
 		}
 	}
 }
 
-void ItemUsage::ManageFood()
+void ItemUsage::ManageFood(const AgentInfo& agentInfo)
 {
 	const auto agentMaxEnergy = 10.f;
 
 	// Check if the agent needs energy
-	const auto agentInfo = m_pInterface->Agent_GetInfo();
 	if (agentInfo.Energy < agentMaxEnergy - 1.f)
 	{
-		// Check if there is food in the inventory
-		if (m_FoodAvailable)
+		// Eat the first food in the inventory that works
+		// (one that doesn't, or that just gave its last unit of energy, gets thrown away by the inventory)
+		for (auto foodSlot = m_pInventory->GetFirstSlot(eItemType::FOOD); foodSlot != -1; foodSlot = m_pInventory->GetFirstSlot(eItemType::FOOD))
 		{
-			// Change the member variable bool preemptively
-			// (it will be changed back to true if, after using this one instance of food, more food remains in the inventory)
-			m_FoodAvailable = false;
-
-			// Go through each slot in the inventory
-			bool firstFoodFound = false;
-			const int nrOfSlots = m_pInterface->Inventory_GetCapacity();
-			for (auto currentSlot = 0; currentSlot < nrOfSlots; currentSlot++)
-			{
-				// If a slot has an item
-				ItemInfo itemInSlot;
-				if (m_pInterface->Inventory_GetItem(currentSlot, itemInSlot))
-				{
-					// If that item is food
-					if (itemInSlot.Type == eItemType::FOOD)
-					{
-						// If the agent has not eaten yet
-						if (firstFoodFound == false)
-						{
-							// Try to eat (will only work if the food has enough units)
-							if (m_pInterface->Inventory_UseItem(currentSlot) == false)
-							{
-								// If it fails, throw the empty food item away
-								m_pInterface->Inventory_RemoveItem(currentSlot);
-							}
-							else // If it works
-							{
-								// If it was the last unit of energy in the food, throw it away
-								if (m_pInterface->Food_GetEnergy(itemInSlot) == 0)
-									m_pInterface->Inventory_RemoveItem(currentSlot);
-								
-								firstFoodFound = true; // Change the bool so the agent won't eat again in this same Update(), in case there is more food in the inventory
-							}
-						}
-						else
-						{
-							m_FoodAvailable = true;
-							break;
-						}
-					}
-				}
-			}
+			if (m_pInventory->Use(UINT(foodSlot)))
+				break;
 		}
 	}
 }
 
-void ItemUsage::ManagePistol(SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime)
+void ItemUsage::ManagePistol(const Perception& perception, SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime)
 {
 	// Preventively change the bool (which will be changed back to true in case the AimShot() function runs)
 	currentlyAiming = false;
@@ -160,73 +91,38 @@ void ItemUsage::ManagePistol(SteeringPlugin_Output& steering, bool& currentlyAim
 	}
 	
 	// If the agent has a loaded pistol
-	if (m_PistolAvailable)
+	if (m_pInventory->Has(eItemType::PISTOL))
 	{
-		const auto agentInfo = m_pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 
-		// Store in a vector all enemies in the FOV
-		vector<EnemyInfo> enemiesInFOV{};
-		for (int i = 0;; ++i)
-		{
-			EntityInfo ei = {};
-			if (m_pInterface->Fov_GetEntityByIndex(i, ei))
-			{
-				if (ei.Type == eEntityType::ENEMY)
-				{
-					EnemyInfo enemyInfo{};
-					if (m_pInterface->Enemy_GetInfo(ei, enemyInfo))
-					{
-						enemiesInFOV.push_back(enemyInfo);
-					}
-				}
-
-				continue;
-			}
-			break;
-		}
+		// Get all enemies in the FOV
+		const auto& enemiesInFOV = perception.GetEnemies();
 
 		// If any enemy is spotted, target the closest
 		if (enemiesInFOV.empty() == false)
 		{
-			m_TargetedEnemy = enemiesInFOV[0];
-			for (const auto& enemy : enemiesInFOV)
-			{
-				if(enemy.Location.Distance(agentInfo.Position) < m_TargetedEnemy.Location.Distance(agentInfo.Position))
-					m_TargetedEnemy = enemy;
-			}
+			m_TargetedEnemy = enemiesInFOV[Elite::ClosestPoint(perception.GetEnemyPositions(), agentInfo.Position)];
 			
-			AimShot(steering, currentlyAiming, deltaTime);
+			AimShot(agentInfo, steering, currentlyAiming, deltaTime);
 		}
 	}
 }
 
-void ItemUsage::OnNotify(const Event& event)
+void ItemUsage::AimShot(const AgentInfo& agentInfo, SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime)
 {
-	switch (event)
+	// Where the zombie is now, and where it's going (from its track's filter, the enemy tracks got updated with this frame already)
+	const auto trackIdx = m_pEnemyTracks ? m_pEnemyTracks->Find(m_TargetedEnemy.EnemyHash) : -1;
+	const auto predictPosition = [this, trackIdx](float time)
 	{
-	case Event::MedkitPickedUp:
-		m_MedkitAvailable = true;
-		break;
-
-	case Event::FoodPickedUp:
-		m_FoodAvailable = true;
-		break;
+		return trackIdx < 0 ? m_TargetedEnemy.Location + m_TargetedEnemy.LinearVelocity * time : m_pEnemyTracks->PredictPosition(trackIdx, time);
+	};
 
-	case Event::PistolPickedUp:
-		m_PistolAvailable = true;
-		break;
-	default:
-		break;
-	}
-}
-
-void ItemUsage::AimShot(SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime)
-{
-	const auto agentInfo = m_pInterface->Agent_GetInfo();
-	
-	// Face the zombie
+	// Face where the zombie will be by the time the agent's turned towards it
 	currentlyAiming = true;
-	m_FaceSteering.SetTarget(m_TargetedEnemy.Location);
+	const auto toTarget = predictPosition(0.f) - agentInfo.Position;
+	const auto facing = Elite::DirectionFromOrientation(agentInfo.Orientation);
+	const auto turnTime = agentInfo.MaxAngularSpeed > 0.f ? fabsf(Elite::SignedAngle(facing, toTarget)) / agentInfo.MaxAngularSpeed : 0.f;
+	m_FaceSteering.SetTarget(predictPosition(turnTime));
 
 	// If the zombie is inside the shooting range
 	if (m_TargetedEnemy.Location.Distance(agentInfo.Position) < m_ShottingDistance)
@@ -234,34 +130,11 @@ void ItemUsage::AimShot(SteeringPlugin_Output& steering, bool& currentlyAiming,
 		// If not waiting between shots. The waiting exists duo to rare shot misses that can happen if the targeted enemy gets suddenly stuck on something (in this case, this pause will stop the agent from wasting bullets)
 		if (m_ReadyToShoot)
 		{
-			// Calculate the agent's current rotation
-			double currentRotation = double(agentInfo.Orientation);
-			if (currentRotation > 6.)
-				currentRotation -= 6. * (int(currentRotation) / 6);
-
-			if (currentRotation < 0.)
-				currentRotation += 6. * (int(-currentRotation) / 6 + 1);
-
-			float currentRotationAngle;
-			if (currentRotation != 0.)
-			{
-				currentRotationAngle = 360. * currentRotation / 6. - 90.;
-				if (currentRotationAngle < 0.)
-					currentRotationAngle += 360.;
-			}
-			else currentRotationAngle = 270.;
-
-			const Elite::Vector2 currentDirection{ cos(Elite::ToRadians(currentRotationAngle)), sin(Elite::ToRadians(currentRotationAngle)) };
-
-
-			// Predict the enemy's position
-			const float predictionTime = m_TargetedEnemy.Location.Distance(agentInfo.Position) / m_TargetedEnemy.LinearVelocity.Magnitude(); // Calculate the prediction time by dividing the distance with the enemy's current speed
-			const Elite::Vector2 targetDirection = m_TargetedEnemy.LinearVelocity.GetNormalized(); // Get the target's normalized direction vector
-			const auto predictedTarget = m_TargetedEnemy.Location + (targetDirection * predictionTime); // Calculate the predicted target pos with the current target pos + its direction multiplied by the prediction time
-			
+			// Where the zombie is when the shot goes off (hitscan, so that's this frame)
+			const auto predictedTarget = predictPosition(m_ShotLatency);
 
 			// And shoot when aligned
-			if (CollisionRayCircle(agentInfo.Position, currentDirection, predictedTarget, 0.2f))
+			if (CollisionRayCircle(agentInfo.Position, facing, predictedTarget, 0.2f))
 			{
 				Shoot();
 				m_ReadyToShoot = false;
@@ -269,59 +142,18 @@ void ItemUsage::AimShot(SteeringPlugin_Output& steering, bool& currentlyAiming,
 		}
 	}
 
-	steering = m_FaceSteering.CalculateSteering(m_pInterface->Agent_GetInfo());
+	steering = m_FaceSteering.CalculateSteering(agentInfo);
 }
 
 void ItemUsage::Shoot()
 {
-	bool shotDone = false;
-	
-	// Go through each slot in the inventory
-	bool noMorePistolsInInvetory = true;
-	const int nrOfSlots = m_pInterface->Inventory_GetCapacity();
-	for (auto currentSlot = 0; currentSlot < nrOfSlots; currentSlot++)
+	// Shoot with the first pistol in the inventory, until one actually fires
+	// (an empty gun gets thrown away, and so does the gun that just shot its last bullet)
+	for (auto pistolSlot = m_pInventory->GetFirstSlot(eItemType::PISTOL); pistolSlot != -1; pistolSlot = m_pInventory->GetFirstSlot(eItemType::PISTOL))
 	{
-		// If a slot has an item
-		ItemInfo itemInSlot;
-		if (m_pInterface->Inventory_GetItem(currentSlot, itemInSlot))
-		{
-			// If that item is a pistol
-			if (itemInSlot.Type == eItemType::PISTOL)
-			{
-				if (shotDone == false)
-				{
-					// Try to shoot (will only work if the gun has at least 1 bullet)
-					if (m_pInterface->Inventory_UseItem(currentSlot) == false)
-					{
-						// If it fails, throw the empty gun away
-						m_pInterface->Inventory_RemoveItem(currentSlot);
-					}
-					else // If it works
-					{
-						shotDone = true;
-						// If it was the last bullet in the pistol, throw it away
-						if (m_pInterface->Weapon_GetAmmo(itemInSlot) == 0)
-							m_pInterface->Inventory_RemoveItem(currentSlot);
-						else
-						{
-							// If not, remember there are still pistols in the inventory and break the for loop
-							noMorePistolsInInvetory = false;
-							break;
-						}
-					}
-				}
-				else
-				{
-					// If a pistol remains in the inventory after the shot, remember it and break the for loop
-					noMorePistolsInInvetory = false;
-					break;
-				}
-			}
-		}
+		if (m_pInventory->Use(UINT(pistolSlot)))
+			break;
 	}
-
-	if(noMorePistolsInInvetory)
-		m_PistolAvailable = false;
 }
 
 bool ItemUsage::CollisionRayCircle(Elite::Vector2 rayOriginPoint, Elite::Vector2 rayDirection, Elite::Vector2 circleCenter, float circleRadius)
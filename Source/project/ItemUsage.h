@@ -1,36 +1,37 @@
 #pragma once
-#include "Observer.h"
 #include "SteeringBehaviour.h"
 
 struct SteeringPlugin_Output;
-class IExamInterface;
+class Perception;
+class Inventory;
+class EnemyTracks;
+struct EnemyLostEvent;
 
-class ItemUsage final : public Observer
+class ItemUsage final
 {
 public:
-	ItemUsage(IExamInterface* pInterface);
-	~ItemUsage() override;
+	ItemUsage(Inventory* pInventory, const EnemyTracks* pEnemyTracks);
+	~ItemUsage();
 
-	void Update(float deltaTime, SteeringPlugin_Output& steering, bool& currentlyAiming);
-	void OnNotify(const Event& event) override;
+	void Update(float deltaTime, const Perception& perception, SteeringPlugin_Output& steering, bool& currentlyAiming);
+	void OnEvent(const EnemyLostEvent& event); // Stops aiming at it
 
-	void AimShot(SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime);
+	void AimShot(const AgentInfo& agentInfo, SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime);
 	void Shoot();
 
 	bool CollisionRayCircle(Elite::Vector2 rayOriginPoint, Elite::Vector2 rayDirection, Elite::Vector2 circleCenter, float circleRadius);
 
 private:
-	void ManageMedkits();
-	void ManageFood();
-	void ManagePistol(SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime);
+	void ManageMedkits(const AgentInfo& agentInfo);
+	void ManageFood(const AgentInfo& agentInfo);
+	void ManagePistol(const Perception& perception, SteeringPlugin_Output& steering, bool& currentlyAiming, float deltaTime);
 	
-	IExamInterface* m_pInterface;
-	bool m_MedkitAvailable;
-	bool m_FoodAvailable;
-	bool m_PistolAvailable;
+	Inventory* m_pInventory; // Every item gets used through it, so it stays in sync
+	const EnemyTracks* m_pEnemyTracks; // Kept by the plugin, where the targeted enemy's going (can be null, then it's aimed at as it's seen)
 
 	EnemyInfo m_TargetedEnemy;
 	const float m_ShottingDistance;
+	const float m_ShotLatency; // Between the perception and the shot actually going off, in seconds
 	Face m_FaceSteering;
 
 	bool m_ReadyToShoot;
@@ -0,0 +1,446 @@
+#include "stdafx.h"
+#include "LevelData.h"
+#include <cstring>
+
+// Both files are read in place, which assumes a little-endian machine (just like the game itself)
+
+namespace
+{
+	// Sidecar layout: header, houses, polygons, cell starts and cell walls (everything 4-byte aligned)
+	struct SidecarHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint64_t LevelSize;
+		uint64_t LevelHash;
+		uint32_t HouseCount;
+		uint32_t PolygonCount;
+		uint32_t GridWidth;
+		uint32_t GridHeight;
+		uint32_t CellWallCount;
+		float CellSize;
+		Elite::Vector2 Dimensions;
+	};
+
+	const char g_SidecarMagic[4]{ 'G', 'P', 'P', 'C' };
+	const uint32_t g_SidecarVersion{ 1 };
+	const int g_MaxGridSize{ 256 }; // Cells per axis
+
+	// Bounds-checked sequential reads from the mapped level
+	class LevelReader final
+	{
+	public:
+		LevelReader(const uint8_t* pData, size_t size) : m_pData(pData), m_Size(size), m_Offset(0) {}
+
+		template<typename T>
+		bool Read(T& value)
+		{
+			if (sizeof(T) > GetRemaining())
+				return false;
+
+			memcpy(&value, m_pData + m_Offset, sizeof(T));
+			m_Offset += sizeof(T);
+			return true;
+		}
+
+		bool Skip(uint64_t bytes)
+		{
+			if (bytes > GetRemaining())
+				return false;
+
+			m_Offset += size_t(bytes);
+			return true;
+		}
+
+		size_t GetOffset() const { return m_Offset; }
+		size_t GetRemaining() const { return m_Size - m_Offset; }
+
+	private:
+		const uint8_t* m_pData;
+		size_t m_Size;
+		size_t m_Offset;
+	};
+
+	bool IsValidDimension(float dimension)
+	{
+		return dimension > 0.f && dimension < FLT_MAX;
+	}
+}
+
+LevelData::LevelData()
+	: m_FilePath()
+	, m_Dimensions{}
+	, m_CellSize(0.f)
+	, m_GridWidth(0)
+	, m_GridHeight(0)
+{
+}
+
+bool LevelData::Load(const string& filePath, eSidecarMode sidecarMode)
+{
+	Unload();
+
+	// Offsets into the level are stored as 32 bit
+	if (m_LevelFile.Open(filePath) == false || m_LevelFile.GetSize() > UINT32_MAX)
+	{
+		Unload();
+		return false;
+	}
+	m_FilePath = filePath;
+
+	const auto sidecarPath = GetSidecarPath(filePath);
+	if (sidecarMode != eSidecarMode::Ignore && LoadSidecar(sidecarPath))
+		return true;
+
+	if (Parse() == false)
+	{
+		Unload();
+		return false;
+	}
+
+	BuildGrid();
+
+	if (sidecarMode == eSidecarMode::ReadWrite)
+		WriteSidecar(sidecarPath);
+
+	return true;
+}
+
+void LevelData::Unload()
+{
+	m_LevelFile.Close();
+	m_SidecarFile.Close();
+	m_FilePath.clear();
+
+	m_Dimensions = Elite::Vector2{};
+	m_Houses = Span<LevelHouse>{};
+	m_Polygons = Span<LevelPolygon>{};
+	m_CellStarts = Span<uint32_t>{};
+	m_CellWalls = Span<uint32_t>{};
+	m_CellSize = 0.f;
+	m_GridWidth = 0;
+	m_GridHeight = 0;
+
+	m_BuiltHouses.clear();
+	m_BuiltPolygons.clear();
+	m_BuiltCellStarts.clear();
+	m_BuiltCellWalls.clear();
+}
+
+Span<Elite::Vector2> LevelData::GetPoints(const LevelPolygon& polygon) const
+{
+	// Every field in the level is 4 bytes, so the points are always properly aligned
+	const auto* pPoints = reinterpret_cast<const Elite::Vector2*>(m_LevelFile.GetData() + polygon.PointsOffset);
+	return Span<Elite::Vector2>{ pPoints, polygon.PointCount };
+}
+
+void LevelData::GetCell(const Elite::Vector2& position, int& cellX, int& cellY) const
+{
+	cellX = Elite::Clamp(int(floorf((position.x + m_Dimensions.x / 2.f) / m_CellSize)), 0, m_GridWidth - 1);
+	cellY = Elite::Clamp(int(floorf((position.y + m_Dimensions.y / 2.f) / m_CellSize)), 0, m_GridHeight - 1);
+}
+
+Span<uint32_t> LevelData::GetWallsInCell(int cellX, int cellY) const
+{
+	const auto cellIdx = size_t(cellY * m_GridWidth + cellX);
+	const auto first = m_CellStarts[cellIdx];
+	return Span<uint32_t>{ m_CellWalls.data() + first, m_CellStarts[cellIdx + 1] - first };
+}
+
+void LevelData::QueryWalls(const Elite::Vector2& min, const Elite::Vector2& max, vector<uint32_t>& polygonIndices) const
+{
+	polygonIndices.clear();
+	if (IsLoaded() == false)
+		return;
+
+	int minX, minY, maxX, maxY;
+	GetCell(min, minX, minY);
+	GetCell(max, maxX, maxY);
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			const auto walls = GetWallsInCell(x, y);
+			polygonIndices.insert(polygonIndices.end(), walls.begin(), walls.end());
+		}
+	}
+
+	// Only a single cell can't contain duplicates
+	if (minX != maxX || minY != maxY)
+	{
+		sort(polygonIndices.begin(), polygonIndices.end());
+		polygonIndices.erase(unique(polygonIndices.begin(), polygonIndices.end()), polygonIndices.end());
+	}
+}
+
+
+bool LevelData::Parse()
+{
+	LevelReader reader{ m_LevelFile.GetData(), m_LevelFile.GetSize() };
+
+	uint32_t nrOfHouses = 0;
+	if (reader.Read(m_Dimensions) == false || reader.Read(nrOfHouses) == false)
+		return false;
+
+	if (IsValidDimension(m_Dimensions.x) == false || IsValidDimension(m_Dimensions.y) == false)
+		return false;
+
+	// Every house takes at least its center, size and both polygon counts
+	const size_t minHouseSize = sizeof(HouseInfo) + 2 * sizeof(uint32_t);
+	if (nrOfHouses > reader.GetRemaining() / minHouseSize)
+		return false;
+
+	const auto readPolygons = [this, &reader](uint32_t& first, uint32_t& count)
+	{
+		if (reader.Read(count) == false || count > reader.GetRemaining() / sizeof(uint32_t))
+			return false;
+
+		first = uint32_t(m_BuiltPolygons.size());
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			LevelPolygon polygon{};
+			if (reader.Read(polygon.PointCount) == false)
+				return false;
+
+			polygon.PointsOffset = uint32_t(reader.GetOffset());
+			if (reader.Skip(uint64_t(polygon.PointCount) * sizeof(Elite::Vector2)) == false)
+				return false;
+
+			// Bounding box
+			const auto points = GetPoints(polygon);
+			if (points.empty() == false)
+			{
+				polygon.Min = polygon.Max = points[0];
+				for (const auto& point : points)
+				{
+					polygon.Min.x = min(polygon.Min.x, point.x);
+					polygon.Min.y = min(polygon.Min.y, point.y);
+					polygon.Max.x = max(polygon.Max.x, point.x);
+					polygon.Max.y = max(polygon.Max.y, point.y);
+				}
+			}
+
+			m_BuiltPolygons.push_back(polygon);
+		}
+
+		return true;
+	};
+
+	m_BuiltHouses.reserve(nrOfHouses);
+	for (uint32_t i = 0; i < nrOfHouses; ++i)
+	{
+		LevelHouse house{};
+		if (reader.Read(house.Info.Center) == false || reader.Read(house.Info.Size) == false)
+			return false;
+
+		if (readPolygons(house.FirstWall, house.WallCount) == false || readPolygons(house.FirstOutline, house.OutlineCount) == false)
+			return false;
+
+		// Bounding box of the walls (or of the house itself, if it has none)
+		house.Min = house.Info.Center - house.Info.Size / 2.f;
+		house.Max = house.Info.Center + house.Info.Size / 2.f;
+		for (uint32_t wallIdx = house.FirstWall; wallIdx < house.FirstWall + house.WallCount; ++wallIdx)
+		{
+			const auto& wall = m_BuiltPolygons[wallIdx];
+			if (wallIdx == house.FirstWall)
+			{
+				house.Min = wall.Min;
+				house.Max = wall.Max;
+			}
+
+			house.Min.x = min(house.Min.x, wall.Min.x);
+			house.Min.y = min(house.Min.y, wall.Min.y);
+			house.Max.x = max(house.Max.x, wall.Max.x);
+			house.Max.y = max(house.Max.y, wall.Max.y);
+		}
+
+		m_BuiltHouses.push_back(house);
+	}
+
+	m_Houses = Span<LevelHouse>{ m_BuiltHouses.data(), m_BuiltHouses.size() };
+	m_Polygons = Span<LevelPolygon>{ m_BuiltPolygons.data(), m_BuiltPolygons.size() };
+	return true;
+}
+
+void LevelData::BuildGrid()
+{
+	// Huge worlds get bigger cells instead of more of them
+	m_CellSize = max(m_TargetCellSize, max(m_Dimensions.x, m_Dimensions.y) / g_MaxGridSize);
+	m_GridWidth = max(1, int(ceilf(m_Dimensions.x / m_CellSize)));
+	m_GridHeight = max(1, int(ceilf(m_Dimensions.y / m_CellSize)));
+
+	// Counting pass, then a prefix sum so every cell's walls end up next to each other
+	const auto nrOfCells = size_t(m_GridWidth * m_GridHeight);
+	m_BuiltCellStarts.assign(nrOfCells + 1, 0);
+
+	const auto forEachWallCell = [this](const function<void(uint32_t, size_t)>& action)
+	{
+		for (const auto& house : m_BuiltHouses)
+		{
+			for (uint32_t wallIdx = house.FirstWall; wallIdx < house.FirstWall + house.WallCount; ++wallIdx)
+			{
+				int minX, minY, maxX, maxY;
+				GetCell(m_BuiltPolygons[wallIdx].Min, minX, minY);
+				GetCell(m_BuiltPolygons[wallIdx].Max, maxX, maxY);
+				for (int y = minY; y <= maxY; ++y)
+				{
+					for (int x = minX; x <= maxX; ++x)
+						action(wallIdx, size_t(y * m_GridWidth + x));
+				}
+			}
+		}
+	};
+
+	forEachWallCell([this](uint32_t, size_t cellIdx) { ++m_BuiltCellStarts[cellIdx + 1]; });
+	for (size_t i = 1; i < m_BuiltCellStarts.size(); ++i)
+		m_BuiltCellStarts[i] += m_BuiltCellStarts[i - 1];
+
+	m_BuiltCellWalls.resize(m_BuiltCellStarts.back());
+	vector<uint32_t> fillOffsets(m_BuiltCellStarts.begin(), m_BuiltCellStarts.end() - 1);
+	forEachWallCell([this, &fillOffsets](uint32_t wallIdx, size_t cellIdx) { m_BuiltCellWalls[fillOffsets[cellIdx]++] = wallIdx; });
+
+	m_CellStarts = Span<uint32_t>{ m_BuiltCellStarts.data(), m_BuiltCellStarts.size() };
+	m_CellWalls = Span<uint32_t>{ m_BuiltCellWalls.data(), m_BuiltCellWalls.size() };
+}
+
+bool LevelData::LoadSidecar(const string& sidecarPath)
+{
+	if (m_SidecarFile.Open(sidecarPath) == false)
+		return false;
+
+	const auto fail = [this]()
+	{
+		m_SidecarFile.Close();
+		return false;
+	};
+
+	// Header
+	SidecarHeader header{};
+	if (m_SidecarFile.GetSize() < sizeof(header))
+		return fail();
+
+	memcpy(&header, m_SidecarFile.GetData(), sizeof(header));
+	if (memcmp(header.Magic, g_SidecarMagic, sizeof(g_SidecarMagic)) != 0 || header.Version != g_SidecarVersion)
+		return fail();
+
+	// Stale?
+	if (header.LevelSize != m_LevelFile.GetSize() || header.LevelHash != HashLevelFile())
+		return fail();
+
+	if (header.GridWidth == 0 || header.GridHeight == 0 || header.GridWidth > uint32_t(g_MaxGridSize) || header.GridHeight > uint32_t(g_MaxGridSize) ||
+		header.CellSize <= 0.f || IsValidDimension(header.Dimensions.x) == false || IsValidDimension(header.Dimensions.y) == false)
+		return fail();
+
+	// Tables
+	const uint64_t nrOfCells = uint64_t(header.GridWidth) * header.GridHeight;
+	const uint64_t expectedSize = sizeof(header) + uint64_t(header.HouseCount) * sizeof(LevelHouse) + uint64_t(header.PolygonCount) * sizeof(LevelPolygon) +
+		(nrOfCells + 1) * sizeof(uint32_t) + uint64_t(header.CellWallCount) * sizeof(uint32_t);
+	if (expectedSize != m_SidecarFile.GetSize())
+		return fail();
+
+	const auto* pTables = m_SidecarFile.GetData() + sizeof(header);
+	const Span<LevelHouse> houses{ reinterpret_cast<const LevelHouse*>(pTables), header.HouseCount };
+	pTables += houses.size() * sizeof(LevelHouse);
+	const Span<LevelPolygon> polygons{ reinterpret_cast<const LevelPolygon*>(pTables), header.PolygonCount };
+	pTables += polygons.size() * sizeof(LevelPolygon);
+	const Span<uint32_t> cellStarts{ reinterpret_cast<const uint32_t*>(pTables), size_t(nrOfCells + 1) };
+	pTables += cellStarts.size() * sizeof(uint32_t);
+	const Span<uint32_t> cellWalls{ reinterpret_cast<const uint32_t*>(pTables), header.CellWallCount };
+
+	// Every index and offset has to stay in range, so nothing can read outside of the mapped files later on
+	for (const auto& house : houses)
+	{
+		if (uint64_t(house.FirstWall) + house.WallCount > polygons.size() || uint64_t(house.FirstOutline) + house.OutlineCount > polygons.size())
+			return fail();
+	}
+
+	for (const auto& polygon : polygons)
+	{
+		if (polygon.PointsOffset % sizeof(float) != 0 ||
+			uint64_t(polygon.PointsOffset) + uint64_t(polygon.PointCount) * sizeof(Elite::Vector2) > m_LevelFile.GetSize())
+			return fail();
+	}
+
+	if (cellStarts[0] != 0 || cellStarts[cellStarts.size() - 1] != cellWalls.size())
+		return fail();
+
+	for (size_t i = 1; i < cellStarts.size(); ++i)
+	{
+		if (cellStarts[i] < cellStarts[i - 1])
+			return fail();
+	}
+
+	for (const auto wallIdx : cellWalls)
+	{
+		if (wallIdx >= polygons.size())
+			return fail();
+	}
+
+	m_Dimensions = header.Dimensions;
+	m_Houses = houses;
+	m_Polygons = polygons;
+	m_CellStarts = cellStarts;
+	m_CellWalls = cellWalls;
+	m_CellSize = header.CellSize;
+	m_GridWidth = int(header.GridWidth);
+	m_GridHeight = int(header.GridHeight);
+	return true;
+}
+
+void LevelData::WriteSidecar(const string& sidecarPath) const
+{
+	SidecarHeader header{};
+	memcpy(header.Magic, g_SidecarMagic, sizeof(g_SidecarMagic));
+	header.Version = g_SidecarVersion;
+	header.LevelSize = m_LevelFile.GetSize();
+	header.LevelHash = HashLevelFile();
+	header.HouseCount = uint32_t(m_BuiltHouses.size());
+	header.PolygonCount = uint32_t(m_BuiltPolygons.size());
+	header.GridWidth = uint32_t(m_GridWidth);
+	header.GridHeight = uint32_t(m_GridHeight);
+	header.CellWallCount = uint32_t(m_BuiltCellWalls.size());
+	header.CellSize = m_CellSize;
+	header.Dimensions = m_Dimensions;
+
+	// Written next to it first and then renamed, so a run loading the level at the same time never sees half a sidecar
+	const auto tempPath = sidecarPath + ".tmp" + to_string(random_device{}());
+	{
+		ofstream file(tempPath, ios::binary);
+		if (!file)
+			return;
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(m_BuiltHouses.data()), m_BuiltHouses.size() * sizeof(LevelHouse));
+		file.write(reinterpret_cast<const char*>(m_BuiltPolygons.data()), m_BuiltPolygons.size() * sizeof(LevelPolygon));
+		file.write(reinterpret_cast<const char*>(m_BuiltCellStarts.data()), m_BuiltCellStarts.size() * sizeof(uint32_t));
+		file.write(reinterpret_cast<const char*>(m_BuiltCellWalls.data()), m_BuiltCellWalls.size() * sizeof(uint32_t));
+		if (!file)
+		{
+			file.close();
+			remove(tempPath.c_str());
+			return;
+		}
+	}
+
+	// Renaming onto an existing file fails on Windows, in which case the stale sidecar is removed first
+	if (rename(tempPath.c_str(), sidecarPath.c_str()) != 0)
+	{
+		remove(sidecarPath.c_str());
+		if (rename(tempPath.c_str(), sidecarPath.c_str()) != 0)
+			remove(tempPath.c_str());
+	}
+}
+
+uint64_t LevelData::HashLevelFile() const
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	const auto* pData = m_LevelFile.GetData();
+	for (size_t i = 0; i < m_LevelFile.GetSize(); ++i)
+	{
+		hash ^= pData[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <Exam_HelperStructs.h>
+#include "MappedFile.h"
+
+// Read-only view over contiguous elements (owned by someone else)
+template<typename T>
+class Span final
+{
+public:
+	Span() : m_pData(nullptr), m_Size(0) {}
+	Span(const T* pData, size_t size) : m_pData(pData), m_Size(size) {}
+
+	const T* begin() const { return m_pData; }
+	const T* end() const { return m_pData + m_Size; }
+	const T& operator[](size_t idx) const { return m_pData[idx]; }
+	const T* data() const { return m_pData; }
+	size_t size() const { return m_Size; }
+	bool empty() const { return m_Size == 0; }
+
+private:
+	const T* m_pData;
+	size_t m_Size;
+};
+
+// A wall or outline polygon
+// The points themselves are never copied, they're read straight from the mapped level file
+struct LevelPolygon
+{
+	uint32_t PointsOffset; // Byte offset of the first point in the level file
+	uint32_t PointCount;
+	Elite::Vector2 Min; // Bounding box
+	Elite::Vector2 Max;
+};
+
+struct LevelHouse
+{
+	HouseInfo Info;
+	Elite::Vector2 Min; // Bounding box of the walls
+	Elite::Vector2 Max;
+	uint32_t FirstWall; // Index into the polygons
+	uint32_t WallCount;
+	uint32_t FirstOutline;
+	uint32_t OutlineCount;
+};
+
+// The level geometry of a .gppl file (the one GameDebugParams::LevelFile points at)
+// Layout (little-endian): world dimensions (2 floats), house count, and per house its center, size,
+// wall polygon count + polygons and outline polygon count + polygons (each polygon being a point count followed by the points)
+//
+// The file is memory mapped and validated, but never copied: houses and polygons are small index tables into it
+// Those tables (plus the bounding boxes and a uniform grid of the walls) are cached in a "<level>.gppc" sidecar,
+// so loading the same level again only has to map both files and check that the sidecar still matches
+class LevelData final
+{
+public:
+	enum class eSidecarMode
+	{
+		Ignore, // Always parse the level
+		ReadOnly, // Use the sidecar when it's there and up to date
+		ReadWrite // Same, but (re)write it after parsing
+	};
+
+	LevelData();
+	~LevelData() = default;
+
+	LevelData(const LevelData&) = delete;
+	LevelData& operator=(const LevelData&) = delete;
+
+	bool Load(const string& filePath, eSidecarMode sidecarMode = eSidecarMode::ReadWrite);
+	void Unload();
+
+	bool IsLoaded() const { return m_LevelFile.IsOpen(); }
+	bool WasLoadedFromSidecar() const { return m_SidecarFile.IsOpen(); }
+	const string& GetFilePath() const { return m_FilePath; } // As it was loaded
+	static string GetSidecarPath(const string& filePath) { return filePath + ".gppc"; }
+
+	const Elite::Vector2& GetDimensions() const { return m_Dimensions; }
+	Span<LevelHouse> GetHouses() const { return m_Houses; }
+	Span<LevelPolygon> GetPolygons() const { return m_Polygons; }
+	Span<LevelPolygon> GetWalls(const LevelHouse& house) const { return Span<LevelPolygon>{ m_Polygons.data() + house.FirstWall, house.WallCount }; }
+	Span<LevelPolygon> GetOutlines(const LevelHouse& house) const { return Span<LevelPolygon>{ m_Polygons.data() + house.FirstOutline, house.OutlineCount }; }
+	Span<Elite::Vector2> GetPoints(const LevelPolygon& polygon) const;
+
+	// Wall grid (the world's centered on the origin, cells outside of the grid are clamped to its border)
+	float GetCellSize() const { return m_CellSize; }
+	void GetCell(const Elite::Vector2& position, int& cellX, int& cellY) const;
+	Span<uint32_t> GetWallsInCell(int cellX, int cellY) const; // Polygon indices, a wall overlapping several cells is listed in each
+	void QueryWalls(const Elite::Vector2& min, const Elite::Vector2& max, vector<uint32_t>& polygonIndices) const; // Every wall whose cell overlaps the box, without duplicates
+
+private:
+	MappedFile m_LevelFile;
+	MappedFile m_SidecarFile;
+	string m_FilePath;
+
+	Elite::Vector2 m_Dimensions;
+	Span<LevelHouse> m_Houses;
+	Span<LevelPolygon> m_Polygons;
+	Span<uint32_t> m_CellStarts; // Grid width * height + 1 entries
+	Span<uint32_t> m_CellWalls;
+	float m_CellSize;
+	int m_GridWidth;
+	int m_GridHeight;
+
+	// Only used when the tables were built here instead of coming from the sidecar
+	vector<LevelHouse> m_BuiltHouses;
+	vector<LevelPolygon> m_BuiltPolygons;
+	vector<uint32_t> m_BuiltCellStarts;
+	vector<uint32_t> m_BuiltCellWalls;
+
+	const float m_TargetCellSize{ 16.f };
+
+	bool Parse();
+	void BuildGrid();
+	bool LoadSidecar(const string& sidecarPath);
+	void WriteSidecar(const string& sidecarPath) const;
+	uint64_t HashLevelFile() const;
+};
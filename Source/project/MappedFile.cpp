@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile()
+	: m_pData(nullptr)
+	, m_Size(0)
+#ifdef _WIN32
+	, m_hFile(INVALID_HANDLE_VALUE)
+	, m_hMapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const string& filePath)
+{
+	Close();
+
+	m_hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize{};
+	if (GetFileSizeEx(m_hFile, &fileSize) == FALSE || fileSize.QuadPart <= 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_hMapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_pData == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_Size = size_t(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_pData)
+		UnmapViewOfFile(m_pData);
+	if (m_hMapping)
+		CloseHandle(m_hMapping);
+	if (m_hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(m_hFile);
+
+	m_pData = nullptr;
+	m_Size = 0;
+	m_hMapping = nullptr;
+	m_hFile = INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::Open(const string& filePath)
+{
+	Close();
+
+	const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat fileStats{};
+	if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size <= 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, so the descriptor can be closed right away
+	void* pData = mmap(nullptr, size_t(fileStats.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (pData == MAP_FAILED)
+		return false;
+
+	m_pData = static_cast<const uint8_t*>(pData);
+	m_Size = size_t(fileStats.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_pData)
+		munmap(const_cast<uint8_t*>(m_pData), m_Size);
+
+	m_pData = nullptr;
+	m_Size = 0;
+}
+#endif
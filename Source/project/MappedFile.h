@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+// Read-only memory mapping of a whole file
+// The contents stay valid (and unmodified) until Close() is called or the object is destroyed
+class MappedFile final
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const string& filePath); // Fails for missing and empty files
+	void Close();
+
+	bool IsOpen() const { return m_pData != nullptr; }
+	const uint8_t* GetData() const { return m_pData; }
+	size_t GetSize() const { return m_Size; }
+
+private:
+	const uint8_t* m_pData;
+	size_t m_Size;
+
+#ifdef _WIN32
+	void* m_hFile;
+	void* m_hMapping;
+#endif
+};
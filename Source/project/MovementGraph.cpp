@@ -0,0 +1,91 @@
+#include "stdafx.h"
+#include "MovementGraph.h"
+#include "StatesTransitions.h"
+#include "FSMArena.h"
+
+template class StaticFiniteStateMachine<MovementStates, MovementTransitions, MovementEdges>;
+
+namespace
+{
+	template<typename... TStates>
+	void AddStates(MovementGraph& graph, FSMTypeList<TStates...>)
+	{
+		graph.States = { get<TStates*>(graph.TypedStates)... };
+	}
+
+	template<typename... TTransitions>
+	void AddTransitions(MovementGraph& graph, FSMTypeList<TTransitions...>)
+	{
+		graph.Transitions = { get<TTransitions*>(graph.TypedTransitions)... };
+	}
+
+	template<typename... TEdges>
+	void AddEdges(MovementGraph& graph, FSMTypeList<TEdges...>)
+	{
+		graph.Edges = { MovementGraph::Edge{ get<typename TEdges::From*>(graph.TypedStates), get<typename TEdges::To*>(graph.TypedStates),
+			get<typename TEdges::Transition*>(graph.TypedTransitions) }... };
+	}
+}
+
+MovementGraph CreateMovementGraph(FSMArena& arena, Inventory* pInventory, const EnemyTracks* pEnemyTracks, const DangerField* pDangerField, const InfluenceMap* pInfluenceMap, HouseMemory* pHouseMemory, const NavGrid* pNavGrid, uint32_t randomSeed)
+{
+	// Every state that wanders gets its own seed
+	seed_seq seeds{ randomSeed };
+	uint32_t stateSeeds[5]{};
+	seeds.generate(begin(stateSeeds), end(stateSeeds));
+
+	// Create all the needed states and transitions (how they're wired together is in MovementEdges)
+	auto* pWanderLookingBackState = arena.Create<WanderLookingBackState>(pInfluenceMap, stateSeeds[0]);
+	auto* pFleeEnemiesState = arena.Create<FleeEnemiesState>(pEnemyTracks, pDangerField);
+	auto* pSeekHouseState = arena.Create<SeekHouseState>(pHouseMemory, pInfluenceMap, pNavGrid, stateSeeds[1]);
+	auto* pLookAroundHouseState = arena.Create<LookAroundHouseState>(stateSeeds[2]);
+	auto* pSeekItemsState = arena.Create<SeekItemsState>(pInventory);
+	auto* pExitHouseState = arena.Create<ExitHouseState>(pNavGrid, stateSeeds[3]);
+	auto* pComeBackToTownState = arena.Create<ComeBackToTownState>();
+	auto* pFleePurgeZonesState = arena.Create<FleePurgeZonesState>(pInfluenceMap, pNavGrid, stateSeeds[4]);
+
+	auto* pEnemySpotted = arena.Create<EnemySpotted>();
+	auto* pNewHouseSpotted = arena.Create<NewHouseSpotted>(pHouseMemory);
+	auto* pAllItemsCloseByTaken = arena.Create<AllItemsCloseByTaken>();
+	auto* pInsideAlreadyLootedHouse = arena.Create<InsideHouse>();
+	auto* pHouseCenterReached = arena.Create<HouseCenterReached>();
+	auto* pItemSpotted = arena.Create<ItemSpotted>();
+	auto* pTooFarAwayFromTown = arena.Create<TooFarAwayFromTown>();
+	auto* pInsidePurgeZone = arena.Create<InsidePurgeZone>();
+	auto* pEscapedFromEnemies = arena.Create<EscapedFromEnemies>();
+	auto* pExitedHouse = arena.Create<ExitedHouse>();
+	auto* pReturnedToTown = arena.Create<ReturnedToTown>();
+	auto* pPurgeZoneFled = arena.Create<PurgeZoneFled>();
+
+	MovementGraph graph{};
+	graph.TypedStates = make_tuple(pWanderLookingBackState, pFleeEnemiesState, pSeekHouseState, pLookAroundHouseState, pSeekItemsState,
+		pExitHouseState, pComeBackToTownState, pFleePurgeZonesState);
+	graph.TypedTransitions = make_tuple(pEnemySpotted, pNewHouseSpotted, pAllItemsCloseByTaken, pInsideAlreadyLootedHouse, pHouseCenterReached,
+		pItemSpotted, pTooFarAwayFromTown, pInsidePurgeZone, pEscapedFromEnemies, pExitedHouse, pReturnedToTown, pPurgeZoneFled);
+	graph.pStartState = get<0>(graph.TypedStates);
+	AddStates(graph, MovementStates{});
+	AddTransitions(graph, MovementTransitions{});
+	AddEdges(graph, MovementEdges{});
+
+	// Budgets, the states that plan routes get the most (a plan's a lot more than a tick of steering)
+	pWanderLookingBackState->SetBudget(FSMBudget{ 50.f });
+	pFleeEnemiesState->SetBudget(FSMBudget{ 50.f });
+	pSeekHouseState->SetBudget(FSMBudget{ 250.f });
+	pLookAroundHouseState->SetBudget(FSMBudget{ 20.f });
+	pSeekItemsState->SetBudget(FSMBudget{ 20.f });
+	pExitHouseState->SetBudget(FSMBudget{ 250.f });
+	pComeBackToTownState->SetBudget(FSMBudget{ 20.f });
+	pFleePurgeZonesState->SetBudget(FSMBudget{ 250.f });
+
+	// The guards that only read the agent or a counter are cheap enough to check every tick
+	// The ones going through what's in the FOV (looking up houses, scanning the purge zones) only get checked every few ticks
+	// (a house or purge zone doesn't go anywhere in the meantime, and a purge zone takes a while to hurt)
+	for (auto* pTransition : initializer_list<FSMTransition*>{ pEnemySpotted, pAllItemsCloseByTaken, pInsideAlreadyLootedHouse, pItemSpotted,
+		pTooFarAwayFromTown, pEscapedFromEnemies, pExitedHouse, pReturnedToTown, pPurgeZoneFled })
+		pTransition->SetBudget(FSMBudget{ 5.f });
+	pNewHouseSpotted->SetBudget(FSMBudget{ 10.f, 4 });
+	pHouseCenterReached->SetBudget(FSMBudget{ 10.f, 4 });
+	pInsidePurgeZone->SetBudget(FSMBudget{ 10.f, 2 });
+
+	return graph;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include "StaticFiniteStateMachine.h"
+
+class FSMState;
+class FSMTransition;
+class FSMArena;
+class Inventory;
+class EnemyTracks;
+class DangerField;
+class InfluenceMap;
+class HouseMemory;
+class NavGrid;
+
+class WanderLookingBackState;
+class FleeEnemiesState;
+class SeekHouseState;
+class LookAroundHouseState;
+class SeekItemsState;
+class ExitHouseState;
+class ComeBackToTownState;
+class FleePurgeZonesState;
+
+class EnemySpotted;
+class NewHouseSpotted;
+class AllItemsCloseByTaken;
+class InsideHouse;
+class HouseCenterReached;
+class ItemSpotted;
+class TooFarAwayFromTown;
+class InsidePurgeZone;
+class EscapedFromEnemies;
+class ExitedHouse;
+class ReturnedToTown;
+class PurgeZoneFled;
+
+// The movement decision graph's layout, the same for both FSMs (the runtime one gets it as MovementGraph::Edges)
+// Start off wandering
+using MovementStates = FSMTypeList<WanderLookingBackState, FleeEnemiesState, SeekHouseState, LookAroundHouseState, SeekItemsState,
+	ExitHouseState, ComeBackToTownState, FleePurgeZonesState>;
+using MovementTransitions = FSMTypeList<EnemySpotted, NewHouseSpotted, AllItemsCloseByTaken, InsideHouse, HouseCenterReached, ItemSpotted,
+	TooFarAwayFromTown, InsidePurgeZone, EscapedFromEnemies, ExitedHouse, ReturnedToTown, PurgeZoneFled>;
+using MovementEdges = FSMTypeList<
+	// Flee from enemies
+	FSMEdge<WanderLookingBackState, FleeEnemiesState, EnemySpotted>,
+
+	// Seek un-scavenged houses
+	FSMEdge<FleeEnemiesState, SeekHouseState, NewHouseSpotted>,
+	FSMEdge<WanderLookingBackState, SeekHouseState, NewHouseSpotted>,
+
+	// Evacuate from a house
+	FSMEdge<LookAroundHouseState, ExitHouseState, AllItemsCloseByTaken>, // After looting said house (the most common one)
+	FSMEdge<WanderLookingBackState, ExitHouseState, InsideHouse>, // If the agent randomly wanders into an already looted house (which should be rare)
+
+	// Look around the house
+	FSMEdge<SeekHouseState, LookAroundHouseState, HouseCenterReached>, // After arriving at the house center
+	FSMEdge<SeekItemsState, LookAroundHouseState, AllItemsCloseByTaken>, // If all nearby items have been taken
+
+	// Seek items inside the house
+	FSMEdge<LookAroundHouseState, SeekItemsState, ItemSpotted>,
+	FSMEdge<SeekHouseState, SeekItemsState, ItemSpotted>,
+	FSMEdge<ExitHouseState, SeekItemsState, ItemSpotted>,
+
+	// Come back into the city (in case the agent ends up too far away from all the houses)
+	FSMEdge<WanderLookingBackState, ComeBackToTownState, TooFarAwayFromTown>,
+	FSMEdge<FleeEnemiesState, ComeBackToTownState, TooFarAwayFromTown>,
+
+	// Flee from purge zones
+	FSMEdge<WanderLookingBackState, FleePurgeZonesState, InsidePurgeZone>,
+	FSMEdge<FleeEnemiesState, FleePurgeZonesState, InsidePurgeZone>,
+	FSMEdge<SeekHouseState, FleePurgeZonesState, InsidePurgeZone>,
+	FSMEdge<LookAroundHouseState, FleePurgeZonesState, InsidePurgeZone>,
+	FSMEdge<SeekItemsState, FleePurgeZonesState, InsidePurgeZone>,
+	FSMEdge<ExitHouseState, FleePurgeZonesState, InsidePurgeZone>,
+	FSMEdge<ComeBackToTownState, FleePurgeZonesState, InsidePurgeZone>,
+
+	// Wander
+	FSMEdge<FleeEnemiesState, WanderLookingBackState, EscapedFromEnemies>, // After fleeing from enemies (if they're far away enough)
+	FSMEdge<ExitHouseState, WanderLookingBackState, ExitedHouse>, // After exiting a house
+	FSMEdge<ComeBackToTownState, WanderLookingBackState, ReturnedToTown>, // After returning to the relevant part of the map
+	FSMEdge<FleePurgeZonesState, WanderLookingBackState, PurgeZoneFled>>; // After fleeing from a purge zone
+
+// What the plugin runs the graph on (instantiated in MovementGraph.cpp, which is the only one that needs to see the states)
+using StaticMovementFSM = StaticFiniteStateMachine<MovementStates, MovementTransitions, MovementEdges>;
+extern template class StaticFiniteStateMachine<MovementStates, MovementTransitions, MovementEdges>;
+
+// The movement decision graph: every state and transition the bot uses, and how they're wired together
+// Plugin::SetUpMovementFSM() feeds it to the FSM (handing it the arena as well), the FSM benchmark builds its own copies with it
+struct MovementGraph
+{
+	struct Edge
+	{
+		FSMState* pFromState;
+		FSMState* pToState;
+		FSMTransition* pTransition;
+	};
+
+	FSMState* pStartState;
+	vector<FSMState*> States; // Owned by the arena they were created in, in MovementStates' order
+	vector<FSMTransition*> Transitions; // Same, in MovementTransitions' order
+	vector<Edge> Edges; // MovementEdges, in priority order (for every state, the first transition that fires wins)
+	MovementStates::Pointers TypedStates; // The same ones, for StaticMovementFSM
+	MovementTransitions::Pointers TypedTransitions;
+};
+
+// The seed drives every random choice the states make (the same seed gives the same bot)
+// Without a (built) nav grid, the states follow the game's navmesh instead
+MovementGraph CreateMovementGraph(FSMArena& arena, Inventory* pInventory, const EnemyTracks* pEnemyTracks, const DangerField* pDangerField, const InfluenceMap* pInfluenceMap, HouseMemory* pHouseMemory, const NavGrid* pNavGrid, uint32_t randomSeed);
@@ -0,0 +1,440 @@
+#include "stdafx.h"
+#include "NavGrid.h"
+#include "LevelData.h"
+#include <climits>
+#include <cfloat>
+
+namespace
+{
+	const float g_Sqrt2{ 1.41421356f };
+
+	// Every wall polygon in the level is an axis-aligned quad, so its bounding box is the wall itself
+	float DistanceSquaredToBox(const Elite::Vector2& point, const Elite::Vector2& boxMin, const Elite::Vector2& boxMax)
+	{
+		const auto dx = max(max(boxMin.x - point.x, 0.f), point.x - boxMax.x);
+		const auto dy = max(max(boxMin.y - point.y, 0.f), point.y - boxMax.y);
+		return dx * dx + dy * dy;
+	}
+}
+
+NavGrid::NavGrid()
+	: m_Walkable()
+	, m_Origin()
+	, m_CellSize(1.f)
+	, m_Width(0)
+	, m_Height(0)
+	, m_SearchStamp(0)
+	, m_LastExpandedCount(0)
+{
+}
+
+bool NavGrid::Build(const LevelData& level, float agentRadius, float cellSize)
+{
+	Clear();
+	if (level.IsLoaded() == false || cellSize <= 0.f)
+		return false;
+
+	// The world's centered on the origin
+	const auto& dimensions = level.GetDimensions();
+	m_CellSize = cellSize;
+	m_Origin = dimensions / -2.f;
+	m_Width = max(1, int(ceilf(dimensions.x / cellSize)));
+	m_Height = max(1, int(ceilf(dimensions.y / cellSize)));
+	m_Walkable.assign(size_t(m_Width) * m_Height, 1);
+
+	// A cell stays walkable when the agent can stand anywhere in it, so its center has to keep the radius plus (most of) the cell's diagonal away
+	const auto clearance = agentRadius + cellSize * 0.75f;
+	for (const auto& house : level.GetHouses())
+	{
+		for (const auto& wall : level.GetWalls(house))
+		{
+			const auto minX = max(0, int(floorf((wall.Min.x - clearance - m_Origin.x) / cellSize)));
+			const auto minY = max(0, int(floorf((wall.Min.y - clearance - m_Origin.y) / cellSize)));
+			const auto maxX = min(m_Width - 1, int(floorf((wall.Max.x + clearance - m_Origin.x) / cellSize)));
+			const auto maxY = min(m_Height - 1, int(floorf((wall.Max.y + clearance - m_Origin.y) / cellSize)));
+			for (int cellY = minY; cellY <= maxY; ++cellY)
+			{
+				for (int cellX = minX; cellX <= maxX; ++cellX)
+				{
+					const auto cellIdx = cellY * m_Width + cellX;
+					if (DistanceSquaredToBox(GetCellCenter(cellIdx), wall.Min, wall.Max) < clearance * clearance)
+						m_Walkable[cellIdx] = 0;
+				}
+			}
+		}
+	}
+
+	const auto nrOfCells = m_Walkable.size();
+	m_CostSoFar.assign(nrOfCells, 0.f);
+	m_Parents.assign(nrOfCells, -1);
+	m_Stamps.assign(nrOfCells, 0);
+	m_SearchStamp = 0;
+	return true;
+}
+
+void NavGrid::Clear()
+{
+	m_Walkable.clear();
+	m_CostSoFar.clear();
+	m_Parents.clear();
+	m_Stamps.clear();
+	m_OpenList.clear();
+	m_Width = 0;
+	m_Height = 0;
+}
+
+bool NavGrid::IsWalkable(const Elite::Vector2& position) const
+{
+	const auto cellX = int(floorf((position.x - m_Origin.x) / m_CellSize));
+	const auto cellY = int(floorf((position.y - m_Origin.y) / m_CellSize));
+	return IsWalkable(cellX, cellY);
+}
+
+bool NavGrid::HasLineOfSight(const Elite::Vector2& from, const Elite::Vector2& to) const
+{
+	// Walks every cell the segment crosses (Amanatides & Woo)
+	const auto start = (from - m_Origin) / m_CellSize;
+	const auto end = (to - m_Origin) / m_CellSize;
+	auto cellX = int(floorf(start.x));
+	auto cellY = int(floorf(start.y));
+	const auto endX = int(floorf(end.x));
+	const auto endY = int(floorf(end.y));
+
+	const auto direction = end - start;
+	const int stepX = direction.x > 0.f ? 1 : -1;
+	const int stepY = direction.y > 0.f ? 1 : -1;
+	const auto deltaX = direction.x != 0.f ? abs(1.f / direction.x) : FLT_MAX;
+	const auto deltaY = direction.y != 0.f ? abs(1.f / direction.y) : FLT_MAX;
+	auto nextX = direction.x > 0.f ? (float(cellX + 1) - start.x) * deltaX : direction.x < 0.f ? (start.x - float(cellX)) * deltaX : FLT_MAX;
+	auto nextY = direction.y > 0.f ? (float(cellY + 1) - start.y) * deltaY : direction.y < 0.f ? (start.y - float(cellY)) * deltaY : FLT_MAX;
+
+	for (int steps = abs(endX - cellX) + abs(endY - cellY); steps >= 0; --steps)
+	{
+		if (IsWalkable(cellX, cellY) == false)
+			return false;
+		if (cellX == endX && cellY == endY)
+			return true;
+
+		if (nextX < nextY)
+		{
+			cellX += stepX;
+			nextX += deltaX;
+		}
+		else if (nextY < nextX)
+		{
+			cellY += stepY;
+			nextY += deltaY;
+		}
+		else
+		{
+			// Right through a corner, both cells next to it have to be walkable
+			if (IsWalkable(cellX + stepX, cellY) == false || IsWalkable(cellX, cellY + stepY) == false)
+				return false;
+			cellX += stepX;
+			cellY += stepY;
+			nextX += deltaX;
+			nextY += deltaY;
+			--steps;
+		}
+	}
+	return IsWalkable(endX, endY);
+}
+
+bool NavGrid::FindPath(const Elite::Vector2& start, const Elite::Vector2& goal, vector<Elite::Vector2>& path) const
+{
+	path.clear();
+	if (IsBuilt() == false)
+		return false;
+
+	const bool isStartWalkable = IsWalkable(start);
+	const bool isGoalWalkable = IsWalkable(goal);
+	const auto startIdx = isStartWalkable ? GetCellIdx(start) : FindClosestWalkable(GetCellIdx(start));
+	const auto goalIdx = isGoalWalkable ? GetCellIdx(goal) : FindClosestWalkable(GetCellIdx(goal));
+	if (startIdx < 0 || goalIdx < 0)
+		return false;
+
+	const auto startPoint = isStartWalkable ? start : GetCellCenter(startIdx);
+	const auto goalPoint = isGoalWalkable ? goal : GetCellCenter(goalIdx);
+	if (isStartWalkable == false)
+		path.push_back(startPoint); // Get back onto the grid first
+
+	// Straight there
+	if (HasLineOfSight(startPoint, goalPoint))
+	{
+		m_LastExpandedCount = 0;
+		path.push_back(goalPoint);
+		return true;
+	}
+
+	if (Search(startIdx, goalIdx) == false)
+	{
+		path.clear();
+		return false;
+	}
+
+	// The jump points from the start to the goal (the start's left out), the only places where the way has to turn
+	m_JumpPath.clear();
+	for (auto cellIdx = goalIdx; cellIdx != startIdx; cellIdx = m_Parents[cellIdx])
+		m_JumpPath.push_back(cellIdx);
+	reverse(m_JumpPath.begin(), m_JumpPath.end());
+
+	// Pull it straight: from every waypoint, go for the furthest jump point that can still be seen
+	auto anchor = startPoint;
+	size_t nextIdx = 0;
+	while (nextIdx < m_JumpPath.size())
+	{
+		if (HasLineOfSight(anchor, goalPoint))
+			break;
+
+		auto visibleIdx = nextIdx; // The next one's always taken (it's a straight or diagonal line away), so there's progress even when it isn't quite visible
+		while (visibleIdx + 1 < m_JumpPath.size() && HasLineOfSight(anchor, GetCellCenter(m_JumpPath[visibleIdx + 1])))
+			++visibleIdx;
+
+		anchor = GetCellCenter(m_JumpPath[visibleIdx]);
+		path.push_back(anchor);
+		nextIdx = visibleIdx + 1;
+	}
+
+	path.push_back(goalPoint);
+	return true;
+}
+
+int NavGrid::GetCellIdx(const Elite::Vector2& position) const
+{
+	const auto cellX = Elite::Clamp(int(floorf((position.x - m_Origin.x) / m_CellSize)), 0, m_Width - 1);
+	const auto cellY = Elite::Clamp(int(floorf((position.y - m_Origin.y) / m_CellSize)), 0, m_Height - 1);
+	return cellY * m_Width + cellX;
+}
+
+Elite::Vector2 NavGrid::GetCellCenter(int cellIdx) const
+{
+	return m_Origin + Elite::Vector2{ float(cellIdx % m_Width) + 0.5f, float(cellIdx / m_Width) + 0.5f } * m_CellSize;
+}
+
+bool NavGrid::IsWalkable(int cellX, int cellY) const
+{
+	return cellX >= 0 && cellY >= 0 && cellX < m_Width && cellY < m_Height && m_Walkable[cellY * m_Width + cellX] != 0;
+}
+
+int NavGrid::FindClosestWalkable(int cellIdx) const
+{
+	const auto centerX = cellIdx % m_Width;
+	const auto centerY = cellIdx / m_Width;
+	if (IsWalkable(centerX, centerY))
+		return cellIdx;
+
+	// Ring by ring, the closest one in the first ring that has any
+	for (int radius = 1; radius <= m_MaxSnapRadius; ++radius)
+	{
+		int closestIdx = -1;
+		int closestDistanceSquared = INT_MAX;
+		for (int offsetY = -radius; offsetY <= radius; ++offsetY)
+		{
+			for (int offsetX = -radius; offsetX <= radius; ++offsetX)
+			{
+				if (max(abs(offsetX), abs(offsetY)) != radius || IsWalkable(centerX + offsetX, centerY + offsetY) == false)
+					continue;
+
+				const auto distanceSquared = offsetX * offsetX + offsetY * offsetY;
+				if (distanceSquared < closestDistanceSquared)
+				{
+					closestDistanceSquared = distanceSquared;
+					closestIdx = (centerY + offsetY) * m_Width + centerX + offsetX;
+				}
+			}
+		}
+
+		if (closestIdx >= 0)
+			return closestIdx;
+	}
+	return -1;
+}
+
+bool NavGrid::Search(int startIdx, int goalIdx) const
+{
+	// New stamp (even, the lowest bit marks closed cells), starting over once it wraps around
+	m_SearchStamp += 2;
+	if (m_SearchStamp == 0)
+	{
+		fill(m_Stamps.begin(), m_Stamps.end(), 0u);
+		m_SearchStamp = 2;
+	}
+	const auto openStamp = m_SearchStamp;
+	const auto closedStamp = m_SearchStamp | 1u;
+
+	m_OpenList.clear();
+	m_LastExpandedCount = 0;
+	m_CostSoFar[startIdx] = 0.f;
+	m_Parents[startIdx] = -1;
+	m_Stamps[startIdx] = openStamp;
+	m_OpenList.push_back(OpenNode{ Heuristic(startIdx, goalIdx), startIdx });
+
+	int directionsX[8]{};
+	int directionsY[8]{};
+	while (m_OpenList.empty() == false)
+	{
+		pop_heap(m_OpenList.begin(), m_OpenList.end());
+		const auto cellIdx = m_OpenList.back().CellIdx;
+		m_OpenList.pop_back();
+
+		// Cells can be in the open list more than once (whenever a cheaper way got found), only the first one counts
+		if (m_Stamps[cellIdx] == closedStamp)
+			continue;
+		m_Stamps[cellIdx] = closedStamp;
+		++m_LastExpandedCount;
+
+		if (cellIdx == goalIdx)
+			return true;
+
+		// Only jump on in the directions that aren't covered by another way there already
+		const auto nrOfDirections = GetJumpDirections(cellIdx, directionsX, directionsY);
+		for (int i = 0; i < nrOfDirections; ++i)
+		{
+			const auto jumpIdx = Jump(cellIdx % m_Width + directionsX[i], cellIdx / m_Width + directionsY[i], directionsX[i], directionsY[i], goalIdx);
+			if (jumpIdx < 0)
+				continue;
+
+			const auto cost = m_CostSoFar[cellIdx] + GetOctileDistance(cellIdx, jumpIdx);
+			const auto jumpStamp = m_Stamps[jumpIdx];
+			if (jumpStamp == closedStamp || (jumpStamp == openStamp && cost >= m_CostSoFar[jumpIdx]))
+				continue;
+
+			m_CostSoFar[jumpIdx] = cost;
+			m_Parents[jumpIdx] = cellIdx;
+			m_Stamps[jumpIdx] = openStamp;
+			m_OpenList.push_back(OpenNode{ cost + Heuristic(jumpIdx, goalIdx), jumpIdx });
+			push_heap(m_OpenList.begin(), m_OpenList.end());
+		}
+	}
+	return false;
+}
+
+int NavGrid::GetJumpDirections(int cellIdx, int* pDirectionsX, int* pDirectionsY) const
+{
+	const auto cellX = cellIdx % m_Width;
+	const auto cellY = cellIdx / m_Width;
+	int count = 0;
+	const auto add = [&count, pDirectionsX, pDirectionsY](int dx, int dy)
+	{
+		pDirectionsX[count] = dx;
+		pDirectionsY[count] = dy;
+		++count;
+	};
+
+	// The start goes everywhere (diagonally only when both cells next to it are free, no cutting corners)
+	const auto parentIdx = m_Parents[cellIdx];
+	if (parentIdx < 0)
+	{
+		for (int dy = -1; dy <= 1; ++dy)
+		{
+			for (int dx = -1; dx <= 1; ++dx)
+			{
+				if ((dx != 0 || dy != 0) && IsWalkable(cellX + dx, cellY + dy) && IsWalkable(cellX + dx, cellY) && IsWalkable(cellX, cellY + dy))
+					add(dx, dy);
+			}
+		}
+		return count;
+	}
+
+	const auto dx = Elite::Clamp(cellX - parentIdx % m_Width, -1, 1);
+	const auto dy = Elite::Clamp(cellY - parentIdx / m_Width, -1, 1);
+	if (dx != 0 && dy != 0)
+	{
+		// Diagonally: keep going, and both straight directions it's made of
+		const bool isHorizontalWalkable = IsWalkable(cellX + dx, cellY);
+		const bool isVerticalWalkable = IsWalkable(cellX, cellY + dy);
+		if (isVerticalWalkable)
+			add(0, dy);
+		if (isHorizontalWalkable)
+			add(dx, 0);
+		if (isHorizontalWalkable && isVerticalWalkable && IsWalkable(cellX + dx, cellY + dy))
+			add(dx, dy);
+	}
+	else if (dx != 0)
+	{
+		// Straight: keep going, plus whatever opens up to the sides
+		const bool isNextWalkable = IsWalkable(cellX + dx, cellY);
+		const bool isAboveWalkable = IsWalkable(cellX, cellY + 1);
+		const bool isBelowWalkable = IsWalkable(cellX, cellY - 1);
+		if (isNextWalkable)
+		{
+			add(dx, 0);
+			if (isAboveWalkable && IsWalkable(cellX + dx, cellY + 1))
+				add(dx, 1);
+			if (isBelowWalkable && IsWalkable(cellX + dx, cellY - 1))
+				add(dx, -1);
+		}
+		if (isAboveWalkable)
+			add(0, 1);
+		if (isBelowWalkable)
+			add(0, -1);
+	}
+	else
+	{
+		const bool isNextWalkable = IsWalkable(cellX, cellY + dy);
+		const bool isRightWalkable = IsWalkable(cellX + 1, cellY);
+		const bool isLeftWalkable = IsWalkable(cellX - 1, cellY);
+		if (isNextWalkable)
+		{
+			add(0, dy);
+			if (isRightWalkable && IsWalkable(cellX + 1, cellY + dy))
+				add(1, dy);
+			if (isLeftWalkable && IsWalkable(cellX - 1, cellY + dy))
+				add(-1, dy);
+		}
+		if (isRightWalkable)
+			add(1, 0);
+		if (isLeftWalkable)
+			add(-1, 0);
+	}
+	return count;
+}
+
+int NavGrid::Jump(int cellX, int cellY, int dx, int dy, int goalIdx) const
+{
+	// Keeps going in one direction until there's a reason to stop: the goal, or a cell with a way around a wall (a "forced" neighbor)
+	while (IsWalkable(cellX, cellY))
+	{
+		const auto cellIdx = cellY * m_Width + cellX;
+		if (cellIdx == goalIdx)
+			return cellIdx;
+
+		if (dx != 0 && dy != 0)
+		{
+			// A diagonal stops wherever one of its straight directions would
+			if (Jump(cellX + dx, cellY, dx, 0, goalIdx) >= 0 || Jump(cellX, cellY + dy, 0, dy, goalIdx) >= 0)
+				return cellIdx;
+
+			// No cutting corners
+			if (IsWalkable(cellX + dx, cellY) == false || IsWalkable(cellX, cellY + dy) == false)
+				return -1;
+		}
+		else if (dx != 0)
+		{
+			if ((IsWalkable(cellX, cellY + 1) && IsWalkable(cellX - dx, cellY + 1) == false) || (IsWalkable(cellX, cellY - 1) && IsWalkable(cellX - dx, cellY - 1) == false))
+				return cellIdx;
+		}
+		else
+		{
+			if ((IsWalkable(cellX + 1, cellY) && IsWalkable(cellX + 1, cellY - dy) == false) || (IsWalkable(cellX - 1, cellY) && IsWalkable(cellX - 1, cellY - dy) == false))
+				return cellIdx;
+		}
+
+		cellX += dx;
+		cellY += dy;
+	}
+	return -1;
+}
+
+float NavGrid::Heuristic(int cellIdx, int goalIdx) const
+{
+	// Octile distance, a hair over so ties get broken towards the goal
+	return GetOctileDistance(cellIdx, goalIdx) * 1.001f;
+}
+
+float NavGrid::GetOctileDistance(int fromIdx, int toIdx) const
+{
+	const auto dx = float(abs(fromIdx % m_Width - toIdx % m_Width));
+	const auto dy = float(abs(fromIdx / m_Width - toIdx / m_Width));
+	return (max(dx, dy) + (g_Sqrt2 - 1.f) * min(dx, dy)) * m_CellSize;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+
+class LevelData;
+
+// Plugin-side navigation, built from the level's walls (see LevelData) instead of asking the game for one waypoint at a time
+// A uniform grid over the world where a cell is walkable when its center keeps the agent's radius away from every wall,
+// searched with jump point search (A* that only puts the cells where the way has to turn in the open list, 8-connected without cutting corners)
+// and pulled straight afterwards (a waypoint is only kept where the line of sight breaks)
+// The search buffers belong to the grid and are reused: every cell's search state is stamped with the search that wrote it,
+// so nothing has to be cleared in between, and a search doesn't allocate once the open list has grown
+class NavGrid final
+{
+public:
+	NavGrid();
+	~NavGrid() = default;
+
+	NavGrid(const NavGrid&) = delete;
+	NavGrid& operator=(const NavGrid&) = delete;
+
+	bool Build(const LevelData& level, float agentRadius, float cellSize = 1.f);
+	void Clear();
+	bool IsBuilt() const { return m_Walkable.empty() == false; }
+
+	bool IsWalkable(const Elite::Vector2& position) const;
+	bool HasLineOfSight(const Elite::Vector2& from, const Elite::Vector2& to) const; // Only through walkable cells
+
+	// Fills in the waypoints from start to goal (start excluded, the goal being the last one)
+	// When either isn't walkable, the closest walkable cell is used instead. False (and no path) when the goal can't be reached
+	bool FindPath(const Elite::Vector2& start, const Elite::Vector2& goal, vector<Elite::Vector2>& path) const;
+	size_t GetLastExpandedCount() const { return m_LastExpandedCount; } // Jump points the last search went through
+
+private:
+	struct OpenNode
+	{
+		float F;
+		int CellIdx;
+
+		bool operator<(const OpenNode& other) const { return F > other.F; } // For a min-heap through the std heap functions
+	};
+
+	int GetCellIdx(const Elite::Vector2& position) const; // Clamped to the grid
+	Elite::Vector2 GetCellCenter(int cellIdx) const;
+	bool IsWalkable(int cellX, int cellY) const;
+	int FindClosestWalkable(int cellIdx) const; // -1 if there's none around
+	bool Search(int startIdx, int goalIdx) const;
+	int GetJumpDirections(int cellIdx, int* pDirectionsX, int* pDirectionsY) const; // Up to 8, pruned by the way the cell was reached
+	int Jump(int cellX, int cellY, int dx, int dy, int goalIdx) const; // The next jump point that way, -1 if there's none
+	float Heuristic(int cellIdx, int goalIdx) const;
+	float GetOctileDistance(int fromIdx, int toIdx) const;
+
+	vector<uint8_t> m_Walkable;
+	Elite::Vector2 m_Origin; // Lower-left corner of the grid
+	float m_CellSize;
+	int m_Width;
+	int m_Height;
+
+	// Search buffers (mutable, searching doesn't change the grid itself)
+	mutable vector<float> m_CostSoFar;
+	mutable vector<int> m_Parents;
+	mutable vector<uint32_t> m_Stamps; // Search that last touched the cell, its lowest bit set once it's closed
+	mutable vector<OpenNode> m_OpenList;
+	mutable vector<int> m_JumpPath;
+	mutable uint32_t m_SearchStamp;
+	mutable size_t m_LastExpandedCount;
+
+	const int m_MaxSnapRadius{ 8 }; // In cells, for starts and goals that aren't walkable
+};
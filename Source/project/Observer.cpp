@@ -1,2 +0,0 @@
-#include "stdafx.h"
-#include "Observer.h"
@@ -0,0 +1,229 @@
+#include "stdafx.h"
+#include "PathFollower.h"
+#include "NavGrid.h"
+#include "DebugDrawList.h"
+#include <IExamInterface.h>
+#include <cstring>
+
+namespace
+{
+	const uint32_t g_NoEntry{ UINT32_MAX };
+
+	size_t HashBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return size_t(bits);
+	}
+}
+
+size_t PathFollower::CacheKeyHash::operator()(const CacheKey& key) const
+{
+	size_t hash = size_t(uint32_t(key.CellX)) * 0x9E3779B1u ^ size_t(uint32_t(key.CellY)) * 0x85EBCA77u;
+	hash ^= HashBits(key.Goal.x) + 0x7F4A7C15u + (hash << 6) + (hash >> 2);
+	hash ^= HashBits(key.Goal.y) + 0x7F4A7C15u + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+PathFollower::PathFollower(size_t cacheCapacity, float cellSize, float corridorWidth, float arrivalRange)
+	: m_Goal()
+	, m_CorridorStart()
+	, m_Waypoint()
+	, m_HasWaypoint(false)
+	, m_pNavGrid(nullptr)
+	, m_Route()
+	, m_RouteIdx(0)
+	, m_Entries()
+	, m_EntryIndices()
+	, m_MostRecent(g_NoEntry)
+	, m_LeastRecent(g_NoEntry)
+	, m_CacheCapacity(max(size_t(1), cacheCapacity))
+	, m_CellSize(cellSize)
+	, m_CorridorWidth(corridorWidth)
+	, m_ArrivalRange(arrivalRange)
+	, m_QueryCount(0)
+	, m_CacheHits(0)
+	, m_PlanCount(0)
+{
+	m_Entries.reserve(m_CacheCapacity);
+	m_EntryIndices.reserve(m_CacheCapacity);
+}
+
+bool PathFollower::HasNavigation() const
+{
+	return m_pNavGrid != nullptr && m_pNavGrid->IsBuilt();
+}
+
+void PathFollower::SetGoal(const Elite::Vector2& goal)
+{
+	if (m_HasWaypoint && goal == m_Goal)
+		return;
+
+	m_Goal = goal;
+	m_HasWaypoint = false;
+}
+
+const Elite::Vector2& PathFollower::GetWaypoint(IExamInterface* pInterface, const Elite::Vector2& agentPosition)
+{
+	if (HasNavigation())
+		return GetPlannedWaypoint(agentPosition);
+
+	// Keep going for the current waypoint while the agent's still on its way there
+	// (the goal itself is never "reached" here, whoever follows the path decides when it's close enough)
+	if (m_HasWaypoint && IsOnCorridor(agentPosition) && (m_Waypoint == m_Goal || IsReached(m_Waypoint, agentPosition) == false))
+		return m_Waypoint;
+
+	// Then try whatever the navmesh answered last time from around here
+	const auto key = GetKey(agentPosition);
+	const auto it = m_EntryIndices.find(key);
+	if (it != m_EntryIndices.end() && (m_Entries[it->second].Waypoint == m_Goal || IsReached(m_Entries[it->second].Waypoint, agentPosition) == false))
+	{
+		Unlink(it->second);
+		PushFront(it->second);
+		m_Waypoint = m_Entries[it->second].Waypoint;
+		++m_CacheHits;
+	}
+	else
+	{
+		m_Waypoint = pInterface->NavMesh_GetClosestPathPoint(m_Goal);
+		CacheWaypoint(key, m_Waypoint);
+		++m_QueryCount;
+	}
+
+	m_CorridorStart = agentPosition;
+	m_HasWaypoint = true;
+	return m_Waypoint;
+}
+
+void PathFollower::DebugDraw(DebugDrawList& drawList, const Elite::Vector2& agentPosition) const
+{
+	if (m_HasWaypoint == false || drawList.IsEnabled(eDebugDrawCategory::Paths) == false)
+		return;
+
+	// The legs still ahead of a planned route, or the corridor to the navmesh's waypoint (and on to the goal)
+	auto legStart = agentPosition;
+	if (HasNavigation())
+	{
+		for (size_t routeIdx = m_RouteIdx; routeIdx < m_Route.size(); ++routeIdx)
+		{
+			drawList.AddSegment(eDebugDrawCategory::Paths, legStart, m_Route[routeIdx], { 1, 1, 0 });
+			legStart = m_Route[routeIdx];
+		}
+	}
+	else
+	{
+		drawList.AddSegment(eDebugDrawCategory::Paths, m_CorridorStart, m_Waypoint, { 1, 1, 0 });
+		drawList.AddSegment(eDebugDrawCategory::Paths, m_Waypoint, m_Goal, { 0.5f, 0.5f, 0 });
+	}
+	drawList.AddCircle(eDebugDrawCategory::Paths, m_Goal, 1.f, { 1, 1, 0 });
+}
+
+const Elite::Vector2& PathFollower::GetPlannedWaypoint(const Elite::Vector2& agentPosition)
+{
+	if (m_HasWaypoint && IsOnCorridor(agentPosition))
+	{
+		// Next leg once this waypoint's reached (the last one's never "reached", like the goal)
+		while (m_RouteIdx + 1 < m_Route.size() && IsReached(m_Waypoint, agentPosition))
+		{
+			m_CorridorStart = m_Waypoint;
+			m_Waypoint = m_Route[++m_RouteIdx];
+		}
+		return m_Waypoint;
+	}
+
+	// No way there (walled in, or the grid doesn't cover it), just head straight for the goal
+	if (m_pNavGrid->FindPath(agentPosition, m_Goal, m_Route) == false || m_Route.empty())
+		m_Route.assign(1, m_Goal);
+	++m_PlanCount;
+
+	m_RouteIdx = 0;
+	m_Waypoint = m_Route[0];
+	m_CorridorStart = agentPosition;
+	m_HasWaypoint = true;
+	return m_Waypoint;
+}
+
+bool PathFollower::IsOnCorridor(const Elite::Vector2& agentPosition) const
+{
+	// Distance to the segment from where the waypoint was asked for, to the waypoint
+	const auto segment = m_Waypoint - m_CorridorStart;
+	const auto lengthSquared = segment.Dot(segment);
+	auto closestPoint = m_CorridorStart;
+	if (lengthSquared > 0.f)
+	{
+		const auto t = Elite::Clamp(Elite::Dot(agentPosition - m_CorridorStart, segment) / lengthSquared, 0.f, 1.f);
+		closestPoint += segment * t;
+	}
+	return closestPoint.DistanceSquared(agentPosition) <= m_CorridorWidth * m_CorridorWidth;
+}
+
+bool PathFollower::IsReached(const Elite::Vector2& waypoint, const Elite::Vector2& agentPosition) const
+{
+	return waypoint.DistanceSquared(agentPosition) <= m_ArrivalRange * m_ArrivalRange;
+}
+
+PathFollower::CacheKey PathFollower::GetKey(const Elite::Vector2& agentPosition) const
+{
+	return CacheKey{ int(floorf(agentPosition.x / m_CellSize)), int(floorf(agentPosition.y / m_CellSize)), m_Goal };
+}
+
+void PathFollower::CacheWaypoint(const CacheKey& key, const Elite::Vector2& waypoint)
+{
+	const auto it = m_EntryIndices.find(key);
+	if (it != m_EntryIndices.end())
+	{
+		// Got asked again (it was reached from here already), keep the newer answer
+		m_Entries[it->second].Waypoint = waypoint;
+		Unlink(it->second);
+		PushFront(it->second);
+		return;
+	}
+
+	uint32_t entryIdx = 0;
+	if (m_Entries.size() < m_CacheCapacity)
+	{
+		entryIdx = uint32_t(m_Entries.size());
+		m_Entries.push_back(CacheEntry{});
+	}
+	else
+	{
+		// Full, evict the least recently used one
+		entryIdx = m_LeastRecent;
+		Unlink(entryIdx);
+		m_EntryIndices.erase(m_Entries[entryIdx].Key);
+	}
+
+	m_Entries[entryIdx].Key = key;
+	m_Entries[entryIdx].Waypoint = waypoint;
+	m_EntryIndices[key] = entryIdx;
+	PushFront(entryIdx);
+}
+
+void PathFollower::Unlink(uint32_t entryIdx)
+{
+	auto& entry = m_Entries[entryIdx];
+	if (entry.Prev != g_NoEntry)
+		m_Entries[entry.Prev].Next = entry.Next;
+	else
+		m_MostRecent = entry.Next;
+
+	if (entry.Next != g_NoEntry)
+		m_Entries[entry.Next].Prev = entry.Prev;
+	else
+		m_LeastRecent = entry.Prev;
+
+	entry.Prev = g_NoEntry;
+	entry.Next = g_NoEntry;
+}
+
+void PathFollower::PushFront(uint32_t entryIdx)
+{
+	auto& entry = m_Entries[entryIdx];
+	entry.Prev = g_NoEntry;
+	entry.Next = m_MostRecent;
+	if (m_MostRecent != g_NoEntry)
+		m_Entries[m_MostRecent].Prev = entryIdx;
+	m_MostRecent = entryIdx;
+	if (m_LeastRecent == g_NoEntry)
+		m_LeastRecent = entryIdx;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include <unordered_map>
+
+class IExamInterface;
+class NavGrid;
+class DebugDrawList;
+
+// Follows the navmesh path towards a goal, one waypoint (NavMesh_GetClosestPathPoint()) at a time, without asking for it every frame
+// The waypoint is only asked for again when the goal changes, when it's reached, or when the agent strays too far from the corridor
+// (the segment from where it was asked for to the waypoint). Every answer is also cached by (start cell, goal) in a small LRU,
+// so coming back along the same way (or getting unstuck and trying again) doesn't cost another path search either
+//
+// Once it's given a built NavGrid, the whole route gets planned on it instead (same triggers: a new goal or leaving the corridor),
+// and the waypoints are followed one leg at a time, the game's navmesh not being asked anything anymore
+class PathFollower final
+{
+public:
+	explicit PathFollower(size_t cacheCapacity = 64, float cellSize = 2.f, float corridorWidth = 2.f, float arrivalRange = 1.5f);
+	~PathFollower() = default;
+
+	void SetNavGrid(const NavGrid* pNavGrid) { m_pNavGrid = pNavGrid; } // Not owned, nullptr goes back to the navmesh
+	bool HasNavigation() const; // Whether routes are planned on the nav grid (it's there and built)
+
+	void SetGoal(const Elite::Vector2& goal); // Keeps following the current path if it's the same goal
+	const Elite::Vector2& GetGoal() const { return m_Goal; }
+
+	// Where to seek to next
+	const Elite::Vector2& GetWaypoint(IExamInterface* pInterface, const Elite::Vector2& agentPosition);
+	void DebugDraw(DebugDrawList& drawList, const Elite::Vector2& agentPosition) const; // What's left of the route, or the corridor
+
+	unsigned long long GetQueryCount() const { return m_QueryCount; } // Navmesh queries done so far
+	unsigned long long GetCacheHits() const { return m_CacheHits; }
+	unsigned long long GetPlanCount() const { return m_PlanCount; } // Routes planned on the nav grid so far
+
+private:
+	struct CacheKey
+	{
+		int CellX;
+		int CellY;
+		Elite::Vector2 Goal;
+
+		bool operator==(const CacheKey& other) const { return CellX == other.CellX && CellY == other.CellY && Goal == other.Goal; }
+	};
+
+	struct CacheKeyHash
+	{
+		size_t operator()(const CacheKey& key) const;
+	};
+
+	struct CacheEntry
+	{
+		CacheKey Key;
+		Elite::Vector2 Waypoint;
+		uint32_t Prev; // Towards the most recently used one
+		uint32_t Next; // Towards the least recently used one
+	};
+
+	const Elite::Vector2& GetPlannedWaypoint(const Elite::Vector2& agentPosition);
+	bool IsOnCorridor(const Elite::Vector2& agentPosition) const;
+	bool IsReached(const Elite::Vector2& waypoint, const Elite::Vector2& agentPosition) const;
+	CacheKey GetKey(const Elite::Vector2& agentPosition) const;
+	void CacheWaypoint(const CacheKey& key, const Elite::Vector2& waypoint);
+	void Unlink(uint32_t entryIdx);
+	void PushFront(uint32_t entryIdx);
+
+	// Current path
+	Elite::Vector2 m_Goal;
+	Elite::Vector2 m_CorridorStart;
+	Elite::Vector2 m_Waypoint;
+	bool m_HasWaypoint;
+
+	// Route planned on the nav grid (the current waypoint being m_Route[m_RouteIdx])
+	const NavGrid* m_pNavGrid;
+	vector<Elite::Vector2> m_Route;
+	size_t m_RouteIdx;
+
+	// LRU of waypoints: entries in a doubly linked list by recency, found through the map
+	vector<CacheEntry> m_Entries;
+	unordered_map<CacheKey, uint32_t, CacheKeyHash> m_EntryIndices;
+	uint32_t m_MostRecent;
+	uint32_t m_LeastRecent;
+	const size_t m_CacheCapacity;
+
+	const float m_CellSize;
+	const float m_CorridorWidth;
+	const float m_ArrivalRange;
+
+	unsigned long long m_QueryCount;
+	unsigned long long m_CacheHits;
+	unsigned long long m_PlanCount;
+};
@@ -0,0 +1,111 @@
+#include "stdafx.h"
+#include "Perception.h"
+#include "Profiler.h"
+#include <IExamInterface.h>
+
+Perception::Perception()
+	: m_AgentInfo()
+	, m_WorldInfo()
+	, m_Stats()
+	, m_IsAgentInfoStale(false)
+{
+	m_Houses.reserve(m_ReservedHouses);
+	m_Items.reserve(m_ReservedEntities);
+	m_EnemyEntities.reserve(m_ReservedEntities);
+	m_Enemies.reserve(m_ReservedEntities);
+	m_PurgeZones.reserve(m_ReservedEntities);
+
+	m_HouseCenters.Reserve(m_ReservedHouses);
+	m_ItemPositions.Reserve(m_ReservedEntities);
+	m_EnemyPositions.Reserve(m_ReservedEntities);
+	m_PurgeZoneCenters.Reserve(m_ReservedEntities);
+	m_PurgeZoneRadii.reserve(m_ReservedEntities);
+}
+
+void Perception::Refresh(IExamInterface* pInterface)
+{
+	PROFILE_ZONE("Perception::Refresh");
+
+	m_AgentInfo = pInterface->Agent_GetInfo();
+	m_IsAgentInfoStale = false;
+	m_WorldInfo = pInterface->World_GetInfo();
+	m_Stats = pInterface->World_GetStats();
+
+	// Store every house in the FOV
+	m_Houses.clear();
+	m_HouseCenters.Clear();
+	HouseInfo house = {};
+	for (int i = 0;; ++i)
+	{
+		if (pInterface->Fov_GetHouseByIndex(i, house))
+		{
+			m_Houses.push_back(house);
+			m_HouseCenters.PushBack(house.Center);
+			continue;
+		}
+		break;
+	}
+
+	// Store every entity in the FOV, already split by type (and resolve the enemies and purge zones right away)
+	m_Items.clear();
+	m_EnemyEntities.clear();
+	m_Enemies.clear();
+	m_PurgeZones.clear();
+	m_ItemPositions.Clear();
+	m_EnemyPositions.Clear();
+	m_PurgeZoneCenters.Clear();
+	m_PurgeZoneRadii.clear();
+	EntityInfo entity = {};
+	for (int i = 0;; ++i)
+	{
+		if (pInterface->Fov_GetEntityByIndex(i, entity))
+		{
+			switch (entity.Type)
+			{
+			case eEntityType::ITEM:
+				m_Items.push_back(entity);
+				m_ItemPositions.PushBack(entity.Location);
+				break;
+
+			case eEntityType::ENEMY:
+			{
+				m_EnemyEntities.push_back(entity);
+				EnemyInfo enemy = {};
+				if (pInterface->Enemy_GetInfo(entity, enemy))
+				{
+					m_Enemies.push_back(enemy);
+					m_EnemyPositions.PushBack(enemy.Location);
+				}
+				break;
+			}
+
+			case eEntityType::PURGEZONE:
+			{
+				PurgeZoneInfo zone = {};
+				if (pInterface->PurgeZone_GetInfo(entity, zone))
+				{
+					m_PurgeZones.push_back(zone);
+					m_PurgeZoneCenters.PushBack(zone.Center);
+					m_PurgeZoneRadii.push_back(zone.Radius);
+				}
+				break;
+			}
+
+			default:
+				break;
+			}
+
+			continue;
+		}
+		break;
+	}
+}
+
+void Perception::RefreshAgentInfo(IExamInterface* pInterface)
+{
+	if (m_IsAgentInfoStale == false)
+		return;
+
+	m_AgentInfo = pInterface->Agent_GetInfo();
+	m_IsAgentInfoStale = false;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+
+class IExamInterface;
+struct ItemConsumedEvent;
+
+// Snapshot of everything the agent can perceive during a single frame
+// It's gathered once at the start of UpdateSteering() and handed to ItemUsage and to every state/transition,
+// so the interface is only crossed once per FOV entity per frame (instead of once per entity per state/transition)
+class Perception final
+{
+public:
+	Perception();
+	~Perception() = default;
+
+	void Refresh(IExamInterface* pInterface);
+	void RefreshAgentInfo(IExamInterface* pInterface); // For when an action (like using a medkit) changes the agent mid-frame, only asks if one did
+	void OnEvent(const ItemConsumedEvent& event) { m_IsAgentInfoStale = true; }
+
+	const AgentInfo& GetAgentInfo() const { return m_AgentInfo; }
+	const WorldInfo& GetWorldInfo() const { return m_WorldInfo; }
+	const StatisticsInfo& GetStats() const { return m_Stats; }
+
+	const vector<HouseInfo>& GetHouses() const { return m_Houses; }
+	const vector<EntityInfo>& GetItems() const { return m_Items; }
+	const vector<EntityInfo>& GetEnemyEntities() const { return m_EnemyEntities; }
+	const vector<EnemyInfo>& GetEnemies() const { return m_Enemies; } // Only the enemies whose info could be resolved
+	const vector<PurgeZoneInfo>& GetPurgeZones() const { return m_PurgeZones; }
+
+	// The same positions again, as SoA arrays for the batch distance queries (see EVector2SoA.h), indexed like the vectors above
+	const Elite::Vector2SoA& GetHouseCenters() const { return m_HouseCenters; }
+	const Elite::Vector2SoA& GetItemPositions() const { return m_ItemPositions; }
+	const Elite::Vector2SoA& GetEnemyPositions() const { return m_EnemyPositions; } // Of GetEnemies()
+	const Elite::Vector2SoA& GetPurgeZoneCenters() const { return m_PurgeZoneCenters; }
+	const vector<float>& GetPurgeZoneRadii() const { return m_PurgeZoneRadii; }
+
+	bool HasEnemiesInFOV() const { return m_EnemyEntities.empty() == false; }
+	bool HasItemsInFOV() const { return m_Items.empty() == false; }
+	bool HasPurgeZonesInFOV() const { return m_PurgeZones.empty() == false; }
+
+private:
+	AgentInfo m_AgentInfo;
+	WorldInfo m_WorldInfo;
+	StatisticsInfo m_Stats;
+	bool m_IsAgentInfoStale; // An item got used since the agent info was asked for
+
+	// The vectors are only cleared between frames (never shrunk), so after the first few frames no more allocations happen
+	vector<HouseInfo> m_Houses;
+	vector<EntityInfo> m_Items;
+	vector<EntityInfo> m_EnemyEntities;
+	vector<EnemyInfo> m_Enemies;
+	vector<PurgeZoneInfo> m_PurgeZones;
+
+	Elite::Vector2SoA m_HouseCenters;
+	Elite::Vector2SoA m_ItemPositions;
+	Elite::Vector2SoA m_EnemyPositions;
+	Elite::Vector2SoA m_PurgeZoneCenters;
+	vector<float> m_PurgeZoneRadii;
+
+	const size_t m_ReservedEntities{ 32 };
+	const size_t m_ReservedHouses{ 8 };
+};
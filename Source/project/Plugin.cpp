@@ -1,15 +1,39 @@
 #include "stdafx.h"
 #include "Plugin.h"
 #include "IExamInterface.h"
-#include "StatesTransitions.h"
 #include "ItemUsage.h"
+#include "Inventory.h"
+#include "InterfaceCallCounter.h"
+#include "InterfaceRecorder.h"
+#include "MovementGraph.h"
+#include "Profiler.h"
 
 //Called only once, during initialization
 void Plugin::Initialize(IBaseInterface* pInterface, PluginInfo& info)
 {
 	//Retrieving the interface
 	//This interface gives you access to certain actions the AI_Framework can perform for you
-	m_pInterface = static_cast<IExamInterface*>(pInterface);
+	//(wrapped, so every call can be recorded and the amount of calls done each tick can be measured)
+	auto* pFrameworkInterface = static_cast<IExamInterface*>(pInterface);
+	// Names this run's output files, timestamped since the game's seed rarely changes (and a replay of this run would otherwise record over it)
+	const auto now = time(nullptr);
+	tm localTime{};
+#ifdef _WIN32
+	localtime_s(&localTime, &now);
+#else
+	localtime_r(&now, &localTime);
+#endif
+	char timestamp[32]{};
+	strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", &localTime);
+	m_RunName = to_string(m_RandomSeed) + "_" + timestamp;
+#if RECORDING_ENABLED
+	m_RecordingFile = "Recording_" + m_RunName + ".rec";
+	m_pRecorder = new InterfaceRecorder(pFrameworkInterface);
+	m_pRecorder->Start(m_RecordingFile, int(m_RandomSeed));
+	pFrameworkInterface = m_pRecorder;
+#endif
+	m_pCallCounter = new InterfaceCallCounter(pFrameworkInterface);
+	m_pInterface = m_pCallCounter;
 
 	//Bit information about the plugin
 	//Please fill this in!!
@@ -19,8 +43,28 @@ void Plugin::Initialize(IBaseInterface* pInterface, PluginInfo& info)
 	info.Student_Class = "2DAE02";
 
 
-	m_ItemUsage = new ItemUsage(m_pInterface);
+	m_EventLogFile = "EventLog_" + to_string(m_RandomSeed) + ".txt";
+	m_EventLog.StartBackgroundDump(m_EventLogFile);
+	m_EnemyTracks.SetEventLog(&m_EventLog);
+	m_HouseMemory.SetEventLog(&m_EventLog);
+	m_EnemyTracks.SetEventQueue(&m_Events);
+	m_HouseMemory.SetEventQueue(&m_Events);
+	m_DangerField.SetNavGrid(&m_NavGrid);
+	m_Level.Load(m_LevelFile, LevelData::eSidecarMode::ReadOnly); // If it can't be found, the states just follow the navmesh instead
+	m_pInventory = new Inventory(m_pInterface);
+	m_pInventory->SetEventQueue(&m_Events);
+	m_ItemUsage = new ItemUsage(m_pInventory, &m_EnemyTracks);
+	m_pEventDispatcher = new GameEventDispatcher{ &m_Events, &m_Perception, &m_HouseMemory, m_ItemUsage };
 	SetUpMovementFSM();
+
+#if TELEMETRY_ENABLED
+	// The State column holds indices into these
+	vector<string> stateNames{};
+	for (const auto* pState : m_pMovementStates)
+		stateNames.push_back(Profiler::GetTypeName(typeid(*pState)));
+	m_TraceFile = "Telemetry_" + m_RunName + ".trace";
+	m_Trace.Open(m_TraceFile, int(m_RandomSeed), stateNames);
+#endif
 }
 
 //Called only once
@@ -34,15 +78,21 @@ void Plugin::DllInit()
 void Plugin::DllShutdown()
 {
 	//Called when the plugin gets unloaded
-	
-	for (auto& t : m_pMovementStates)
-		SAFE_DELETE(t);
-	
-	for (auto& t : m_pMovementTransitions)
-		SAFE_DELETE(t);
-
-	SAFE_DELETE(m_MovementFSM);
+	m_EventLog.StopBackgroundDump(); // Flushes what's left of the log
+	m_Trace.Close(); // Writes out the last chunk
+#if PROFILER_ENABLED
+	Profiler::ExportStats(m_ProfileStatsFile);
+	Profiler::ExportChromeTrace(m_ProfileTraceFile);
+#endif
+
+	SAFE_DELETE(m_MovementFSM); // Along with the whole graph
+	m_pMovementStates.clear();
+	SAFE_DELETE(m_pEventDispatcher);
 	SAFE_DELETE(m_ItemUsage);
+	SAFE_DELETE(m_pInventory);
+	SAFE_DELETE(m_pCallCounter);
+	SAFE_DELETE(m_pRecorder); // Writes out the rest of the recording
+	m_pInterface = nullptr;
 }
 
 //Called only once, during initialization
@@ -54,32 +104,53 @@ void Plugin::InitGameDebugParams(GameDebugParams& params)
 	params.EnemyCount = 20; //How many enemies? (Default = 20)
 	params.GodMode = false; //GodMode > You can't die, can be usefull to inspect certain behaviours (Default = false)
 	params.AutoGrabClosestItem = true; //A call to Item_Grab(...) returns the closest item that can be grabbed. (EntityInfo argument is ignored)
+	m_RandomSeed = uint32_t(params.Seed); // Already filled in by the game (this gets called before Initialize())
+	m_LevelFile = params.LevelFile; // Same, read from disk for the nav grid
 }
 
 //Only Active in DEBUG Mode
 //(=Use only for Debug Purposes)
 void Plugin::Update(float dt)
 {
-	const auto& agentInfo = m_pInterface->Agent_GetInfo();
-	const auto& entitiesNearby = GetEntitiesInFOV();
 }
 
 //Update
 //This function calculates the new SteeringOutput, called once per frame
 SteeringPlugin_Output Plugin::UpdateSteering(float dt)
 {
+	PROFILE_ZONE("Plugin::UpdateSteering");
+
+	m_pCallCounter->BeginTick();
+	if (m_pRecorder)
+		m_pRecorder->BeginFrame(dt);
+	m_Perception.Refresh(m_pInterface); // Gather everything in the FOV once, to be shared by the item usage and every state/transition
+	m_EnemyTracks.Update(m_Perception);
+	m_HouseMemory.Update(m_Perception);
+	m_InfluenceMap.Update(dt, m_Perception, m_HouseMemory);
+	if (m_Level.IsLoaded() && m_NavGrid.IsBuilt() == false)
+		m_NavGrid.Build(m_Level, m_Perception.GetAgentInfo().AgentSize);
+	m_DangerField.Update(m_EnemyTracks, m_Perception.GetWorldInfo()); // Its walls come from the nav grid, so only after that got built
+
 	auto finalSteering = SteeringPlugin_Output{};
 	finalSteering.AutoOrient = false;
 	bool currentlyAiming;
-	m_ItemUsage->Update(dt, finalSteering, currentlyAiming); // Use any items required for the situation (and change steering to shoot, if needed)
+	m_ItemUsage->Update(dt, m_Perception, finalSteering, currentlyAiming); // Use any items required for the situation (and change steering to shoot, if needed)
+
+	// Everything that happened since the last dispatch: this frame's tracks, houses and used items, the last frame's state changes and pickups
+	m_pEventDispatcher->Dispatch();
+	m_Perception.RefreshAgentInfo(m_pInterface); // The agent's health/energy might've just changed by using an item
 	if (currentlyAiming == false)
 	{
 		finalSteering.AutoOrient = true;
-		finalSteering = m_MovementFSM->Update(dt); // Calculate the steering through the FSM
+		finalSteering = m_MovementFSM->Update(dt, m_Perception); // Calculate the steering through the FSM
 	}
 	
-	m_SteeringDirection = finalSteering.LinearVelocity; // For debug drawing purposes
-	
+	GatherDebugDraw(finalSteering);
+
+	if (m_pRecorder)
+		m_pRecorder->EndFrame(finalSteering);
+	if (m_Trace.IsOpen())
+		RecordTelemetry(dt, finalSteering);
 
 	return finalSteering;
 }
@@ -88,133 +159,66 @@ SteeringPlugin_Output Plugin::UpdateSteering(float dt)
 void Plugin::Render(float dt) const
 {
 	//This Render function should only contain calls to Interface->Draw_... functions
-	m_pInterface->Draw_Direction(m_pInterface->Agent_GetInfo().Position, m_SteeringDirection, 5.f, { 0, 1, 0 });
-	m_pInterface->Draw_Circle(m_pInterface->Agent_GetInfo().Position, 12.f, { 0, 1, 1 });
+	m_DebugDraw.Draw(m_pInterface); // Whatever the last UpdateSteering() gathered
 }
 
-vector<HouseInfo> Plugin::GetHousesInFOV() const
+void Plugin::SetUpMovementFSM()
 {
-	vector<HouseInfo> vHousesInFOV = {};
-
-	HouseInfo hi = {};
-	for (int i = 0;; ++i)
-	{
-		if (m_pInterface->Fov_GetHouseByIndex(i, hi))
-		{
-			vHousesInFOV.push_back(hi);
-			continue;
-		}
-
-		break;
-	}
-
-	return vHousesInFOV;
+	// The whole graph goes into a single arena, which the FSM takes over (and releases in one go when it's deleted)
+	FSMArena arena{};
+	auto graph = CreateMovementGraph(arena, m_pInventory, &m_EnemyTracks, &m_DangerField, &m_InfluenceMap, &m_HouseMemory, &m_NavGrid, m_RandomSeed);
+	m_pMovementStates = graph.States;
+
+	// Initialize the FSM (the graph's fixed, so it gets the one wired at compile time)
+	m_MovementFSM = new StaticMovementFSM{ graph.TypedStates, graph.TypedTransitions, m_pInterface, move(arena) };
+	m_MovementFSM->SetEventLog(&m_EventLog);
+	m_MovementFSM->SetEventQueue(&m_Events);
 }
 
-vector<EntityInfo> Plugin::GetEntitiesInFOV() const
+void Plugin::GatherDebugDraw(const SteeringPlugin_Output& steering)
 {
-	vector<EntityInfo> vEntitiesInFOV = {};
-
-	EntityInfo ei = {};
-	for (int i = 0;; ++i)
-	{
-		if (m_pInterface->Fov_GetEntityByIndex(i, ei))
-		{
-			vEntitiesInFOV.push_back(ei);
-			continue;
-		}
-
-		break;
-	}
-
-	return vEntitiesInFOV;
+	const auto& agentPos = m_Perception.GetAgentInfo().Position;
+	m_DebugDraw.AddDirection(eDebugDrawCategory::Steering, agentPos, steering.LinearVelocity, 5.f, { 0, 1, 0 });
+	m_DebugDraw.AddCircle(eDebugDrawCategory::Steering, agentPos, 12.f, { 0, 1, 1 });
+	m_EnemyTracks.DebugDraw(m_DebugDraw);
+	m_InfluenceMap.DebugDraw(m_DebugDraw);
+	if (const auto* pCurrentState = m_MovementFSM->GetCurrentState())
+		pCurrentState->DebugDraw(m_DebugDraw, m_Perception);
+	m_DebugDraw.Publish();
 }
 
-void Plugin::SetUpMovementFSM()
+void Plugin::RecordTelemetry(float dt, const SteeringPlugin_Output& steering)
 {
-	// Create all the needed states
-	auto* pWanderLookingBackState = new WanderLookingBackState();
-	m_pMovementStates.push_back(pWanderLookingBackState);
-	auto* pFleeEnemiesState = new FleeEnemiesState();
-	m_pMovementStates.push_back(pFleeEnemiesState);
-	auto* pSeekHouseState = new SeekHouseState();
-	m_pMovementStates.push_back(pSeekHouseState);
-	auto* pLookAroundHouseState = new LookAroundHouseState();
-	m_pMovementStates.push_back(pLookAroundHouseState);
-	auto* pSeekItemsState = new SeekItemsState();
-	pSeekItemsState->GetSubject()->AddObserver(m_ItemUsage);
-	m_pMovementStates.push_back(pSeekItemsState);
-	auto* pExitHouseState = new ExitHouseState();
-	m_pMovementStates.push_back(pExitHouseState);
-	auto* pComeBackToTownState = new ComeBackToTownState();
-	m_pMovementStates.push_back(pComeBackToTownState);
-	auto* pFleePurgeZonesState = new FleePurgeZonesState();
-	m_pMovementStates.push_back(pFleePurgeZonesState);
-	
-
-	// Initialize the FSM
-	m_MovementFSM = new FiniteStateMachine{ pWanderLookingBackState, m_pInterface };
-
-	// Create transition to flee from enemies
-	auto* pEnemySpotted = new EnemySpotted();
-	m_pMovementTransitions.push_back(pEnemySpotted);
-	m_MovementFSM->AddTransition(pWanderLookingBackState, pFleeEnemiesState, pEnemySpotted);
-
-	// Create transitions to seek un-scavenged houses
-	auto* pNewHouseSpotted = new NewHouseSpotted();
-	m_pMovementTransitions.push_back(pNewHouseSpotted);
-	m_MovementFSM->AddTransition(pFleeEnemiesState, pSeekHouseState, pNewHouseSpotted);
-	m_MovementFSM->AddTransition(pWanderLookingBackState, pSeekHouseState, pNewHouseSpotted);
-
-	// Create transitions to evacuate from a house
-	auto* pAllItemsCloseByTaken = new AllItemsCloseByTaken();
-	m_pMovementTransitions.push_back(pAllItemsCloseByTaken);
-	m_MovementFSM->AddTransition(pLookAroundHouseState, pExitHouseState, pAllItemsCloseByTaken); // After looting said house (the most common one)
-	auto* pInsideAlreadyLootedHouse = new InsideHouse();
-	m_pMovementTransitions.push_back(pInsideAlreadyLootedHouse);
-	m_MovementFSM->AddTransition(pWanderLookingBackState, pExitHouseState, pInsideAlreadyLootedHouse); // If the agent randomly wanders into an already looted house (which should be rare)
-
-	// Create transitions to look around the house
-	auto* pHouseCenterReached = new HouseCenterReached();
-	m_pMovementTransitions.push_back(pHouseCenterReached);
-	m_MovementFSM->AddTransition(pSeekHouseState, pLookAroundHouseState, pHouseCenterReached); // After arriving at the house center
-	m_MovementFSM->AddTransition(pSeekItemsState, pLookAroundHouseState, pAllItemsCloseByTaken); // If all nearby items have been taken
-
-	// Create transitions to seek items inside the house
-	auto* pItemSpotted = new ItemSpotted();
-	m_pMovementTransitions.push_back(pItemSpotted);
-	m_MovementFSM->AddTransition(pLookAroundHouseState, pSeekItemsState, pItemSpotted);
-	m_MovementFSM->AddTransition(pSeekHouseState, pSeekItemsState, pItemSpotted);
-	m_MovementFSM->AddTransition(pExitHouseState, pSeekItemsState, pItemSpotted);
-
-	// Create transitions to come back into the city (in case the agent ends up too far away from all the houses)
-	auto* pTooFarAwayFromTown = new TooFarAwayFromTown();
-	m_pMovementTransitions.push_back(pTooFarAwayFromTown);
-	m_MovementFSM->AddTransition(pWanderLookingBackState, pComeBackToTownState, pTooFarAwayFromTown);
-	m_MovementFSM->AddTransition(pFleeEnemiesState, pComeBackToTownState, pTooFarAwayFromTown);
-
-	// Create transitions to flee from purge zones
-	auto* pInsidePurgeZone = new InsidePurgeZone();
-	m_pMovementTransitions.push_back(pInsidePurgeZone);
-	m_MovementFSM->AddTransition(pWanderLookingBackState, pFleePurgeZonesState, pInsidePurgeZone);
-	m_MovementFSM->AddTransition(pFleeEnemiesState, pFleePurgeZonesState, pInsidePurgeZone);
-	m_MovementFSM->AddTransition(pSeekHouseState, pFleePurgeZonesState, pInsidePurgeZone);
-	m_MovementFSM->AddTransition(pLookAroundHouseState, pFleePurgeZonesState, pInsidePurgeZone);
-	m_MovementFSM->AddTransition(pSeekItemsState, pFleePurgeZonesState, pInsidePurgeZone);
-	m_MovementFSM->AddTransition(pExitHouseState, pFleePurgeZonesState, pInsidePurgeZone);
-	m_MovementFSM->AddTransition(pComeBackToTownState, pFleePurgeZonesState, pInsidePurgeZone);	
-
-	// Create transition to wander
-	auto* pEscapedFromEnemies = new EscapedFromEnemies();
-	m_pMovementTransitions.push_back(pEscapedFromEnemies);
-	m_MovementFSM->AddTransition(pFleeEnemiesState, pWanderLookingBackState, pEscapedFromEnemies); // Wander after fleeing from enemies (if they're far away enough)
-	auto* pExitedHouse = new ExitedHouse();
-	m_pMovementTransitions.push_back(pExitedHouse);
-	m_MovementFSM->AddTransition(pExitHouseState, pWanderLookingBackState, pExitedHouse); // Wander after exiting a house
-	auto* pReturnedToTown = new ReturnedToTown();
-	m_pMovementTransitions.push_back(pReturnedToTown);
-	m_MovementFSM->AddTransition(pComeBackToTownState, pWanderLookingBackState, pReturnedToTown); // Wander after returning to the relevant part of the map
-	auto* pPurgeZoneFled = new PurgeZoneFled();
-	m_pMovementTransitions.push_back(pPurgeZoneFled);
-	m_MovementFSM->AddTransition(pFleePurgeZonesState, pWanderLookingBackState, pPurgeZoneFled); // Wander after fleeing from a purge zone
+	const auto& agent = m_Perception.GetAgentInfo();
+	const auto& stats = m_Perception.GetStats();
+	const auto stateIt = find(m_pMovementStates.begin(), m_pMovementStates.end(), m_MovementFSM->GetCurrentState());
+	const int state = stateIt != m_pMovementStates.end() ? int(stateIt - m_pMovementStates.begin()) : -1;
+
+	m_Trace.Set(eTraceColumn::DeltaTime, dt);
+	m_Trace.Set(eTraceColumn::PositionX, agent.Position.x);
+	m_Trace.Set(eTraceColumn::PositionY, agent.Position.y);
+	m_Trace.Set(eTraceColumn::Orientation, agent.Orientation);
+	m_Trace.Set(eTraceColumn::Health, agent.Health);
+	m_Trace.Set(eTraceColumn::Energy, agent.Energy);
+	m_Trace.Set(eTraceColumn::Stamina, agent.Stamina);
+	m_Trace.Set(eTraceColumn::State, state);
+	m_Trace.Set(eTraceColumn::LinearVelocityX, steering.LinearVelocity.x);
+	m_Trace.Set(eTraceColumn::LinearVelocityY, steering.LinearVelocity.y);
+	m_Trace.Set(eTraceColumn::AngularVelocity, steering.AngularVelocity);
+	m_Trace.Set(eTraceColumn::AutoOrient, int(steering.AutoOrient));
+	m_Trace.Set(eTraceColumn::RunMode, int(steering.RunMode));
+	m_Trace.Set(eTraceColumn::HousesInFOV, int(m_Perception.GetHouses().size()));
+	m_Trace.Set(eTraceColumn::EnemiesInFOV, int(m_Perception.GetEnemyEntities().size()));
+	m_Trace.Set(eTraceColumn::ItemsInFOV, int(m_Perception.GetItems().size()));
+	m_Trace.Set(eTraceColumn::PurgeZonesInFOV, int(m_Perception.GetPurgeZones().size()));
+	m_Trace.Set(eTraceColumn::Score, stats.Score);
+	m_Trace.Set(eTraceColumn::Difficulty, stats.Difficulty);
+	m_Trace.Set(eTraceColumn::TimeSurvived, stats.TimeSurvived);
+	m_Trace.Set(eTraceColumn::KillCountdown, stats.KillCountdown);
+	m_Trace.Set(eTraceColumn::EnemiesKilled, stats.NumEnemiesKilled);
+	m_Trace.Set(eTraceColumn::EnemiesHit, stats.NumEnemiesHit);
+	m_Trace.Set(eTraceColumn::ItemsPickedUp, stats.NumItemsPickUp);
+	m_Trace.Set(eTraceColumn::MissedShots, stats.NumMissedShots);
+	m_Trace.Set(eTraceColumn::CheckpointsReached, stats.NumChkpntsReached);
+	m_Trace.EndFrame();
 }
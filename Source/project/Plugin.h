@@ -1,23 +1,31 @@
 #pragma once
 #include "IExamPlugin.h"
 #include "Exam_HelperStructs.h"
-#include "FiniteStateMachine.h"
-#include "SteeringBehaviour.h"
+#include "MovementGraph.h"
+#include "SteeringBlender.h"
+#include "Perception.h"
+#include "EventLog.h"
+#include "GameEvents.h"
+#include "EnemyTracks.h"
+#include "DangerField.h"
+#include "HouseMemory.h"
+#include "InfluenceMap.h"
+#include "DebugDrawList.h"
+#include "TelemetryTrace.h"
+#include "LevelData.h"
+#include "NavGrid.h"
 
 class ItemUsage;
+class Inventory;
+class InterfaceCallCounter;
+class InterfaceRecorder;
 class FSMTransition;
 class FSMState;
 class IBaseInterface;
 class IExamInterface;
 
-struct WeightedBehavior
-{
-	SteeringBehaviour* behavior;
-	float weight;
-};
-
-using BotFinalBehavior = vector<WeightedBehavior>;
-
+// Who gets which of the plugin's events (every subscriber whatever it has an OnEvent() for), dispatched once per frame in UpdateSteering()
+using GameEventDispatcher = EventDispatcher<GameEventQueue, Perception, HouseMemory, ItemUsage>;
 
 class Plugin :public IExamPlugin
 {
@@ -38,8 +46,28 @@ public:
 private:
 	//Interface, used to request data from/perform actions with the AI Framework
 	IExamInterface* m_pInterface = nullptr;
-	vector<HouseInfo> GetHousesInFOV() const;
-	vector<EntityInfo> GetEntitiesInFOV() const;
+	InterfaceCallCounter* m_pCallCounter = nullptr; // Wraps the framework's interface (m_pInterface points to it)
+	InterfaceRecorder* m_pRecorder = nullptr; // Between the call counter and the framework, only when RECORDING_ENABLED
+	string m_RunName{}; // "<seed>_<date>_<time>", names the recording and the telemetry trace (see Initialize())
+	string m_RecordingFile{}; // "Recording_<run name>.rec"
+	TraceWriter m_Trace; // Per-frame telemetry (only when TELEMETRY_ENABLED)
+	string m_TraceFile{}; // "Telemetry_<run name>.trace"
+	Perception m_Perception; // Everything in the FOV, gathered once per frame
+	EnemyTracks m_EnemyTracks; // Every enemy seen recently, updated right after the perception
+	DangerField m_DangerField; // Where those enemies make it dangerous and which way is away from them, updated right after them
+	HouseMemory m_HouseMemory; // Every house seen during the run, and which ones got ransacked (same)
+	InfluenceMap m_InfluenceMap; // Threat, loot and purge zones seen around the world lately, updated right after the house memory
+	string m_LevelFile{}; // The level the game loads (see InitGameDebugParams())
+	LevelData m_Level; // Its walls, loaded in Initialize()
+	NavGrid m_NavGrid; // Built from them on the first frame (once the agent's size is known), the states plan their routes on it
+	mutable DebugDrawList m_DebugDraw; // Filled in by UpdateSteering(), drawn by Render() (which is const, but takes the latest frame out of it)
+	EventLog m_EventLog; // State changes and such (only when compiled in, see EVENT_LOG_LEVEL)
+	GameEventQueue m_Events; // What happened since the last dispatch (pickups, new enemies, state changes, ...)
+	GameEventDispatcher* m_pEventDispatcher = nullptr; // Hands them out, made once the item usage's there
+	string m_EventLogFile{}; // "EventLog_<seed>.txt" (see Initialize()), so bots running side by side don't share it
+	uint32_t m_RandomSeed{}; // The game's seed (see InitGameDebugParams()), there's no rand() in the bot
+	const string m_ProfileStatsFile{ "Profile.json" }; // Only written when PROFILER_ENABLED
+	const string m_ProfileTraceFile{ "ProfileTrace.json" }; // Same
 
 	Elite::Vector2 m_Target = {};
 	bool m_CanRun = false; //Demo purpose
@@ -50,11 +78,12 @@ private:
 
 	// IDT
 	void SetUpMovementFSM();
-	FiniteStateMachine* m_MovementFSM;
-	std::vector<FSMState*> m_pMovementStates{};
-	std::vector<FSMTransition*> m_pMovementTransitions{};
+	void RecordTelemetry(float dt, const SteeringPlugin_Output& steering);
+	void GatherDebugDraw(const SteeringPlugin_Output& steering);
+	StaticMovementFSM* m_MovementFSM;
+	std::vector<FSMState*> m_pMovementStates{}; // Owned by the FSM (in its arena), only kept to name and index them in the trace
+	Inventory* m_pInventory = nullptr; // Mirror of the agent's inventory, every item goes in and out through it
 	ItemUsage* m_ItemUsage;
-	Elite::Vector2 m_SteeringDirection{};
 };
 
 //ENTRY
@@ -62,7 +91,7 @@ private:
 //The plugin returned by this function is also the plugin used by the host program
 extern "C"
 {
-	__declspec (dllexport) IPluginBase* Register()
+	PLUGIN_API IPluginBase* Register()
 	{
 		return new Plugin();
 	}
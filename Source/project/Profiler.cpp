@@ -0,0 +1,318 @@
+#include "stdafx.h"
+#include "Profiler.h"
+#include <array>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_USE_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PROFILER_USE_RDTSC 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#endif
+
+namespace
+{
+	// Log-scale histogram: 8 buckets per power of two, so every bucket is at most 12.5% wide
+	const int g_SubBucketBits{ 3 };
+	const int g_SubBuckets{ 1 << g_SubBucketBits };
+	const int g_NrOfBuckets{ (64 - g_SubBucketBits + 1) * g_SubBuckets };
+
+	const size_t g_MaxTraceEventsPerThread{ 1 << 20 };
+
+	int GetBucket(uint64_t ticks)
+	{
+		if (ticks < uint64_t(g_SubBuckets))
+			return int(ticks);
+
+		int exponent = 63;
+		while ((ticks >> exponent) == 0)
+			--exponent;
+
+		const auto subBucket = int((ticks >> (exponent - g_SubBucketBits)) & (g_SubBuckets - 1));
+		return (exponent - g_SubBucketBits + 1) * g_SubBuckets + subBucket;
+	}
+
+	uint64_t GetBucketUpperBound(int bucket) // Exclusive
+	{
+		if (bucket < g_SubBuckets)
+			return uint64_t(bucket) + 1;
+
+		const int exponent = bucket / g_SubBuckets + g_SubBucketBits - 1;
+		const auto subBucket = uint64_t(bucket % g_SubBuckets);
+		return (uint64_t(g_SubBuckets) + subBucket + 1) << (exponent - g_SubBucketBits);
+	}
+
+	struct ZoneStats
+	{
+		uint64_t Count = 0;
+		uint64_t TotalTicks = 0;
+		uint64_t MinTicks = UINT64_MAX;
+		uint64_t MaxTicks = 0;
+		array<uint64_t, g_NrOfBuckets> Histogram{};
+	};
+
+	struct TraceEvent
+	{
+		uint64_t StartTicks;
+		uint64_t EndTicks;
+		ProfileZoneId ZoneId;
+	};
+
+	struct ThreadBuffer
+	{
+		uint32_t ThreadIdx = 0;
+		vector<ZoneStats> Stats; // By zone id
+		vector<TraceEvent> TraceEvents;
+		uint64_t DroppedTraceEvents = 0;
+	};
+
+	// Shared bookkeeping, only locked when registering zones or threads (and when exporting)
+	struct Registry
+	{
+		mutex Mutex;
+		deque<string> ZoneNames; // By zone id (a deque, so the names never move)
+		unordered_map<string, ProfileZoneId> ZoneIds;
+		vector<unique_ptr<ThreadBuffer>> ThreadBuffers; // Kept after their thread ends, so they can still be exported
+
+		// Ticks to real time, calibrated between creation and export
+		chrono::steady_clock::time_point StartTime = chrono::steady_clock::now();
+		uint64_t StartTicks = Profiler::Now();
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry{};
+		return registry;
+	}
+
+	thread_local ThreadBuffer* t_pThreadBuffer = nullptr;
+
+	ThreadBuffer& GetThreadBuffer()
+	{
+		if (t_pThreadBuffer == nullptr)
+		{
+			auto& registry = GetRegistry();
+			lock_guard<mutex> lock(registry.Mutex);
+			registry.ThreadBuffers.push_back(make_unique<ThreadBuffer>());
+			t_pThreadBuffer = registry.ThreadBuffers.back().get();
+			t_pThreadBuffer->ThreadIdx = uint32_t(registry.ThreadBuffers.size());
+		}
+
+		return *t_pThreadBuffer;
+	}
+
+	double GetMicrosecondsPerTick(const Registry& registry)
+	{
+		const auto elapsedTicks = Profiler::Now() - registry.StartTicks;
+		const auto elapsedTime = chrono::duration<double, micro>(chrono::steady_clock::now() - registry.StartTime).count();
+		return elapsedTicks > 0 ? elapsedTime / double(elapsedTicks) : 0.0;
+	}
+
+	string EscapeJson(const string& text)
+	{
+		string escaped{};
+		for (const auto character : text)
+		{
+			if (character == '"' || character == '\\')
+				escaped += '\\';
+			escaped += character;
+		}
+		return escaped;
+	}
+}
+
+ProfileZoneId Profiler::RegisterZone(const string& name)
+{
+	auto& registry = GetRegistry();
+	lock_guard<mutex> lock(registry.Mutex);
+
+	const auto it = registry.ZoneIds.find(name);
+	if (it != registry.ZoneIds.end())
+		return it->second;
+
+	const auto zoneId = ProfileZoneId(registry.ZoneNames.size());
+	registry.ZoneNames.push_back(name);
+	registry.ZoneIds[name] = zoneId;
+	return zoneId;
+}
+
+string Profiler::GetTypeName(const type_info& type)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	int status = 0;
+	char* pDemangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+	if (pDemangled == nullptr)
+		return type.name();
+
+	string name{ pDemangled };
+	free(pDemangled);
+	return name;
+#else
+	// MSVC's names are already readable, apart from the "class " or "struct " in front
+	string name{ type.name() };
+	for (const auto& prefix : { string("class "), string("struct ") })
+	{
+		if (name.compare(0, prefix.size(), prefix) == 0)
+			return name.substr(prefix.size());
+	}
+	return name;
+#endif
+}
+
+uint64_t Profiler::Now()
+{
+#ifdef PROFILER_USE_RDTSC
+	return __rdtsc();
+#else
+	return uint64_t(chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+void Profiler::RecordZone(ProfileZoneId zoneId, uint64_t startTicks)
+{
+	const auto endTicks = Now();
+	const auto ticks = endTicks - startTicks;
+	auto& buffer = GetThreadBuffer();
+
+	if (zoneId >= buffer.Stats.size())
+		buffer.Stats.resize(zoneId + 1);
+
+	auto& stats = buffer.Stats[zoneId];
+	++stats.Count;
+	stats.TotalTicks += ticks;
+	stats.MinTicks = min(stats.MinTicks, ticks);
+	stats.MaxTicks = max(stats.MaxTicks, ticks);
+	++stats.Histogram[GetBucket(ticks)];
+
+	if (buffer.TraceEvents.size() < g_MaxTraceEventsPerThread)
+		buffer.TraceEvents.push_back(TraceEvent{ startTicks, endTicks, zoneId });
+	else
+		++buffer.DroppedTraceEvents;
+}
+
+bool Profiler::ExportStats(const string& filePath)
+{
+	auto& registry = GetRegistry();
+	lock_guard<mutex> lock(registry.Mutex);
+	const auto microsecondsPerTick = GetMicrosecondsPerTick(registry);
+
+	// Merge every thread's stats
+	vector<ZoneStats> mergedStats(registry.ZoneNames.size());
+	for (const auto& pBuffer : registry.ThreadBuffers)
+	{
+		for (size_t zoneId = 0; zoneId < pBuffer->Stats.size(); ++zoneId)
+		{
+			const auto& stats = pBuffer->Stats[zoneId];
+			auto& merged = mergedStats[zoneId];
+			merged.Count += stats.Count;
+			merged.TotalTicks += stats.TotalTicks;
+			merged.MinTicks = min(merged.MinTicks, stats.MinTicks);
+			merged.MaxTicks = max(merged.MaxTicks, stats.MaxTicks);
+			for (int bucket = 0; bucket < g_NrOfBuckets; ++bucket)
+				merged.Histogram[bucket] += stats.Histogram[bucket];
+		}
+	}
+
+	ofstream file(filePath);
+	if (!file)
+		return false;
+
+	file << "{\n\t\"zones\": [";
+	bool firstZone = true;
+	for (size_t zoneId = 0; zoneId < mergedStats.size(); ++zoneId)
+	{
+		const auto& stats = mergedStats[zoneId];
+		if (stats.Count == 0)
+			continue;
+
+		// p99: upper bound of the bucket the 99th percentile falls in (clamped to the slowest one measured)
+		const auto p99Rank = stats.Count - stats.Count / 100;
+		uint64_t p99Ticks = stats.MaxTicks;
+		uint64_t seen = 0;
+		for (int bucket = 0; bucket < g_NrOfBuckets; ++bucket)
+		{
+			seen += stats.Histogram[bucket];
+			if (seen >= p99Rank)
+			{
+				p99Ticks = min(GetBucketUpperBound(bucket), stats.MaxTicks);
+				break;
+			}
+		}
+
+		file << (firstZone ? "\n" : ",\n") << "\t\t{ \"name\": \"" << EscapeJson(registry.ZoneNames[zoneId]) << "\", \"count\": " << stats.Count
+			<< ", \"min_us\": " << double(stats.MinTicks) * microsecondsPerTick
+			<< ", \"mean_us\": " << double(stats.TotalTicks) / double(stats.Count) * microsecondsPerTick
+			<< ", \"p99_us\": " << double(p99Ticks) * microsecondsPerTick
+			<< ", \"max_us\": " << double(stats.MaxTicks) * microsecondsPerTick
+			<< ", \"total_us\": " << double(stats.TotalTicks) * microsecondsPerTick
+			<< ", \"histogram\": [";
+		firstZone = false;
+
+		// Only the buckets that were hit, as [upper bound in us, count] pairs
+		bool firstBucket = true;
+		for (int bucket = 0; bucket < g_NrOfBuckets; ++bucket)
+		{
+			if (stats.Histogram[bucket] == 0)
+				continue;
+
+			file << (firstBucket ? "" : ", ") << '[' << double(GetBucketUpperBound(bucket)) * microsecondsPerTick << ", " << stats.Histogram[bucket] << ']';
+			firstBucket = false;
+		}
+		file << "] }";
+	}
+	file << "\n\t]\n}\n";
+
+	return bool(file);
+}
+
+bool Profiler::ExportChromeTrace(const string& filePath)
+{
+	auto& registry = GetRegistry();
+	lock_guard<mutex> lock(registry.Mutex);
+	const auto microsecondsPerTick = GetMicrosecondsPerTick(registry);
+
+	ofstream file(filePath);
+	if (!file)
+		return false;
+
+	// Complete ("X") events, which the viewer nests by itself
+	file << "{\"traceEvents\":[";
+	bool firstEvent = true;
+	uint64_t droppedEvents = 0;
+	for (const auto& pBuffer : registry.ThreadBuffers)
+	{
+		droppedEvents += pBuffer->DroppedTraceEvents;
+		for (const auto& event : pBuffer->TraceEvents)
+		{
+			const auto startTime = double(event.StartTicks - registry.StartTicks) * microsecondsPerTick;
+			const auto duration = double(event.EndTicks - event.StartTicks) * microsecondsPerTick;
+			file << (firstEvent ? "\n" : ",\n") << "{\"name\":\"" << EscapeJson(registry.ZoneNames[event.ZoneId]) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << pBuffer->ThreadIdx
+				<< ",\"ts\":" << fixed << setprecision(3) << startTime << ",\"dur\":" << duration << '}';
+			firstEvent = false;
+		}
+	}
+	file << "\n],\"otherData\":{\"droppedEvents\":" << droppedEvents << "}}\n";
+
+	return bool(file);
+}
+
+void Profiler::Reset()
+{
+	auto& registry = GetRegistry();
+	lock_guard<mutex> lock(registry.Mutex);
+	for (auto& pBuffer : registry.ThreadBuffers)
+	{
+		pBuffer->Stats.clear();
+		pBuffer->TraceEvents.clear();
+		pBuffer->DroppedTraceEvents = 0;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <typeinfo>
+
+// Scoped-zone profiler (define PROFILER_ENABLED=1 project-wide to compile it in, it's compiled out by default)
+// Zones nest like the scopes they're in, and every thread records into its own buffer: per-zone stats
+// (count, min, max, mean and a log-scale histogram for the p99) and the zones themselves for a Chrome trace (ui.perfetto.dev)
+// Time is measured with RDTSC where available (steady_clock otherwise) and converted to real time when exporting
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+// Profiles the rest of the enclosing scope (the name is only registered once)
+#define PROFILE_ZONE(name) \
+	static const ProfileZoneId PROFILE_CONCAT(profileZoneId, __LINE__) = Profiler::RegisterZone(name); \
+	const ProfileScope PROFILE_CONCAT(profileScope, __LINE__){ PROFILE_CONCAT(profileZoneId, __LINE__) }
+// Same, for an id that was registered up front
+#define PROFILE_ZONE_ID(zoneId) const ProfileScope PROFILE_CONCAT(profileScope, __LINE__){ zoneId }
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_ZONE_ID(zoneId) ((void)0)
+#endif
+
+using ProfileZoneId = uint32_t;
+
+class Profiler final
+{
+public:
+	static ProfileZoneId RegisterZone(const string& name); // The same name always gets the same id
+	static string GetTypeName(const type_info& type); // Readable (demangled) class name, for naming zones after types
+
+	static uint64_t Now(); // In ticks
+	static void RecordZone(ProfileZoneId zoneId, uint64_t startTicks); // Ends the zone now
+
+	// Only call these once the profiled threads are done (the buffers aren't locked while recording)
+	static bool ExportStats(const string& filePath); // JSON, per zone: count, min, mean, p99, max and the histogram (in microseconds)
+	static bool ExportChromeTrace(const string& filePath);
+	static void Reset(); // Clears every thread's recordings (the zones stay registered)
+};
+
+class ProfileScope final
+{
+public:
+	explicit ProfileScope(ProfileZoneId zoneId) : m_ZoneId(zoneId), m_StartTicks(Profiler::Now()) {}
+	~ProfileScope() { Profiler::RecordZone(m_ZoneId, m_StartTicks); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	ProfileZoneId m_ZoneId;
+	uint64_t m_StartTicks;
+};
@@ -1,8 +1,15 @@
 #pragma once
 #include "FiniteStateMachine.h"
-#include "SteeringBehaviour.h"
+#include "SteeringBlender.h"
 #include <IExamInterface.h>
-#include "Observer.h"
+#include "Perception.h"
+#include "EnemyTracks.h"
+#include "DangerField.h"
+#include "InfluenceMap.h"
+#include "DebugDrawList.h"
+#include "HouseMemory.h"
+#include "PathFollower.h"
+#include "Inventory.h"
 
 
 // STATES
@@ -10,11 +17,12 @@
 class WanderLookingBackState : public FSMState
 {
 public:
-	WanderLookingBackState() : FSMState() {}
-	void OnEnter(IExamInterface* pInterface) override
+	WanderLookingBackState(const InfluenceMap* pInfluenceMap, uint32_t randomSeed)
+		: FSMState(), m_Movement(eSteeringBlend::Priority), m_pInfluenceMap(pInfluenceMap) { m_Movement.Get<m_WanderIdx>().SetRandomSeed(randomSeed); }
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
 		// Save initial stamina and health
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 		m_InitialStamina = agentInfo.Stamina;
 		m_AgentHP = agentInfo.Health;
 
@@ -25,12 +33,29 @@ public:
 		m_TurnBackTimer = 0.f;
 		m_AlreadyTurnedForwards = false;
 		m_TurnForwardTimer = 0.f;
+		m_ScoutTimer = m_ScoutInterval; // Look for a way to go right away
+		m_HasScoutTarget = false;
+
+		// Head for the scouted spot if there is one, wander otherwise
+		m_Movement.SetWeight(m_ScoutSeekIdx, 0.f);
+		m_Movement.SetWeight(m_WanderIdx, 1.f);
 	}
 	
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
-		auto finalSteering = m_Wander.CalculateSteering(agentInfo);
+		const auto& agentInfo = perception.GetAgentInfo();
+
+		// Every now and then, check the influence map for a better way to go than where the wandering's heading
+		m_ScoutTimer += deltaTime;
+		if (m_ScoutTimer >= m_ScoutInterval)
+		{
+			m_ScoutTimer -= m_ScoutInterval;
+			m_HasScoutTarget = FindScoutTarget(agentInfo);
+		}
+		if (m_HasScoutTarget && agentInfo.Position.DistanceSquared(m_Movement.Get<m_ScoutSeekIdx>().GetTarget().Position) < m_ScoutReachedDistance * m_ScoutReachedDistance)
+			m_HasScoutTarget = false; // Got there, back to wandering
+		m_Movement.SetWeight(m_ScoutSeekIdx, m_HasScoutTarget ? 1.f : 0.f);
+		auto finalSteering = m_Movement.CalculateSteering(agentInfo);
 
 		// If dying of lack of energy, run around aimlessly in hopes of finding a house with food
 		if (agentInfo.Energy <= 0.f)
@@ -132,9 +157,59 @@ public:
 		return finalSteering;
 	}
 
+	void DebugDraw(DebugDrawList& drawList, const Perception& perception) const override
+	{
+		// Where the influence map's taking it, if anywhere
+		if (m_HasScoutTarget)
+			drawList.AddSegment(eDebugDrawCategory::Paths, perception.GetAgentInfo().Position, m_Movement.Get<m_ScoutSeekIdx>().GetTarget().Position, { 0, 1, 0 });
+	}
+
 private:
-	Wander m_Wander;
+	bool FindScoutTarget(const AgentInfo& agentInfo)
+	{
+		// Loot that's been seen around, minus whatever made it dangerous
+		const auto getScore = [this](const Elite::Vector2& position)
+		{
+			return m_pInfluenceMap->Get(eInfluenceLayer::Loot, position) - m_pInfluenceMap->Get(eInfluenceLayer::Threat, position)
+				- m_pInfluenceMap->Get(eInfluenceLayer::PurgeDanger, position);
+		};
+
+		// Only worth it if one of the spots around beats the one straight ahead by a margin
+		auto heading = agentInfo.LinearVelocity;
+		if (heading.Normalize() <= 0.f)
+			heading = Elite::DirectionFromOrientation(agentInfo.Orientation);
+		auto bestScore = getScore(agentInfo.Position + heading * m_ScoutDistance) + m_ScoutMargin;
+		bool found = false;
+		for (int i = 0; i < m_ScoutDirections; ++i)
+		{
+			const auto angle = float(i) * 2.f * float(E_PI) / float(m_ScoutDirections);
+			const auto spot = agentInfo.Position + Elite::DirectionFromAngle(angle) * m_ScoutDistance;
+			if (m_pInfluenceMap->IsInWorld(spot) == false)
+				continue;
+
+			const auto score = getScore(spot);
+			if (score > bestScore)
+			{
+				bestScore = score;
+				m_Movement.Get<m_ScoutSeekIdx>().SetTarget(spot);
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	static const size_t m_ScoutSeekIdx{ 0 }; // In priority order
+	static const size_t m_WanderIdx{ 1 };
+	StaticSteeringBlender<Seek, Wander> m_Movement;
 	Seek m_TurnAroundSeek;
+	const InfluenceMap* m_pInfluenceMap; // Kept by the plugin
+	bool m_HasScoutTarget{};
+	float m_ScoutTimer{};
+	const float m_ScoutInterval{ 2.f };
+	const float m_ScoutDistance{ 24.f };
+	const float m_ScoutReachedDistance{ 4.f };
+	const float m_ScoutMargin{ 0.25f };
+	const int m_ScoutDirections{ 8 };
 	const float m_SprintStamina{ 5.f };
 	const float m_MinimumToSprint{ 2.f };
 	float m_InitialStamina{};
@@ -154,58 +229,56 @@ private:
 class SeekItemsState : public FSMState
 {
 public:
-	SeekItemsState() : FSMState() {}
+	explicit SeekItemsState(Inventory* pInventory) : FSMState(), m_pInventory(pInventory) {}
 	
-	void OnEnter(IExamInterface* pInterface) override
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
 		// Check if there are any items in the FOV
-		vector<EntityInfo> itemsInFOV = GetItemsInFOV(pInterface);
+		const auto& itemsInFOV = perception.GetItems();
 
 		// If there are, change the target to the closest one
 		if (!itemsInFOV.empty())
 		{
-			const auto agentInfo = pInterface->Agent_GetInfo();
-			EntityInfo closestItem = itemsInFOV[0];
-
-			for (const auto& item : itemsInFOV)
-			{
-				if (item.Location.Distance(agentInfo.Position) < closestItem.Location.Distance(agentInfo.Position))
-					closestItem = item;
-			}
+			const auto& agentInfo = perception.GetAgentInfo();
+			const auto& closestItem = itemsInFOV[Elite::ClosestPoint(perception.GetItemPositions(), agentInfo.Position)];
 
 			m_Behaviour.SetTarget(closestItem.Location);
 			m_CurrentlySeeking = true;
 		}
 	}
 	
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 		
 		// Check if there are any items in the FOV
-		vector<EntityInfo> itemsInFOV = GetItemsInFOV(pInterface);
+		// (copied into a member vector, which keeps its capacity between frames, since the grabbed items get removed from it)
+		auto& itemsInFOV = m_ItemsInFOV;
+		itemsInFOV = perception.GetItems();
 
 		// If there are
 		if (!itemsInFOV.empty())
 		{
-			PickUpCloseItems(itemsInFOV, pInterface);
+			PickUpCloseItems(itemsInFOV, pInterface, agentInfo);
 
 			if (itemsInFOV.empty() == false) // If there are still any items left in the FOV after potentially removing the grabbed one
 			{
-				// Calculate the closest item that isn't being seeked
-				EntityInfo closestNotSeekedItem = itemsInFOV[0];
+				// Calculate the closest item that isn't being seeked (out of the 2 closest ones, one of them might be the seeked item)
+				m_ItemPositions.Clear();
 				for (const auto& item : itemsInFOV)
-				{
-					if (m_Behaviour.GetTarget().Position != item.Location &&
-						item.Location.Distance(agentInfo.Position) < closestNotSeekedItem.Location.Distance(agentInfo.Position))
-						closestNotSeekedItem = item;
-				}
+					m_ItemPositions.PushBack(item.Location);
+
+				int closestIndices[2]{};
+				float closestDistancesSquared[2]{};
+				const auto nrOfClosest = Elite::ClosestPoints(m_ItemPositions, agentInfo.Position, 2, closestIndices, closestDistancesSquared);
+				const auto closestIdx = nrOfClosest > 1 && itemsInFOV[closestIndices[0]].Location == m_Behaviour.GetTarget().Position ? 1 : 0;
+				const auto& closestNotSeekedItem = itemsInFOV[closestIndices[closestIdx]];
 
 				// And change the target to it IF
 				if (m_CurrentlySeeking == true)
 				{
 					// the newly calculated item is closer than the one being currently seeked
-					if (closestNotSeekedItem.Location.Distance(agentInfo.Position) < m_Behaviour.GetTarget().Position.Distance(agentInfo.Position))
+					if (closestDistancesSquared[closestIdx] < m_Behaviour.GetTarget().Position.DistanceSquared(agentInfo.Position))
 					{
 						m_Behaviour.SetTarget(closestNotSeekedItem.Location);
 						m_CurrentlySeeking = true;
@@ -228,29 +301,8 @@ public:
 	}
 
 private:
-	vector<EntityInfo> GetItemsInFOV(IExamInterface* pInterface)
+	void PickUpCloseItems(vector<EntityInfo>& itemsInFOV, IExamInterface* pInterface, const AgentInfo& agentInfo)
 	{
-		vector<EntityInfo> itemsInFOV = {};
-		for (int i = 0;; ++i)
-		{
-			EntityInfo entityInfo = {};
-			if (pInterface->Fov_GetEntityByIndex(i, entityInfo))
-			{
-				if (entityInfo.Type == eEntityType::ITEM)
-					itemsInFOV.push_back(entityInfo);
-
-				continue;
-			}
-			break;
-		}
-
-		return itemsInFOV;
-	}
-
-	void PickUpCloseItems(vector<EntityInfo>& itemsInFOV, IExamInterface* pInterface)
-	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
-		
 		for (const auto& item : itemsInFOV)
 		{
 			// If any item is close enough to be grabbed
@@ -269,213 +321,79 @@ private:
 					itemsInFOV.erase(it, itemsInFOV.end());
 					m_CurrentlySeeking = false;
 
-					// Check if the item is worth keeping
-					bool worthKeeping = true;
-					switch (actualItem.Type) // Check if the item has at least 1 unit and isn't garbage
-					{
-					case eItemType::MEDKIT:
-						if (pInterface->Medkit_GetHealth(actualItem) == 0)
-							worthKeeping = false;
-						break;
-					case eItemType::FOOD:
-						if (pInterface->Food_GetEnergy(actualItem) == 0)
-							worthKeeping = false;
-						break;
-					case eItemType::PISTOL:
-						if (pInterface->Weapon_GetAmmo(actualItem) == 0)
-							worthKeeping = false;
-						break;
-					case eItemType::GARBAGE:
-						worthKeeping = false;
-						break;
-					default:
-						break;
-					}
+					// Check if the item is worth keeping (it has at least 1 unit and isn't garbage)
+					const auto units = m_pInventory->QueryUnits(actualItem);
+					const bool worthKeeping = actualItem.Type != eItemType::GARBAGE && units > 0;
 
-					// And go over each individual inventory slot
-					vector<int> medKitsSlots{};
-					vector<int> foodSlots{};
-					vector<int> pistolsSlots{};
-					const int nrOfSlots = pInterface->Inventory_GetCapacity();
-					for (auto currentSlot = 0; currentSlot < nrOfSlots; currentSlot++)
+					// If there's an empty slot, store the found item in it
+					const auto emptySlot = m_pInventory->GetEmptySlot();
+					if (emptySlot != -1)
 					{
-						ItemInfo itemAlreadyInSlot;
-
-						// If the slot is empty, store the found item in it
-						if (pInterface->Inventory_GetItem(currentSlot, itemAlreadyInSlot) == false)
-						{
-							pInterface->Inventory_AddItem(currentSlot, actualItem);
-
-							// And if it's a not worth keeping item, throw it out right away
-							// (this way, the agent still gets the 2 points for picking it up)
-							if (worthKeeping == false)
-								pInterface->Inventory_RemoveItem(currentSlot);
+						m_pInventory->Add(UINT(emptySlot), actualItem, units);
 
-							break;
-						}
-						else // If not, try the next slot
-						{
-							switch(itemAlreadyInSlot.Type) // But still update the item type counters before moving on
-							{
-							case eItemType::MEDKIT:
-								medKitsSlots.push_back(currentSlot);
-								break;
-							case eItemType::FOOD:
-								foodSlots.push_back(currentSlot);
-								break;
-							case eItemType::PISTOL:
-								pistolsSlots.push_back(currentSlot);
-								break;
-							default:
-								break;
-							}
-							
-							if (currentSlot == nrOfSlots - 1) // If there are no more slots
-							{			
-								if (worthKeeping) // And if the found item is worth keeping
-								{
-									// Clear a slot with the item type there's the most of, and store it there
-									// In the case of a tie, food is favored above all, followed by medkits and then finally pistols
-									int slotToReplace = 0;
-
-									if (foodSlots.size() > medKitsSlots.size() && foodSlots.size() > pistolsSlots.size())
-									{
-										int leastFoodSlot = foodSlots[0]; // Find which food slot has the least amount of food
-										int smallestFoodAmount = 10; // 10 is a random big number, just for the impossible scenario the first slot GetItem fails
-										ItemInfo food{};
-										if (pInterface->Inventory_GetItem(leastFoodSlot, food))
-											smallestFoodAmount = pInterface->Food_GetEnergy(food);
-										
-										for(auto foodSlot : foodSlots)
-										{
-											if(pInterface->Inventory_GetItem(foodSlot, food))
-											{
-												if(smallestFoodAmount > pInterface->Food_GetEnergy(food))
-												{
-													leastFoodSlot = foodSlot;
-													smallestFoodAmount = pInterface->Food_GetEnergy(food);
-												}
-											}
-										}
-
-										if (int(foodSlots.size()) > leastFoodSlot)
-											slotToReplace = foodSlots[leastFoodSlot]; // And replace that one
-									}
-									else
-									{
-										if (medKitsSlots.size() >= foodSlots.size() && medKitsSlots.size() > pistolsSlots.size())
-										{
-											int leastMedHealthSlot = medKitsSlots[0]; // Find which medkit slot has the least amount of health
-											int smallestMedHealthAmount = 10; // 10 is a random big number, just for the impossible scenario the first slot GetItem fails
-											ItemInfo medkit{};
-											if (pInterface->Inventory_GetItem(leastMedHealthSlot, medkit))
-												smallestMedHealthAmount = pInterface->Medkit_GetHealth(medkit);
-
-											for (auto medkitSlot : medKitsSlots)
-											{
-												if (pInterface->Inventory_GetItem(medkitSlot, medkit))
-												{
-													if (smallestMedHealthAmount > pInterface->Medkit_GetHealth(medkit))
-													{
-														leastMedHealthSlot = medkitSlot;
-														smallestMedHealthAmount = pInterface->Medkit_GetHealth(medkit);
-													}
-												}
-											}
-
-											if (int(medKitsSlots.size()) > leastMedHealthSlot)
-												slotToReplace = medKitsSlots[leastMedHealthSlot]; // And replace that one
-										}
-										else
-										{
-											int leastAmmoSlot = pistolsSlots[0]; // Find which pistol slot has the least amount of ammo
-											int smallestAmmoAmount = 20; // 20 is a random big number, just for the impossible scenario the first slot GetItem fails
-											ItemInfo pistol{};
-											if (pInterface->Inventory_GetItem(leastAmmoSlot, pistol))
-												smallestAmmoAmount = pInterface->Weapon_GetAmmo(pistol);
-
-											for (auto pistolSlot : pistolsSlots)
-											{
-												if (pInterface->Inventory_GetItem(pistolSlot, pistol))
-												{
-													if (smallestAmmoAmount > pInterface->Weapon_GetAmmo(pistol))
-													{
-														leastAmmoSlot = pistolSlot;
-														smallestAmmoAmount = pInterface->Weapon_GetAmmo(pistol);
-													}
-												}
-											}
-
-											if(int(pistolsSlots.size()) > leastAmmoSlot)
-												slotToReplace = pistolsSlots[leastAmmoSlot]; // And replace that one
-										}
-									}
-
-									// Finally, replace the item in the chosen slot for the new item
-									pInterface->Inventory_RemoveItem(slotToReplace);
-									pInterface->Inventory_AddItem(slotToReplace, actualItem);
-									break;
-								}
-								else // If it's not worth keeping, destroy it without picking it up
-								{
-									pInterface->Item_Destroy(item);
-								}
-							}
-						}
+						// And if it's a not worth keeping item, throw it out right away
+						// (this way, the agent still gets the 2 points for picking it up)
+						if (worthKeeping == false)
+							m_pInventory->Remove(UINT(emptySlot));
 					}
-
-					// And notify the ItemUsage Observer if the item was stored
-					if (worthKeeping)
+					else if (worthKeeping) // If the inventory is full, but the found item is worth keeping
 					{
-						switch (actualItem.Type)
+						// Clear the weakest slot of the item type there's the most of, and store it there
+						// In the case of a tie, food is favored above all, followed by medkits and then finally pistols
+						const auto nrOfFood = m_pInventory->GetCount(eItemType::FOOD);
+						const auto nrOfMedkits = m_pInventory->GetCount(eItemType::MEDKIT);
+						const auto nrOfPistols = m_pInventory->GetCount(eItemType::PISTOL);
+
+						auto typeToReplace = eItemType::PISTOL;
+						if (nrOfFood > nrOfMedkits && nrOfFood > nrOfPistols)
+							typeToReplace = eItemType::FOOD;
+						else if (nrOfMedkits >= nrOfFood && nrOfMedkits > nrOfPistols)
+							typeToReplace = eItemType::MEDKIT;
+
+						const auto slotToReplace = m_pInventory->GetWeakestSlot(typeToReplace);
+						if (slotToReplace != -1)
 						{
-						case eItemType::MEDKIT:
-							m_Subject->Notify(Event::MedkitPickedUp);
-							break;
-						case eItemType::FOOD:
-							m_Subject->Notify(Event::FoodPickedUp);
-							break;
-						case eItemType::PISTOL:
-							m_Subject->Notify(Event::PistolPickedUp);
-							break;
-						default:
-							break;
+							m_pInventory->Remove(UINT(slotToReplace));
+							m_pInventory->Add(UINT(slotToReplace), actualItem, units);
 						}
 					}
+					else // If it's not worth keeping either, destroy it without picking it up
+					{
+						pInterface->Item_Destroy(item);
+					}
 				}
 			}
 		}
 	}
 	
+	Inventory* m_pInventory;
 	Seek m_Behaviour;
 	bool m_CurrentlySeeking{ false };
+	vector<EntityInfo> m_ItemsInFOV;
+	Elite::Vector2SoA m_ItemPositions; // Of m_ItemsInFOV
 };
 
 class FleeEnemiesState : public FSMState
 {
 public:
-	FleeEnemiesState() : FSMState() {}
+	FleeEnemiesState(const EnemyTracks* pEnemyTracks, const DangerField* pDangerField) : FSMState(), m_pEnemyTracks(pEnemyTracks), m_pDangerField(pDangerField) {}
 
-	void OnEnter(IExamInterface* pInterface) override
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 		
 		// Save initial stamina and health
 		m_InitialStamina = agentInfo.Stamina;
 		m_AgentHP = agentInfo.Health;
 
 		// Start sprinting
-		m_Sprinting = true;		
-	}
-
-	void OnExit(IExamInterface* pInterface) override
-	{
-		m_EnemiesNearby.clear();
+		m_Sprinting = true;
+		m_FleeDirection = Elite::Vector2{};
 	}
 	
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 
 		// Check if the agent was just damaged, and if so sprint
 		if (agentInfo.Health < m_AgentHP || agentInfo.Health > m_AgentHP)
@@ -489,152 +407,82 @@ public:
 			m_AgentHP = agentInfo.Health;
 		}
 		
-		// Check if there are any new enemies nearby and add them to the vector
-		for (int i = 0;; ++i)
+		// Check if any enemy just started being tracked
+		if (m_pEnemyTracks->GetAddedCount() > 0 && agentInfo.Stamina > m_MinimumToSprint)
 		{
-			EntityInfo spottedEntity = {};
-			if (pInterface->Fov_GetEntityByIndex(i, spottedEntity))
-			{
-				if (spottedEntity.Type == eEntityType::ENEMY)
-				{
-					bool alreadyStored{ false };
-					
-					for (const auto& knownEnemy : m_EnemiesNearby)
-					{
-						if (spottedEntity.EntityHash == knownEnemy.EntityHash)
-						{
-							alreadyStored = true;
-							break;
-						}
-					}
-
-					if (alreadyStored == false)
-					{
-						m_EnemiesNearby.push_back(spottedEntity);
-						std::cout << "New enemy spotted! Size of vector now: " << m_EnemiesNearby.size() << '\n';
-
-						if (agentInfo.Stamina > m_MinimumToSprint)
-						{
-							// Reset initial stamina and sprint (or continue sprinting for longer)
-							m_InitialStamina = agentInfo.Stamina;
-							m_Sprinting = true;
-						}
-					}
-				}
-
-				continue;
-			}
-			break;
+			// Reset initial stamina and sprint (or continue sprinting for longer)
+			m_InitialStamina = agentInfo.Stamina;
+			m_Sprinting = true;
 		}
 
-		// Remove far away enemies from the vector
-		auto removed = remove_if(m_EnemiesNearby.begin(), m_EnemiesNearby.end(), [&](const EntityInfo& enemy)
-			{
-				if (enemy.Location.Distance(agentInfo.Position) > m_FleeDistance)
-				{
-					std::cout << "Escaped from enemy! Size of vector now: " << m_EnemiesNearby.size() - 1 << '\n';
-					return true;
-				}
-				else
-					return false;
-			});
+		// Check if any tracked enemy is (about to be) nearby
+		const auto& predictedPositions = m_pEnemyTracks->GetPredictedPositions();
+		Elite::PointsInRadius(predictedPositions, agentInfo.Position, m_FleeDistance, m_TrackIndicesNearby);
+		if (m_TrackIndicesNearby.empty())
+			return SteeringPlugin_Output{}; // Every enemy got far enough away (EscapedFromEnemies takes over next frame)
 
-		m_EnemiesNearby.erase(removed, m_EnemiesNearby.end());
-		
-		
-		// Create all the needed flee behaviors with their respective weight (one for each spotted enemy)
-		if (m_EnemiesNearby.empty() == false)
+		// Go down the danger field (away from all of them at once, and around the walls)
+		auto fleeDirection = m_pDangerField->GetFlow(agentInfo.Position);
+		if (fleeDirection == Elite::Vector2{})
 		{
-			std::vector<std::pair<Flee, float>> weightedFlees{};
-
-			// Create and store each flee
-			float combinedEnemyDistances{};
-			for (const auto& enemy : m_EnemiesNearby)
+			// Where the field's flat (right on top of an enemy, or boxed in), get away from the ones closing in, the sooner they'd get here the more
+			// (and if none of them is, from the closest one)
+			const auto& timesToReach = m_pEnemyTracks->GetTimesToReachAgent();
+			float closestDistanceSquared = FLT_MAX;
+			Elite::Vector2 awayFromClosest{};
+			for (const auto trackIdx : m_TrackIndicesNearby)
 			{
-				Flee enemyFlee;
-				enemyFlee.SetTarget(enemy.Location);
-				const auto distance = enemy.Location.Distance(agentInfo.Position);
-				combinedEnemyDistances += distance;
-				auto pair = std::pair<Flee, float>(enemyFlee, distance); // The paired float is still only the distance, it will be recalculated into the unscaled weight later
-				weightedFlees.push_back(pair);
-			}
-
-			// Calculate each weight from closest to furthest
-			for (auto weightedFlee : weightedFlees)
-				weightedFlee.second = combinedEnemyDistances - weightedFlee.second;
-
-			// Execute the blended steering from all the stored behaviors
-			if (weightedFlees.empty() == false)
-			{
-				if (weightedFlees.size() == 1)
+				const auto awayFromEnemy = agentInfo.Position - predictedPositions[trackIdx];
+				const auto distanceSquared = awayFromEnemy.Dot(awayFromEnemy);
+				if (distanceSquared < closestDistanceSquared)
 				{
-					// Activate run only for a short sprint
-					auto singleFleeSteering = weightedFlees[0].first.CalculateSteering(agentInfo);
-					if (m_Sprinting)
-					{
-						if (m_InitialStamina - agentInfo.Stamina < m_SprintStamina && agentInfo.Stamina > 0.f)
-						{
-							singleFleeSteering.RunMode = true;
-						}
-						else
-						{
-							singleFleeSteering.RunMode = false;
-							m_Sprinting = false;
-						}
-					}
-					return singleFleeSteering;
+					closestDistanceSquared = distanceSquared;
+					awayFromClosest = awayFromEnemy;
 				}
-				else
-				{
-					SteeringPlugin_Output finalSteering{};
-
-					float combinedWeight{};
-
-					for (auto weightedFlee : weightedFlees)
-					{
-						// Calculate the combined weight of all flees
-						combinedWeight += weightedFlee.second;
+				if (timesToReach[trackIdx] != FLT_MAX && distanceSquared > 0.f)
+					fleeDirection += awayFromEnemy / sqrtf(distanceSquared) / max(timesToReach[trackIdx], m_MinTimeToReach);
+			}
+			if (fleeDirection == Elite::Vector2{})
+				fleeDirection = awayFromClosest;
+			fleeDirection.Normalize();
+		}
 
-						// Calculate the blended steering from all the flees, according to their respective weight
-						auto steering = weightedFlee.first.CalculateSteering(agentInfo);
-						finalSteering.LinearVelocity += weightedFlee.second * steering.LinearVelocity;
-						finalSteering.AngularVelocity += weightedFlee.second * steering.AngularVelocity;
-					}
+		// Turn towards it at a limited rate, an enemy that's caught up flips the way out every frame (and the field with it)
+		if (m_FleeDirection != Elite::Vector2{} && fleeDirection != Elite::Vector2{})
+		{
+			const auto maxTurn = m_MaxTurnSpeed * deltaTime;
+			const auto turn = Elite::DirectionFromAngle(Elite::Clamp(Elite::SignedAngle(m_FleeDirection, fleeDirection), -maxTurn, maxTurn));
+			fleeDirection = Elite::Vector2{ m_FleeDirection.x * turn.x - m_FleeDirection.y * turn.y, m_FleeDirection.x * turn.y + m_FleeDirection.y * turn.x };
+		}
+		m_FleeDirection = fleeDirection;
 
-					// Scale the steering output according to the scale
-					if (combinedWeight > 0.f)
-					{
-						const auto scale = 1.f / combinedWeight;
-						finalSteering.LinearVelocity *= scale;
-						finalSteering.AngularVelocity *= scale;
-					}
+		SteeringPlugin_Output finalSteering{};
+		finalSteering.LinearVelocity = fleeDirection * agentInfo.MaxLinearSpeed;
 
-					// Activate run only for a short sprint
-					if (m_Sprinting)
-					{
-						if (m_InitialStamina - agentInfo.Stamina < m_SprintStamina && agentInfo.Stamina > 0.f)
-						{
-							finalSteering.RunMode = true;
-						}
-						else
-						{
-							finalSteering.RunMode = false;
-							m_Sprinting = false;
-						}
-					}
-					return finalSteering;
-				}
+		// Activate run only for a short sprint
+		if (m_Sprinting)
+		{
+			if (m_InitialStamina - agentInfo.Stamina < m_SprintStamina && agentInfo.Stamina > 0.f)
+			{
+				finalSteering.RunMode = true;
 			}
 			else
 			{
-				return SteeringPlugin_Output{};
+				finalSteering.RunMode = false;
+				m_Sprinting = false;
 			}
 		}
+		return finalSteering;
 	}
 
 private:
-	vector<EntityInfo> m_EnemiesNearby;
+	const EnemyTracks* m_pEnemyTracks; // Kept by the plugin, so enemies are remembered across state changes
+	const DangerField* m_pDangerField; // Same, updated from those tracks
+	vector<int> m_TrackIndicesNearby; // Only reused between frames (to not reallocate)
 	const float m_FleeDistance{ 50.f };
+	const float m_MinTimeToReach{ 0.1f }; // In seconds, so the ones that are already there don't take over completely
+	const float m_MaxTurnSpeed{ 2.f * float(E_PI) }; // In radians per second
+	Elite::Vector2 m_FleeDirection{};
 	const float m_SprintStamina{ 5.f };
 	const float m_MinimumToSprint{ 2.f };
 	bool m_Sprinting{};
@@ -645,9 +493,13 @@ private:
 class SeekHouseState : public FSMState
 {
 public:
-	SeekHouseState() : FSMState() {}
+	SeekHouseState(const HouseMemory* pHouseMemory, const InfluenceMap* pInfluenceMap, const NavGrid* pNavGrid, uint32_t randomSeed) : FSMState(), m_pHouseMemory(pHouseMemory), m_pInfluenceMap(pInfluenceMap)
+	{
+		m_PathToHouse.SetNavGrid(pNavGrid);
+		m_WanderToUnstuck.SetRandomSeed(randomSeed);
+	}
 
-	void OnEnter(IExamInterface* pInterface) override
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
 		m_SeekedHouse = HouseInfo{};
 		m_InitialStamina = 0.f;
@@ -658,35 +510,35 @@ public:
 		m_TryToUnstuckCounter = false;
 		
 		// Check if there are any houses inside the FOV
-		vector<HouseInfo> spottedHouses = {};
-		HouseInfo spottedHouse = {};
-		for (int i = 0;; ++i)
-		{
-			if (pInterface->Fov_GetHouseByIndex(i, spottedHouse))
-			{
-				spottedHouses.push_back(spottedHouse);
-				continue;
-			}
-			break;
-		}
+		const auto& spottedHouses = perception.GetHouses();
 		
-		// If there are, change the target the closest one
+		// If there are, change the target the closest one (rather one that hasn't had too many enemies around lately, if there's any)
+		const auto& agentInfo = perception.GetAgentInfo();
 		if (!spottedHouses.empty())
 		{
-			const auto agentInfo = pInterface->Agent_GetInfo();
-			m_SeekedHouse = spottedHouses[0];
-
+			m_SeekedHouse = spottedHouses[Elite::ClosestPoint(perception.GetHouseCenters(), agentInfo.Position)];
+			float closestDistanceSquared = FLT_MAX;
 			for (const auto& house : spottedHouses)
 			{
-				if (house.Center.Distance(agentInfo.Position) < m_SeekedHouse.Center.Distance(agentInfo.Position))
+				const auto distanceSquared = agentInfo.Position.DistanceSquared(house.Center);
+				if (distanceSquared < closestDistanceSquared && m_pInfluenceMap->Get(eInfluenceLayer::Threat, house.Center) < m_MaxHouseThreat)
+				{
+					closestDistanceSquared = distanceSquared;
 					m_SeekedHouse = house;
+				}
 			}
 		}
+		else // If not (anymore), head to the closest house that was seen before and wasn't looted yet
+		{
+			const auto houseIdx = m_pHouseMemory->FindNearestUnlooted(agentInfo.Position);
+			if (houseIdx >= 0)
+				m_SeekedHouse = m_pHouseMemory->GetHouse(houseIdx);
+		}
 	}
 
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 
 		if (m_Stuck)
 		{
@@ -701,7 +553,7 @@ public:
 		}
 		else
 		{
-			if (agentInfo.CurrentLinearSpeed < 0.5f) // If the agent isn't moving much
+			if (agentInfo.CurrentLinearSpeed < 0.5f && m_PathToHouse.HasNavigation() == false) // If the agent isn't moving much (a planned route goes around the walls, so it can't get stuck on them)
 			{
 				m_NotMovingCounter += deltaTime;
 				if (m_NotMovingCounter > m_TimeStoppedToConsiderStuck) // If they keep not moving for 0.5 seconds
@@ -711,8 +563,9 @@ public:
 				}
 			}
 
-			// Calculate seek to the house center
-			m_SeekHouseCenter.SetTarget(pInterface->NavMesh_GetClosestPathPoint(m_SeekedHouse.Center));
+			// Calculate seek to the house center (along the navmesh path)
+			m_PathToHouse.SetGoal(m_SeekedHouse.Center);
+			m_SeekHouseCenter.SetTarget(m_PathToHouse.GetWaypoint(pInterface, agentInfo.Position));
 			auto finalSteering = m_SeekHouseCenter.CalculateSteering(agentInfo);
 
 			// Run in sprints
@@ -764,8 +617,23 @@ public:
 		}
 	}
 
+	void DebugDraw(DebugDrawList& drawList, const Perception& perception) const override
+	{
+		m_PathToHouse.DebugDraw(drawList, perception.GetAgentInfo().Position);
+
+		// And the house itself
+		const auto& center = m_SeekedHouse.Center;
+		const auto halfSize = m_SeekedHouse.Size / 2.f;
+		const Elite::Vector2 corners[4]{ center - halfSize, { center.x + halfSize.x, center.y - halfSize.y }, center + halfSize, { center.x - halfSize.x, center.y + halfSize.y } };
+		drawList.AddPolygon(eDebugDrawCategory::Paths, corners, 4, { 1, 1, 0 });
+	}
+
 private:
+	const HouseMemory* m_pHouseMemory; // Kept by the plugin, so houses are remembered across state changes
+	const InfluenceMap* m_pInfluenceMap; // Same
+	const float m_MaxHouseThreat{ 0.25f };
 	Seek m_SeekHouseCenter;
+	PathFollower m_PathToHouse;
 	Wander m_WanderToUnstuck;
 	HouseInfo m_SeekedHouse;
 	const float m_SprintStamina{ 3.f };
@@ -782,41 +650,43 @@ private:
 class LookAroundHouseState : public FSMState
 {
 public:
-	LookAroundHouseState() : FSMState() {}
+	explicit LookAroundHouseState(uint32_t randomSeed) : FSMState() { m_Wander.SetRandomSeed(randomSeed); }
 
-	void OnEnter(IExamInterface* pInterface) override
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
 		// If the house is recognizable in the FOV, store it
-		HouseInfo spottedHouse = {};
-		if (pInterface->Fov_GetHouseByIndex(0, spottedHouse))
+		const auto& spottedHouses = perception.GetHouses();
+		if (spottedHouses.empty() == false)
 		{
-			m_House = spottedHouse;
+			m_House = spottedHouses[0];
 			m_HouseFound = true;
-			m_Seek.SetTarget(spottedHouse.Center);
+			m_Seek.SetTarget(m_House.Center);
 		}
 	}
 	
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
+		const auto& agentInfo = perception.GetAgentInfo();
+
 		if (m_HouseFound)
 		{
 			// If still inside the house, wander
-			if (pInterface->Agent_GetInfo().IsInHouse)
+			if (agentInfo.IsInHouse)
 			{
-				auto wander = m_Wander.CalculateSteering(pInterface->Agent_GetInfo());
+				auto wander = m_Wander.CalculateSteering(agentInfo);
 				wander.AutoOrient = false;
-				wander.AngularVelocity = pInterface->Agent_GetInfo().MaxAngularSpeed; // Spin around looking for items
+				wander.AngularVelocity = agentInfo.MaxAngularSpeed; // Spin around looking for items
 				return wander;
-				//return m_Wander.CalculateSteering(pInterface->Agent_GetInfo());
+				//return m_Wander.CalculateSteering(agentInfo);
 			}
 			else // But if the agent ever accidentally leaves the house, seek the house center just enough to re-enter it
-				return m_Seek.CalculateSteering(pInterface->Agent_GetInfo());
+				return m_Seek.CalculateSteering(agentInfo);
 		}
 		else
 		{
 			// Wander normally, but looking to recognize the house (aka, look at a wall)
-			OnEnter(pInterface);
-			return m_Wander.CalculateSteering(pInterface->Agent_GetInfo());
+			OnEnter(pInterface, perception);
+			return m_Wander.CalculateSteering(agentInfo);
 		}
 	}
 
@@ -830,28 +700,21 @@ private:
 class ExitHouseState : public FSMState
 {
 public:
-	ExitHouseState() : FSMState() {}
+	ExitHouseState(const NavGrid* pNavGrid, uint32_t randomSeed) : FSMState()
+	{
+		m_PathOutside.SetNavGrid(pNavGrid);
+		m_WanderAround.SetRandomSeed(randomSeed);
+	}
 
-	void OnEnter(IExamInterface* pInterface) override
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
 		m_OutsidePosSet = false;
 		m_NotMovingCounter = 0.f;
 		m_Stuck = false;
 		m_TryToUnstuckCounter = 0.f;
 		
 		// Check if the agent can spot the house they're on in the FOV
-		vector<HouseInfo> spottedHouses = {};
-		HouseInfo spottedHouse = {};
-		for (int i = 0;; ++i)
-		{
-			if (pInterface->Fov_GetHouseByIndex(i, spottedHouse))
-			{
-				spottedHouses.push_back(spottedHouse);
-				continue;
-			}
-			break;
-		}
+		const auto& spottedHouses = perception.GetHouses();
 
 		// If so, set the target to somewhere outside the premises
 		if (spottedHouses.empty() == false)
@@ -861,9 +724,9 @@ public:
 		}
 	}
 	
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 
 		if(m_OutsidePosSet) // If the target was successfully set in the OnEnter
 		{
@@ -880,7 +743,7 @@ public:
 			}
 			else
 			{
-				if (agentInfo.CurrentLinearSpeed < 0.5f) // If the agent isn't moving much
+				if (agentInfo.CurrentLinearSpeed < 0.5f && m_PathOutside.HasNavigation() == false) // If the agent isn't moving much (same as when seeking a house)
 				{
 					m_NotMovingCounter += deltaTime;
 					if (m_NotMovingCounter > m_TimeStoppedToConsiderStuck) // If they keep not moving for 0.5 seconds
@@ -890,14 +753,15 @@ public:
 					}
 				}
 				
-				m_SeekOutsideHouse.SetTarget(pInterface->NavMesh_GetClosestPathPoint(m_PositionOutsideHouse));
+				m_PathOutside.SetGoal(m_PositionOutsideHouse);
+				m_SeekOutsideHouse.SetTarget(m_PathOutside.GetWaypoint(pInterface, agentInfo.Position));
 				return m_SeekOutsideHouse.CalculateSteering(agentInfo);
 			}
 		}
 		else // If not, keep looking for the house
 		{
 			// Redo all the OnEnter code
-			OnEnter(pInterface);
+			OnEnter(pInterface, perception);
 
 			// And wander around until the target is set
 			return m_WanderAround.CalculateSteering(agentInfo);
@@ -905,8 +769,15 @@ public:
 		}
 	}
 
+	void DebugDraw(DebugDrawList& drawList, const Perception& perception) const override
+	{
+		if (m_OutsidePosSet)
+			m_PathOutside.DebugDraw(drawList, perception.GetAgentInfo().Position);
+	}
+
 private:
 	Seek m_SeekOutsideHouse;
+	PathFollower m_PathOutside;
 	Wander m_WanderAround;
 	Elite::Vector2 m_PositionOutsideHouse;
 	bool m_OutsidePosSet{};
@@ -922,14 +793,14 @@ class ComeBackToTownState : public FSMState
 public:
 	ComeBackToTownState() : FSMState() {}
 
-	void OnEnter(IExamInterface* pInterface) override
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
-		m_SeekTownCenter.SetTarget(pInterface->World_GetInfo().Center);
+		m_SeekTownCenter.SetTarget(perception.GetWorldInfo().Center);
 	}
 	
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		return m_SeekTownCenter.CalculateSteering(pInterface->Agent_GetInfo());
+		return m_SeekTownCenter.CalculateSteering(perception.GetAgentInfo());
 	}
 
 private:
@@ -939,72 +810,123 @@ private:
 class FleePurgeZonesState : public FSMState
 {
 public:
-	FleePurgeZonesState() : FSMState() {}
+	FleePurgeZonesState(const InfluenceMap* pInfluenceMap, const NavGrid* pNavGrid, uint32_t randomSeed)
+		: FSMState(), m_pInfluenceMap(pInfluenceMap), m_Movement(eSteeringBlend::Priority), m_ExitHouseBehaviour(pNavGrid, randomSeed) { m_PathOutOfZone.SetNavGrid(pNavGrid); }
 
-	void OnEnter(IExamInterface* pInterface) override
+	void OnEnter(IExamInterface* pInterface, const Perception& perception) override
 	{
 		// Initialize the ExitHouseBehaviour
-		m_ExitHouseBehaviour.OnEnter(pInterface);
+		m_ExitHouseBehaviour.OnEnter(pInterface, perception);
+
+		// The zone being fled from is kept from last time, but the way out depends on where the agent is now
+		if (m_PurgeZoneCenter != Elite::Vector2{})
+			SetClosestWayOut(perception.GetAgentInfo().Position);
+
+		// Follow the route out if there's one, flee straight away from the zone otherwise
+		m_Movement.SetWeight(m_SeekWayOutIdx, 0.f);
+		m_Movement.SetWeight(m_FleeIdx, 1.f);
 	}
 	
-	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface) override
+	SteeringPlugin_Output Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 
 		// If inside a house, exit it first
 		if (agentInfo.IsInHouse)
-			return m_ExitHouseBehaviour.Update(deltaTime, pInterface);
+			return m_ExitHouseBehaviour.Update(deltaTime, pInterface, perception);
 		
-		// Save all purge zones in the FOV
-		vector<EntityInfo> purgeZonesInFOV;
-		EntityInfo entity = {};
-		for (int i = 0;; ++i)
-		{
-			if (pInterface->Fov_GetEntityByIndex(i, entity))
-			{
-				if (entity.Type == eEntityType::PURGEZONE)
-					purgeZonesInFOV.push_back(entity);
-
-				continue;
-			}
-
-			break;
-		}
+		// Get all purge zones in the FOV
+		const auto& purgeZonesInFOV = perception.GetPurgeZones();
 
 		// If any new purge zones were spotted
 		if (purgeZonesInFOV.empty() == false)
 		{
-			PurgeZoneInfo zoneInfo;
-
 			// If no purge zone is being fled from already, make the first in the FOV the target
 			if (m_PurgeZoneCenter == Elite::Vector2{})
 			{
-				pInterface->PurgeZone_GetInfo(purgeZonesInFOV[0], zoneInfo);
-				m_PurgeZoneCenter = zoneInfo.Center;
-				m_PurgeZoneRadius = zoneInfo.Radius;
-				m_FleeBehavior.SetTarget(m_PurgeZoneCenter);
+				m_PurgeZoneCenter = purgeZonesInFOV[0].Center;
+				m_PurgeZoneRadius = purgeZonesInFOV[0].Radius;
+				m_Movement.Get<m_FleeIdx>().SetTarget(m_PurgeZoneCenter);
+				SetClosestWayOut(agentInfo.Position);
 			}
 
-			// Then go over all the spotted purge zones
-			for (const auto& purgeZone : purgeZonesInFOV)
-			{
-				pInterface->PurgeZone_GetInfo(purgeZone, zoneInfo);
+			// Then find the spotted purge zone with the closest edge
+			float closestEdgeDistance{};
+			const auto& closestZone = purgeZonesInFOV[Elite::ClosestCircleEdge(perception.GetPurgeZoneCenters(), perception.GetPurgeZoneRadii(), agentInfo.Position, &closestEdgeDistance)];
 
-				// And if any one of them is closer then the one being fled from, change the target
-				if (zoneInfo.Center.Distance(agentInfo.Position) - zoneInfo.Radius < m_PurgeZoneCenter.Distance(agentInfo.Position) - m_PurgeZoneRadius)
-				{
-					m_PurgeZoneCenter = zoneInfo.Center;
-					m_PurgeZoneRadius = zoneInfo.Radius;
-					m_FleeBehavior.SetTarget(m_PurgeZoneCenter);
-				}
+			// And if it's closer then the one being fled from, change the target
+			if (closestEdgeDistance < m_PurgeZoneCenter.Distance(agentInfo.Position) - m_PurgeZoneRadius)
+			{
+				m_PurgeZoneCenter = closestZone.Center;
+				m_PurgeZoneRadius = closestZone.Radius;
+				m_Movement.Get<m_FleeIdx>().SetTarget(m_PurgeZoneCenter);
+				SetClosestWayOut(agentInfo.Position);
 			}
 		}
 
-		return m_FleeBehavior.CalculateSteering(agentInfo);
+		// With a nav grid, take the route to the closest point outside of the zone instead of fleeing straight into the walls
+		const bool hasWayOut = m_PathOutOfZone.HasNavigation() && m_PurgeZoneCenter != Elite::Vector2{};
+		if (hasWayOut)
+			m_Movement.Get<m_SeekWayOutIdx>().SetTarget(m_PathOutOfZone.GetWaypoint(pInterface, agentInfo.Position));
+		m_Movement.SetWeight(m_SeekWayOutIdx, hasWayOut ? 1.f : 0.f);
+
+		return m_Movement.CalculateSteering(agentInfo);
+	}
+
+	void DebugDraw(DebugDrawList& drawList, const Perception& perception) const override
+	{
+		if (perception.GetAgentInfo().IsInHouse)
+		{
+			m_ExitHouseBehaviour.DebugDraw(drawList, perception);
+			return;
+		}
+
+		// The zone being fled from, and the way out of it
+		if (m_PurgeZoneCenter != Elite::Vector2{})
+		{
+			drawList.AddCircle(eDebugDrawCategory::Paths, m_PurgeZoneCenter, m_PurgeZoneRadius, { 1, 0.5f, 0 });
+			m_PathOutOfZone.DebugDraw(drawList, perception.GetAgentInfo().Position);
+		}
 	}
 
 private:
-	Flee m_FleeBehavior;
+	void SetClosestWayOut(const Elite::Vector2& agentPosition)
+	{
+		auto direction = agentPosition - m_PurgeZoneCenter;
+		if (direction.Normalize() <= 0.f)
+			direction = Elite::Vector2{ 1.f, 0.f }; // Right in the middle, any way out is as close
+		const auto wayOutDistance = m_PurgeZoneRadius + m_WayOutMargin;
+
+		// Straight out is the closest, but a way out that ends up among enemies (or in another zone) is only worth it if the rest are much further
+		const auto getCost = [&](const Elite::Vector2& wayOut)
+		{
+			const auto danger = m_pInfluenceMap->Get(eInfluenceLayer::Threat, wayOut) + m_pInfluenceMap->Get(eInfluenceLayer::PurgeDanger, wayOut);
+			return agentPosition.Distance(wayOut) + danger * m_DangerDetour;
+		};
+		auto bestWayOut = m_PurgeZoneCenter + direction * wayOutDistance;
+		auto bestCost = getCost(bestWayOut);
+		for (int i = 0; i < m_WayOutDirections; ++i)
+		{
+			const auto angle = float(i) * 2.f * float(E_PI) / float(m_WayOutDirections);
+			const auto wayOut = m_PurgeZoneCenter + Elite::DirectionFromAngle(angle) * wayOutDistance;
+			const auto cost = getCost(wayOut);
+			if (cost < bestCost && m_pInfluenceMap->IsInWorld(wayOut))
+			{
+				bestCost = cost;
+				bestWayOut = wayOut;
+			}
+		}
+		m_PathOutOfZone.SetGoal(bestWayOut);
+	}
+
+	const InfluenceMap* m_pInfluenceMap; // Kept by the plugin
+	const int m_WayOutDirections{ 16 };
+	const float m_DangerDetour{ 20.f }; // How much further (in meters) a way out can be to avoid a full threat
+	static const size_t m_SeekWayOutIdx{ 0 }; // In priority order
+	static const size_t m_FleeIdx{ 1 };
+	StaticSteeringBlender<Seek, Flee> m_Movement;
+	PathFollower m_PathOutOfZone;
+	const float m_WayOutMargin{ 5.f }; // How far past the zone's edge
 	ExitHouseState m_ExitHouseBehaviour;
 	Elite::Vector2 m_PurgeZoneCenter{};
 	float m_PurgeZoneRadius{};
@@ -1019,62 +941,29 @@ private:
 class EnemySpotted : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 	
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		// Check if there's enemies nearby
-		vector<EntityInfo> enemiesNearby = {};
-		for (int i = 0;; ++i)
-		{
-			EntityInfo ei = {};
-			if (pInterface->Fov_GetEntityByIndex(i, ei))
-			{
-				if (ei.Type == eEntityType::ENEMY)
-					enemiesNearby.push_back(ei);
-
-				continue;
-			}
-			break;
-		}
-
-		// If there are, return true
-		if (enemiesNearby.empty() == false)
-			return true;
-		else
-			return false;
+		// Return if there's enemies nearby
+		return perception.HasEnemiesInFOV();
 	}
 };
 
 class EscapedFromEnemies : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 		m_TransitionTimer += deltaTime;
 	}
 	
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		// Check if there's enemies nearby
-		vector<EntityInfo> enemiesNearby = {};
-		for (int i = 0;; ++i)
-		{
-			EntityInfo ei = {};
-			if (pInterface->Fov_GetEntityByIndex(i, ei))
-			{
-				if (ei.Type == eEntityType::ENEMY)
-					enemiesNearby.push_back(ei);
-
-				continue;
-			}
-			break;
-		}
-
-		// If there are, re-start the transition timer
-		if (enemiesNearby.empty() == false)
+		// If there's enemies nearby, re-start the transition timer
+		if (perception.HasEnemiesInFOV())
 			m_TransitionTimer = 0.f;
 
 		// If the timer runs out, return true
@@ -1098,94 +987,60 @@ private:
 class NewHouseSpotted : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	explicit NewHouseSpotted(HouseMemory* pHouseMemory) : FSMTransition(), m_pHouseMemory(pHouseMemory) {}
+
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
-		// Forget any previously ransacked house after 90 seconds
-		// As new items might've already spawned in it in the meantime
-		for (auto i = int(m_RansackedHouses.size()) - 1; i >= 0; i--)
-		{
-			if (m_RansackedHouses[i].second + m_ResetHousesInterval < pInterface->World_GetStats().TimeSurvived)
-				m_RansackedHouses.erase(m_RansackedHouses.begin() + i);
-		}
+		// Previously ransacked houses get forgotten by the house memory itself (after 90 seconds)
+		// As new items might've already spawned in them in the meantime
 	}
 	
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
 		// Check if there are any not ransacked houses inside the FOV
-		vector<HouseInfo> spottedHouses = {};
-		HouseInfo spottedHouse = {};
-		for (int i = 0;; ++i)
+		m_SpottedHouseIndices.clear();
+		m_SpottedHouseCenters.Clear();
+		for (const auto& spottedHouse : perception.GetHouses())
 		{
-			if (pInterface->Fov_GetHouseByIndex(i, spottedHouse))
+			const auto houseIdx = m_pHouseMemory->Find(spottedHouse.Center); // Every house in the FOV is known by now
+			if (m_pHouseMemory->IsRansacked(houseIdx) == false)
 			{
-				bool isNew = true;
-				for (const auto& ransackedHouse : m_RansackedHouses)
-				{
-					if (spottedHouse.Center == ransackedHouse.first.Center)
-					{
-						isNew = false;
-						break;
-					}
-				}
-
-				if(isNew)
-					spottedHouses.push_back(spottedHouse);
-				
-				continue;
+				m_SpottedHouseIndices.push_back(houseIdx);
+				m_SpottedHouseCenters.PushBack(spottedHouse.Center);
 			}
-			break;
 		}
 
-		if (spottedHouses.empty()) // If no house is found, return false
+		if (m_SpottedHouseIndices.empty()) // If no house is found, return false
 		{
 			return false;
 		}
-		else // Else, save the closest one (the one that's gonna be seeked) and return true
+		else // Else, mark the closest one (the one that's gonna be seeked) as ransacked and return true
 		{
-			const auto agentInfo = pInterface->Agent_GetInfo();
-			auto closestHouse = spottedHouses[0];
-
-			for (const auto& house : spottedHouses)
-			{
-				if (house.Center.Distance(agentInfo.Position) < closestHouse.Center.Distance(agentInfo.Position))
-					closestHouse = house;
-			}
-
-			// The first part of the stored pair is the HouseInfo, the second is the time in which it was found
-			const auto currentTime = pInterface->World_GetStats().TimeSurvived;
-			const auto newHouse = std::make_pair(closestHouse, currentTime);
-			m_RansackedHouses.push_back(newHouse);
+			const auto& agentInfo = perception.GetAgentInfo();
+			const auto closestIdx = m_SpottedHouseIndices[Elite::ClosestPoint(m_SpottedHouseCenters, agentInfo.Position)];
+			m_pHouseMemory->MarkRansacked(closestIdx, perception.GetStats().TimeSurvived);
 			return true;
 		}
 	}
 private:
-	vector<std::pair<HouseInfo, float>> m_RansackedHouses;
-	const float m_ResetHousesInterval{ 90.f };
+	HouseMemory* m_pHouseMemory; // Kept by the plugin
+	vector<int> m_SpottedHouseIndices; // Only reused between frames (to not reallocate)
+	Elite::Vector2SoA m_SpottedHouseCenters; // Of m_SpottedHouseIndices
 };
 
 class HouseCenterReached : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 		
-		// Save all the houses in the FOV
-		vector<HouseInfo> spottedHouses = {};
-		HouseInfo spottedHouse = {};
-		for (int i = 0;; ++i)
-		{
-			if (pInterface->Fov_GetHouseByIndex(i, spottedHouse))
-			{
-				spottedHouses.push_back(spottedHouse);
-				continue;
-			}
-			break;
-		}
+		// Get all the houses in the FOV
+		const auto& spottedHouses = perception.GetHouses();
 
 		// If any house is seen, store the closest (and if the target's already set, check if the new house is closer)
 		if (!spottedHouses.empty())
@@ -1193,11 +1048,10 @@ public:
 			if (m_SeekedHouse.Center == Elite::Vector2{}) // If the seeked house hasn't been stored yet
 				m_SeekedHouse = spottedHouses[0]; // Save the first house in the FOV
 
-			for (const auto& house : spottedHouses)
-			{
-				if (house.Center.Distance(agentInfo.Position) < m_SeekedHouse.Center.Distance(agentInfo.Position))
-					m_SeekedHouse = house; // If any house is found close then the one being seeked, change the target
-			}
+			float closestDistanceSquared{};
+			const auto closestIdx = Elite::ClosestPoint(perception.GetHouseCenters(), agentInfo.Position, &closestDistanceSquared);
+			if (closestDistanceSquared < m_SeekedHouse.Center.DistanceSquared(agentInfo.Position))
+				m_SeekedHouse = spottedHouses[closestIdx]; // If any house is found close then the one being seeked, change the target
 		}
 
 		// If a target has been set
@@ -1225,62 +1079,29 @@ private:
 class ItemSpotted : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		// Check if there's items nearby
-		vector<EntityInfo> itemsNearby = {};
-		for (int i = 0;; ++i)
-		{
-			EntityInfo ei = {};
-			if (pInterface->Fov_GetEntityByIndex(i, ei))
-			{
-				if (ei.Type == eEntityType::ITEM)
-					itemsNearby.push_back(ei);
-
-				continue;
-			}
-			break;
-		}
-
-		// If there are, return true
-		if (itemsNearby.empty() == false)
-			return true;
-		else
-			return false;
+		// Return if there's items nearby
+		return perception.HasItemsInFOV();
 	}
 };
 
 class AllItemsCloseByTaken : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 		m_TransitionTimer += deltaTime;
 	}
 
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		// Check if there are any items in the FOV
-		vector<EntityInfo> itemsNearby = {};
-		for (int i = 0;; ++i)
-		{
-			EntityInfo ei = {};
-			if (pInterface->Fov_GetEntityByIndex(i, ei))
-			{
-				if (ei.Type == eEntityType::ITEM)
-					itemsNearby.push_back(ei);
-
-				continue;
-			}
-			break;
-		}
-
-		// If there are, re-start the transition timer
-		if (itemsNearby.empty() == false)
+		// If there are any items in the FOV, re-start the transition timer
+		if (perception.HasItemsInFOV())
 			m_TransitionTimer = 0.f;
 
 		// If the timer runs out, return true
@@ -1305,13 +1126,13 @@ private:
 class ExitedHouse : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 
 		if (agentInfo.IsInHouse)
 			return false;
@@ -1323,14 +1144,13 @@ public:
 class InsideHouse : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
-		return agentInfo.IsInHouse;
+		return perception.GetAgentInfo().IsInHouse;
 	}
 };
 
@@ -1338,14 +1158,14 @@ public:
 class ReturnedToTown : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentPos = pInterface->Agent_GetInfo().Position;
-		const auto town = pInterface->World_GetInfo();
+		const auto& agentPos = perception.GetAgentInfo().Position;
+		const auto& town = perception.GetWorldInfo();
 
 		return agentPos.x > town.Center.x - town.Dimensions.x / 2.f &&
 			agentPos.x < town.Center.x + town.Dimensions.x / 2.f &&
@@ -1357,14 +1177,14 @@ public:
 class TooFarAwayFromTown : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentPos = pInterface->Agent_GetInfo().Position;
-		const auto town = pInterface->World_GetInfo();
+		const auto& agentPos = perception.GetAgentInfo().Position;
+		const auto& town = perception.GetWorldInfo();
 		const auto explorationMargin = 10.f;
 
 		return !(agentPos.x > town.Center.x - (town.Dimensions.x / 2.f + explorationMargin) &&
@@ -1378,39 +1198,24 @@ public:
 class InsidePurgeZone : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 	}
 	
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
+		const auto& agentInfo = perception.GetAgentInfo();
 		
-		// Save all purge zones in the FOV
-		vector<EntityInfo> purgeZonesInFOV;
-		EntityInfo entity = {};
-		for (int i = 0;; ++i)
-		{
-			if (pInterface->Fov_GetEntityByIndex(i, entity))
-			{
-				if (entity.Type == eEntityType::PURGEZONE)
-					purgeZonesInFOV.push_back(entity);
-
-				continue;
-			}
-			break;
-		}
+		// Get all purge zones in the FOV
+		const auto& purgeZonesInFOV = perception.GetPurgeZones();
 
 		// If no purge zones were spotted, return false
 		if (purgeZonesInFOV.empty())
 			return false;
 
 		// If there were, check if the agent's inside any
-		for (const auto& zone : purgeZonesInFOV)
+		for (const auto& zoneInfo : purgeZonesInFOV)
 		{
-			PurgeZoneInfo zoneInfo;
-			pInterface->PurgeZone_GetInfo(purgeZonesInFOV[0], zoneInfo);
-			
 			if (zoneInfo.Center.Distance(agentInfo.Position) <= zoneInfo.Radius) // And return true if so
 				return true;
 		}
@@ -1422,33 +1227,16 @@ public:
 class PurgeZoneFled : public FSMTransition
 {
 public:
-	void Update(float deltaTime, IExamInterface* pInterface) override
+	void Update(float deltaTime, IExamInterface* pInterface, const Perception& perception) override
 	{
 		if (m_TimerOn)
 			m_Counter += deltaTime;
 	}
 	
-	bool ToTransition(IExamInterface* pInterface) override
+	bool ToTransition(IExamInterface* pInterface, const Perception& perception) override
 	{
-		const auto agentInfo = pInterface->Agent_GetInfo();
-
-		// Save all purge zones in the FOV
-		vector<EntityInfo> purgeZonesInFOV;
-		EntityInfo entity = {};
-		for (int i = 0;; ++i)
-		{
-			if (pInterface->Fov_GetEntityByIndex(i, entity))
-			{
-				if (entity.Type == eEntityType::PURGEZONE)
-					purgeZonesInFOV.push_back(entity);
-
-				continue;
-			}
-			break;
-		}
-
 		// If no purge zones were spotted
-		if (purgeZonesInFOV.empty())
+		if (perception.HasPurgeZonesInFOV() == false)
 		{
 			m_TimerOn = true; // Start or continue timer (to flee for 3 extra second)
 
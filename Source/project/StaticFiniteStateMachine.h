@@ -0,0 +1,280 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include <chrono>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include "FiniteStateMachine.h"
+#include "GameEvents.h"
+
+// A compile-time list of types
+template<typename... Types>
+struct FSMTypeList
+{
+	using Pointers = tuple<Types*...>;
+	static const size_t Size = sizeof...(Types);
+};
+
+// Taking Transition while in From goes to To
+template<typename TFrom, typename TTo, typename TTransition>
+struct FSMEdge
+{
+	using From = TFrom;
+	using To = TTo;
+	using Transition = TTransition;
+};
+
+// Index of T in Types (doesn't compile if it's not in there)
+template<typename T, typename... Types>
+struct FSMIndexOf;
+
+template<typename T, typename... Rest>
+struct FSMIndexOf<T, T, Rest...> : integral_constant<uint32_t, 0> {};
+
+template<typename T, typename First, typename... Rest>
+struct FSMIndexOf<T, First, Rest...> : integral_constant<uint32_t, 1 + FSMIndexOf<T, Rest...>::value> {};
+
+template<typename TStates, typename TTransitions, typename TEdges>
+class StaticFiniteStateMachine;
+
+// The same FSM as FiniteStateMachine, for a graph that's fixed at compile time: its states, transitions and edges are type lists
+// (the first state's the start state, and the edges are in priority order, like the transitions added to FiniteStateMachine)
+// The current state's an index, dispatched on by a chain of compares generated from the state list, and the states and transitions
+// are called by their own type instead of through the vtable, so the guards and the current state's Update() can get inlined
+// It behaves exactly like FiniteStateMachine on the same graph (same transitions' intervals, overruns and logged events),
+// only the budget stats and per-type profile zones of the transitions are left out
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+class StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>> final
+{
+public:
+	using States = tuple<TStates*...>;
+	using Transitions = tuple<TTransitions*...>;
+
+	// One of every state and transition, the arena's whatever they were created in (if they were), which the FSM takes over
+	StaticFiniteStateMachine(const States& states, const Transitions& transitions, IExamInterface* pInterface, FSMArena&& arena = FSMArena{});
+	~StaticFiniteStateMachine() = default;
+
+	StaticFiniteStateMachine(const StaticFiniteStateMachine&) = delete;
+	StaticFiniteStateMachine& operator=(const StaticFiniteStateMachine&) = delete;
+
+	SteeringPlugin_Output Update(float deltaTime, const Perception& perception);
+	void SetEventLog(EventLog* pEventLog); // Also hands it to every state
+	void SetEventQueue(GameEventQueue* pEvents) { m_pEvents = pEvents; } // Can be null, raises every state change (with the states' indices)
+	FSMState* GetCurrentState() const; // Null until the first Update()
+
+private:
+	static_assert(sizeof...(TStates) > 0, "The FSM needs a start state");
+	static_assert(sizeof...(TEdges) > 0, "A graph without transitions doesn't need an FSM");
+
+	using BudgetClock = chrono::steady_clock;
+
+	struct EdgeSlot
+	{
+		uint32_t FromStateId;
+		uint32_t OrderInState; // Among the edges from the same state
+		uint32_t Interval;
+		uint32_t TicksToWait; // Before it's evaluated again
+		float PendingTime; // Since it was last evaluated
+	};
+
+	template<typename Function>
+	void VisitState(uint32_t stateId, Function&& function) const { VisitState(stateId, function, integral_constant<size_t, 0>{}); }
+	template<typename Function, size_t StateIdx>
+	void VisitState(uint32_t stateId, Function& function, integral_constant<size_t, StateIdx>) const;
+	template<typename Function>
+	void VisitState(uint32_t stateId, Function& function, integral_constant<size_t, sizeof...(TStates)>) const {} // No state
+
+	template<typename State, size_t... EdgeIndices>
+	void EvaluateTransitions(State* pState, float deltaTime, const Perception& perception, index_sequence<EdgeIndices...>);
+	template<size_t EdgeIdx, typename State>
+	bool EvaluateEdge(State* pState, float deltaTime, const Perception& perception);
+	template<typename State>
+	SteeringPlugin_Output UpdateState(State* pState, float deltaTime, const Perception& perception);
+	void SetState(uint32_t newStateId, const Perception& perception);
+	void CheckBudget(const type_info& type, BudgetClock::time_point start, float budget);
+
+	static const uint32_t m_InvalidStateId{ UINT32_MAX };
+
+	FSMArena m_Arena; // First, so it's released after everything else that points into it
+	States m_States;
+	Transitions m_Transitions;
+	EdgeSlot m_EdgeSlots[sizeof...(TEdges)];
+	uint32_t m_CurrentStateId;
+	IExamInterface* m_pInterface;
+	EventLog* m_pEventLog;
+	GameEventQueue* m_pEvents;
+};
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::StaticFiniteStateMachine(
+	const States& states, const Transitions& transitions, IExamInterface* pInterface, FSMArena&& arena)
+	: m_Arena(move(arena))
+	, m_States(states)
+	, m_Transitions(transitions)
+	, m_EdgeSlots()
+	, m_CurrentStateId(m_InvalidStateId)
+	, m_pInterface(pInterface)
+	, m_pEventLog(nullptr)
+	, m_pEvents(nullptr)
+{
+	// The intervals are picked up once, like FiniteStateMachine does when it compiles its table
+	const uint32_t fromStateIds[] = { FSMIndexOf<typename TEdges::From, TStates...>::value... };
+	const uint32_t intervals[] = { max(get<typename TEdges::Transition*>(m_Transitions)->GetBudget().Interval, 1u)... };
+	for (size_t edgeIdx = 0; edgeIdx < sizeof...(TEdges); ++edgeIdx)
+	{
+		const auto orderInState = uint32_t(count(fromStateIds, fromStateIds + edgeIdx, fromStateIds[edgeIdx]));
+		m_EdgeSlots[edgeIdx] = EdgeSlot{ fromStateIds[edgeIdx], orderInState, intervals[edgeIdx], 0, 0.f };
+	}
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+SteeringPlugin_Output StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::Update(
+	float deltaTime, const Perception& perception)
+{
+	PROFILE_ZONE("StaticFiniteStateMachine::Update");
+
+	if (m_CurrentStateId == m_InvalidStateId)
+		SetState(0, perception);
+
+	VisitState(m_CurrentStateId, [&](auto* pState) { this->EvaluateTransitions(pState, deltaTime, perception, make_index_sequence<sizeof...(TEdges)>{}); });
+
+	// Whichever state it's in now
+	SteeringPlugin_Output steering{};
+	VisitState(m_CurrentStateId, [&](auto* pState) { steering = this->UpdateState(pState, deltaTime, perception); });
+	return steering;
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+void StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::SetEventLog(EventLog* pEventLog)
+{
+	m_pEventLog = pEventLog;
+	using Expand = int[];
+	(void)Expand{ 0, (get<TStates*>(m_States)->SetEventLog(pEventLog), 0)... };
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+FSMState* StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::GetCurrentState() const
+{
+	FSMState* pCurrentState = nullptr;
+	VisitState(m_CurrentStateId, [&pCurrentState](auto* pState) { pCurrentState = pState; });
+	return pCurrentState;
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+template<typename Function, size_t StateIdx>
+void StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::VisitState(
+	uint32_t stateId, Function& function, integral_constant<size_t, StateIdx>) const
+{
+	if (stateId == StateIdx)
+		function(get<StateIdx>(m_States));
+	else
+		VisitState(stateId, function, integral_constant<size_t, StateIdx + 1>{});
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+template<typename State, size_t... EdgeIndices>
+void StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::EvaluateTransitions(
+	State* pState, float deltaTime, const Perception& perception, index_sequence<EdgeIndices...>)
+{
+	// Every edge in order (the ones from other states fold away), up to the first one that fires
+	bool isTaken = false;
+	using Expand = int[];
+	(void)Expand{ 0, (isTaken = isTaken || EvaluateEdge<EdgeIndices>(pState, deltaTime, perception), 0)... };
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+template<size_t EdgeIdx, typename State>
+bool StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::EvaluateEdge(
+	State* pState, float deltaTime, const Perception& perception)
+{
+	using Edge = tuple_element_t<EdgeIdx, tuple<TEdges...>>;
+	using Transition = typename Edge::Transition;
+	if (is_same<typename Edge::From, State>::value == false)
+		return false;
+
+	// Guards on a lower rate are only looked at every few ticks, and catch up on the time that passed in the meantime
+	auto& slot = m_EdgeSlots[EdgeIdx];
+	slot.PendingTime += deltaTime;
+	if (slot.TicksToWait > 0)
+	{
+		--slot.TicksToWait;
+		return false;
+	}
+	slot.TicksToWait = slot.Interval - 1;
+
+	auto* pTransition = get<Transition*>(m_Transitions);
+	const auto budget = pTransition->GetBudget().Microseconds;
+	const auto start = budget > 0.f ? BudgetClock::now() : BudgetClock::time_point{};
+
+	pTransition->Transition::Update(slot.PendingTime, m_pInterface, perception);
+	const auto toTransition = pTransition->Transition::ToTransition(m_pInterface, perception);
+	slot.PendingTime = 0.f;
+
+	if (budget > 0.f)
+		CheckBudget(typeid(Transition), start, budget);
+
+	if (toTransition)
+		SetState(FSMIndexOf<typename Edge::To, TStates...>::value, perception);
+	return toTransition;
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+template<typename State>
+SteeringPlugin_Output StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::UpdateState(
+	State* pState, float deltaTime, const Perception& perception)
+{
+	PROFILE_ZONE(Profiler::GetTypeName(typeid(State)) + "::Update"); // Registered once per state type
+	const auto budget = pState->GetBudget().Microseconds;
+	if (budget <= 0.f)
+		return pState->State::Update(deltaTime, m_pInterface, perception);
+
+	const auto start = BudgetClock::now();
+	const auto steering = pState->State::Update(deltaTime, m_pInterface, perception);
+	CheckBudget(typeid(State), start, budget);
+	return steering;
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+void StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::SetState(
+	uint32_t newStateId, const Perception& perception)
+{
+	VisitState(m_CurrentStateId, [this](auto* pState)
+		{
+			using State = remove_pointer_t<decltype(pState)>;
+			LOG_EVENT(EVENT_LOG_STATES, m_pEventLog, eLogEvent::StateExited, typeid(State).name(), 0);
+			pState->State::OnExit(m_pInterface);
+		});
+
+	if (m_pEvents)
+		m_pEvents->Push(StateChangedEvent{ m_CurrentStateId == m_InvalidStateId ? -1 : int(m_CurrentStateId), int(newStateId) });
+	m_CurrentStateId = newStateId;
+
+	// The guards on a lower rate start over, spread out over their interval (so they don't all come due on the same tick)
+	for (auto& slot : m_EdgeSlots)
+	{
+		if (slot.FromStateId == newStateId)
+		{
+			slot.TicksToWait = slot.OrderInState % slot.Interval;
+			slot.PendingTime = 0.f;
+		}
+	}
+
+	VisitState(m_CurrentStateId, [this, &perception](auto* pState)
+		{
+			using State = remove_pointer_t<decltype(pState)>;
+			LOG_EVENT(EVENT_LOG_STATES, m_pEventLog, eLogEvent::StateEntered, typeid(State).name(), 0);
+			pState->State::OnEnter(m_pInterface, perception);
+		});
+}
+
+template<typename... TStates, typename... TTransitions, typename... TEdges>
+void StaticFiniteStateMachine<FSMTypeList<TStates...>, FSMTypeList<TTransitions...>, FSMTypeList<TEdges...>>::CheckBudget(
+	const type_info& type, BudgetClock::time_point start, float budget)
+{
+	const auto microseconds = chrono::duration<double, micro>(BudgetClock::now() - start).count();
+	if (microseconds > double(budget))
+		LOG_EVENT(EVENT_LOG_STATES, m_pEventLog, eLogEvent::BudgetOverrun, type.name(), int(microseconds));
+}
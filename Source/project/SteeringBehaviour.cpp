@@ -3,6 +3,13 @@
 #include <Exam_HelperStructs.h>
 
 
+float SteeringBehaviour::GetPredictionTime(const AgentInfo& agentInfo) const
+{
+	// A standing agent would never get there, so don't look further ahead than a couple of seconds
+	const float targetDistance = Elite::Distance(agentInfo.Position, m_Target.Position);
+	return agentInfo.MaxLinearSpeed > 0.f ? min(targetDistance / agentInfo.MaxLinearSpeed, m_MaxPredictionTime) : m_MaxPredictionTime;
+}
+
 //SEEK
 //****
 SteeringPlugin_Output Seek::CalculateSteering(const AgentInfo& agentInfo)
@@ -20,12 +27,9 @@ SteeringPlugin_Output Seek::CalculateSteering(const AgentInfo& agentInfo)
 //****
 SteeringPlugin_Output Pursuit::CalculateSteering(const AgentInfo& agentInfo)
 {
-	float targetDistance = Distance(agentInfo.Position, m_Target.Position); // Calculate the distance between the agen and the target
-	float predictionTime = targetDistance / agentInfo.MaxLinearSpeed; // Calculate the prediction time by diving the distance with the max speed
-	Elite::Vector2 targetDirection = m_Target.LinearVelocity.GetNormalized(); // Get the direction vector to the target
-
-	TargetData predictedTarget = TargetData(m_Target.Position + (targetDirection * predictionTime)); // Make a new target with the current target position + it's direction multiplied by the prediction time
-	m_Target = predictedTarget; // Set the current target to the new target
+	// Head for where the target will be by the time the agent gets to where it is now (its velocity being the filtered one, see EnemyTracks)
+	const float predictionTime = GetPredictionTime(agentInfo);
+	m_Target = TargetData(m_Target.Position + m_Target.LinearVelocity * predictionTime);
 
 	return Seek::CalculateSteering(agentInfo);
 }
@@ -54,11 +58,9 @@ SteeringPlugin_Output Evade::CalculateSteering(const AgentInfo& agentInfo)
 	if (targetDistance > m_EvadeRadius) // If the distance's bigger then the EvadeRadius, stop moving
 		return SteeringPlugin_Output{};
 
-	const float predictionTime = targetDistance / agentInfo.MaxLinearSpeed; // Calculate the prediction time by dividing the distance with the max speed
-	const Elite::Vector2 targetDirection = m_Target.LinearVelocity.GetNormalized(); // Get the target's normalized direction vector
-
-	const TargetData predictedTarget = TargetData(m_Target.Position + (targetDirection * predictionTime)); // Make a new target with the current target position + it's direction multiplied by the prediction time
-	m_Target = predictedTarget; // Set the current target to the new target
+	// Get away from where the target will be by the time the agent could've gotten to it
+	const float predictionTime = GetPredictionTime(agentInfo);
+	m_Target = TargetData(m_Target.Position + m_Target.LinearVelocity * predictionTime);
 
 	return Flee::CalculateSteering(agentInfo);
 }
@@ -109,36 +111,9 @@ SteeringPlugin_Output Face::CalculateSteering(const AgentInfo& agentInfo)
 	SteeringPlugin_Output face = {};
 	face.AutoOrient = false;
 
-	auto currentRotation = agentInfo.Orientation;
-	if (currentRotation > 6.f)
-		currentRotation -= 6.f * (int(currentRotation) / 6);
-
-	if (currentRotation < 0.f)
-		currentRotation += 6.f * (int(-currentRotation) / 6 + 1);
-
-	float currentRotationAngle;
-	if (currentRotation != 0.f)
-	{
-		currentRotationAngle = 360.f * currentRotation / 6.f - 90.f;
-		if (currentRotationAngle < 0.f)
-			currentRotationAngle += 360.f;
-	}
-	else currentRotationAngle = 270.f;
-
-	
-	const auto desiredDirection = m_Target.Position - agentInfo.Position;
-	const Elite::Vector2 currentDirection{ cos(Elite::ToRadians(currentRotationAngle)), sin(Elite::ToRadians(currentRotationAngle)) };
-
-	float angleBetweenVectors = atan2(currentDirection.x * desiredDirection.y - desiredDirection.x * currentDirection.y, currentDirection.x * desiredDirection.x + currentDirection.y * desiredDirection.y) * 180.f / M_PI;
-
-	if (angleBetweenVectors > 180.f)
-		angleBetweenVectors = - 360.f + angleBetweenVectors;
-
-	if(angleBetweenVectors < -180.f)
-		angleBetweenVectors = 360.f + angleBetweenVectors;
-	
-	face.AngularVelocity = angleBetweenVectors;
-	
+	// Turn towards the target, faster the further off it's facing (and at full speed past m_FullSpeedAngle)
+	const auto angle = Elite::SignedAngle(Elite::DirectionFromOrientation(agentInfo.Orientation), m_Target.Position - agentInfo.Position);
+	face.AngularVelocity = Elite::Clamp(angle * agentInfo.MaxAngularSpeed / m_FullSpeedAngle, -agentInfo.MaxAngularSpeed, agentInfo.MaxAngularSpeed);
 
 	return face;
 }
@@ -152,8 +127,8 @@ SteeringPlugin_Output Wander::CalculateSteering(const AgentInfo& agentInfo)
 	Elite::Vector2 offsetVector = agentInfo.LinearVelocity.GetNormalized(); // Define the vector of the agent's velocity and normalize it to get just the direction
 	offsetVector *= m_Offset; // Multiply that vector by the m_Offset to get the vector between the agent and the center of the circle
 	m_WanderTarget = agentInfo.Position + offsetVector; // Add the agent position to the vector to get the center of the circle
-	m_WanderAngle += Elite::randomFloat(-m_AngleChange, m_AngleChange); // Define m_WanderAngle between the max and min values of m_AngleChange
-	Elite::Vector2 displacementVector = Elite::Vector2(cos(m_WanderAngle), sin(m_WanderAngle)) * m_Radius; // Calculate the vector between the circle center and the final target (with the calculated angle)
+	m_WanderAngle = Elite::WrapAngle(m_WanderAngle + uniform_real_distribution<float>(-m_AngleChange, m_AngleChange)(m_RandomEngine)); // Define m_WanderAngle between the max and min values of m_AngleChange (kept wrapped, so it never drifts far enough to lose precision)
+	Elite::Vector2 displacementVector = Elite::DirectionFromAngle(m_WanderAngle) * m_Radius; // Calculate the vector between the circle center and the final target (with the calculated angle)
 	m_Target = m_WanderTarget + displacementVector; // Add the circle center position to the displacement vector to get the final target
 
 
@@ -44,7 +44,10 @@ public:
 	}
 
 protected:
+	float GetPredictionTime(const AgentInfo& agentInfo) const; // How far ahead to predict a moving target, for the agent to get there
+
 	TargetData m_Target;
+	const float m_MaxPredictionTime{ 2.f };
 };
 
 
@@ -128,6 +131,9 @@ public:
 	virtual ~Face() = default;
 
 	SteeringPlugin_Output CalculateSteering(const AgentInfo& agentInfo) override;
+
+private:
+	float m_FullSpeedAngle{ 0.1f }; // Radians
 };
 
 //////////////////////////
@@ -143,12 +149,14 @@ public:
 	void SetWanderOffset(float offset) { m_Offset = offset; }
 	void SetWanderRadius(float radius) { m_Radius = radius; }
 	void SetMaxAngleChange(float rad) { m_AngleChange = rad; }
+	void SetRandomSeed(uint32_t seed) { m_RandomEngine.seed(seed); }
 
 protected:
 	float m_Offset = 6.f; // Offset (Agent direction)
 	float m_Radius = 4.f; // Wander Radius
 	float m_AngleChange = Elite::ToRadians(45); // Max WanderAngle change per frame
 	float m_WanderAngle = 0.f; // Internal
+	mt19937 m_RandomEngine{}; // Own generator instead of rand(), so bots can run side by side (and stay reproducible)
 
 	Elite::Vector2 m_WanderTarget;
 	float m_MaxJitterDistance = 1.f;
@@ -0,0 +1,85 @@
+#include "stdafx.h"
+#include "SteeringBlender.h"
+
+SteeringPlugin_Output BlendSteering(const float* pLinearX, const float* pLinearY, const float* pAngular, const float* pWeights, size_t count,
+	bool runMode, bool autoOrient)
+{
+	float linearX = 0.f;
+	float linearY = 0.f;
+	float angular = 0.f;
+	float totalWeight = 0.f;
+	for (size_t i = 0; i < count; ++i)
+	{
+		linearX += pLinearX[i] * pWeights[i];
+		linearY += pLinearY[i] * pWeights[i];
+		angular += pAngular[i] * pWeights[i];
+		totalWeight += pWeights[i];
+	}
+
+	SteeringPlugin_Output steering{};
+	if (totalWeight > 0.f)
+	{
+		steering.LinearVelocity = Elite::Vector2{ linearX, linearY } / totalWeight;
+		steering.AngularVelocity = angular / totalWeight;
+	}
+	steering.RunMode = runMode;
+	steering.AutoOrient = autoOrient;
+	return steering;
+}
+
+SteeringBlender::SteeringBlender(eSteeringBlend blend)
+	: m_Behaviors()
+	, m_LinearX()
+	, m_LinearY()
+	, m_Angular()
+	, m_Weights()
+	, m_Blend(blend)
+{
+}
+
+void SteeringBlender::SetBehaviors(const BotFinalBehavior& behaviors)
+{
+	m_Behaviors = behaviors;
+	m_LinearX.assign(behaviors.size(), 0.f);
+	m_LinearY.assign(behaviors.size(), 0.f);
+	m_Angular.assign(behaviors.size(), 0.f);
+	m_Weights.assign(behaviors.size(), 0.f);
+}
+
+SteeringPlugin_Output SteeringBlender::CalculateSteering(const AgentInfo& agentInfo)
+{
+	if (m_Blend == eSteeringBlend::Priority)
+	{
+		SteeringPlugin_Output steering{};
+		for (const auto& behavior : m_Behaviors)
+		{
+			if (behavior.weight <= 0.f)
+				continue;
+
+			steering = behavior.behavior->CalculateSteering(agentInfo);
+			if (IsSteering(steering))
+				break;
+		}
+		return steering;
+	}
+
+	bool runMode = false;
+	bool autoOrient = true;
+	for (size_t i = 0; i < m_Behaviors.size(); ++i)
+	{
+		m_Weights[i] = max(m_Behaviors[i].weight, 0.f);
+		if (m_Weights[i] <= 0.f)
+		{
+			m_LinearX[i] = m_LinearY[i] = m_Angular[i] = 0.f;
+			continue;
+		}
+
+		const auto steering = m_Behaviors[i].behavior->CalculateSteering(agentInfo);
+		m_LinearX[i] = steering.LinearVelocity.x;
+		m_LinearY[i] = steering.LinearVelocity.y;
+		m_Angular[i] = steering.AngularVelocity;
+		runMode = runMode || steering.RunMode;
+		autoOrient = autoOrient && steering.AutoOrient;
+	}
+	return BlendSteering(m_LinearX.data(), m_LinearY.data(), m_Angular.data(), m_Weights.data(), m_Weights.size(), runMode, autoOrient);
+}
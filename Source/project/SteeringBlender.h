@@ -0,0 +1,148 @@
+#pragma once
+#include <Exam_HelperStructs.h>
+#include <tuple>
+#include <utility>
+
+#include "SteeringBehaviour.h"
+
+// How a set of behaviours turns into one steering
+enum class eSteeringBlend : uint8_t
+{
+	Weighted, // Weighted average of all of them
+	Priority // The first one (in the set's order) that moves or turns the agent, the ones after it aren't even calculated
+};
+
+struct WeightedBehavior
+{
+	SteeringBehaviour* behavior;
+	float weight; // 0 leaves it out (it isn't calculated at all)
+};
+
+using BotFinalBehavior = vector<WeightedBehavior>;
+
+// Weighted average of count behaviours' outputs, laid out per component (so it's a plain loop over floats)
+// It runs if any of them does, and turns on its own (the blended angular velocity) if any of them does
+SteeringPlugin_Output BlendSteering(const float* pLinearX, const float* pLinearY, const float* pAngular, const float* pWeights, size_t count,
+	bool runMode, bool autoOrient);
+
+// Whether a behaviour's output would move or turn the agent at all, for a priority blend to take it
+inline bool IsSteering(const SteeringPlugin_Output& steering)
+{
+	return steering.LinearVelocity.SqrtMagnitude() > 1e-4f || steering.AngularVelocity != 0.f;
+}
+
+// Blends a set of behaviours only known at runtime (through their vtables)
+// The set's described once (say in a state's OnEnter()), the buffer the outputs go into is only resized then
+class SteeringBlender final
+{
+public:
+	explicit SteeringBlender(eSteeringBlend blend = eSteeringBlend::Weighted);
+
+	void SetBehaviors(const BotFinalBehavior& behaviors);
+	void SetWeight(size_t behaviorIdx, float weight) { m_Behaviors[behaviorIdx].weight = weight; }
+	SteeringPlugin_Output CalculateSteering(const AgentInfo& agentInfo);
+
+private:
+	BotFinalBehavior m_Behaviors;
+	vector<float> m_LinearX; // One per behaviour
+	vector<float> m_LinearY;
+	vector<float> m_Angular;
+	vector<float> m_Weights;
+	eSteeringBlend m_Blend;
+};
+
+// The same, for a set of behaviours that's known at compile time, which it owns
+// Every behaviour's called by its own type instead of through the vtable (so it can get inlined), into fixed size buffers
+// All of them start off with a weight of 1
+template<typename... TBehaviours>
+class StaticSteeringBlender final
+{
+public:
+	static const size_t Count = sizeof...(TBehaviours);
+
+	explicit StaticSteeringBlender(eSteeringBlend blend = eSteeringBlend::Weighted)
+		: m_Behaviours()
+		, m_LinearX()
+		, m_LinearY()
+		, m_Angular()
+		, m_Weights()
+		, m_Blend(blend)
+	{
+		for (auto& weight : m_Weights)
+			weight = 1.f;
+	}
+
+	template<size_t BehaviourIdx>
+	tuple_element_t<BehaviourIdx, tuple<TBehaviours...>>& Get() { return get<BehaviourIdx>(m_Behaviours); }
+	template<size_t BehaviourIdx>
+	const tuple_element_t<BehaviourIdx, tuple<TBehaviours...>>& Get() const { return get<BehaviourIdx>(m_Behaviours); }
+
+	void SetWeight(size_t behaviourIdx, float weight) { m_Weights[behaviourIdx] = weight; }
+	float GetWeight(size_t behaviourIdx) const { return m_Weights[behaviourIdx]; }
+
+	SteeringPlugin_Output CalculateSteering(const AgentInfo& agentInfo)
+	{
+		if (m_Blend == eSteeringBlend::Priority)
+			return CalculatePriority(agentInfo, make_index_sequence<Count>{});
+		return CalculateWeighted(agentInfo, make_index_sequence<Count>{});
+	}
+
+private:
+	static_assert(sizeof...(TBehaviours) > 0, "Nothing to blend");
+
+	template<size_t... BehaviourIndices>
+	SteeringPlugin_Output CalculateWeighted(const AgentInfo& agentInfo, index_sequence<BehaviourIndices...>)
+	{
+		bool runMode = false;
+		bool autoOrient = true;
+		using Expand = int[];
+		(void)Expand{ 0, (Calculate<BehaviourIndices>(agentInfo, runMode, autoOrient), 0)... };
+		return BlendSteering(m_LinearX, m_LinearY, m_Angular, m_Weights, Count, runMode, autoOrient);
+	}
+
+	template<size_t BehaviourIdx>
+	void Calculate(const AgentInfo& agentInfo, bool& runMode, bool& autoOrient)
+	{
+		using Behaviour = tuple_element_t<BehaviourIdx, tuple<TBehaviours...>>;
+		if (m_Weights[BehaviourIdx] <= 0.f)
+		{
+			m_LinearX[BehaviourIdx] = m_LinearY[BehaviourIdx] = m_Angular[BehaviourIdx] = 0.f;
+			return;
+		}
+
+		const auto steering = get<BehaviourIdx>(m_Behaviours).Behaviour::CalculateSteering(agentInfo);
+		m_LinearX[BehaviourIdx] = steering.LinearVelocity.x;
+		m_LinearY[BehaviourIdx] = steering.LinearVelocity.y;
+		m_Angular[BehaviourIdx] = steering.AngularVelocity;
+		runMode = runMode || steering.RunMode;
+		autoOrient = autoOrient && steering.AutoOrient;
+	}
+
+	template<size_t... BehaviourIndices>
+	SteeringPlugin_Output CalculatePriority(const AgentInfo& agentInfo, index_sequence<BehaviourIndices...>)
+	{
+		SteeringPlugin_Output steering{};
+		bool isTaken = false;
+		using Expand = int[];
+		(void)Expand{ 0, (isTaken = isTaken || Take<BehaviourIndices>(agentInfo, steering), 0)... };
+		return steering;
+	}
+
+	template<size_t BehaviourIdx>
+	bool Take(const AgentInfo& agentInfo, SteeringPlugin_Output& steering)
+	{
+		using Behaviour = tuple_element_t<BehaviourIdx, tuple<TBehaviours...>>;
+		if (m_Weights[BehaviourIdx] <= 0.f)
+			return false;
+
+		steering = get<BehaviourIdx>(m_Behaviours).Behaviour::CalculateSteering(agentInfo);
+		return IsSteering(steering);
+	}
+
+	tuple<TBehaviours...> m_Behaviours;
+	float m_LinearX[sizeof...(TBehaviours)]; // One per behaviour
+	float m_LinearY[sizeof...(TBehaviours)];
+	float m_Angular[sizeof...(TBehaviours)];
+	float m_Weights[sizeof...(TBehaviours)];
+	eSteeringBlend m_Blend;
+};
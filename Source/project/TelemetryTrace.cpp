@@ -0,0 +1,265 @@
+#include "stdafx.h"
+#include "TelemetryTrace.h"
+#include <cstring>
+#include <cassert>
+
+namespace
+{
+	const char g_Magic[4]{ 'Z', 'S', 'T', 'R' };
+	const uint32_t g_Version{ 1 };
+
+	const size_t g_StateNameSize{ 48 }; // Per state name, null-terminated
+	const size_t g_HeaderAlignment{ 64 };
+
+	const TraceColumnInfo g_Columns[]
+	{
+		{ "DeltaTime", eTraceColumnType::Float },
+		{ "PositionX", eTraceColumnType::Float },
+		{ "PositionY", eTraceColumnType::Float },
+		{ "Orientation", eTraceColumnType::Float },
+		{ "Health", eTraceColumnType::Float },
+		{ "Energy", eTraceColumnType::Float },
+		{ "Stamina", eTraceColumnType::Float },
+		{ "State", eTraceColumnType::Int },
+		{ "LinearVelocityX", eTraceColumnType::Float },
+		{ "LinearVelocityY", eTraceColumnType::Float },
+		{ "AngularVelocity", eTraceColumnType::Float },
+		{ "AutoOrient", eTraceColumnType::Int },
+		{ "RunMode", eTraceColumnType::Int },
+		{ "HousesInFOV", eTraceColumnType::Int },
+		{ "EnemiesInFOV", eTraceColumnType::Int },
+		{ "ItemsInFOV", eTraceColumnType::Int },
+		{ "PurgeZonesInFOV", eTraceColumnType::Int },
+		{ "Score", eTraceColumnType::Int },
+		{ "Difficulty", eTraceColumnType::Float },
+		{ "TimeSurvived", eTraceColumnType::Float },
+		{ "KillCountdown", eTraceColumnType::Float },
+		{ "EnemiesKilled", eTraceColumnType::Int },
+		{ "EnemiesHit", eTraceColumnType::Int },
+		{ "ItemsPickedUp", eTraceColumnType::Int },
+		{ "MissedShots", eTraceColumnType::Int },
+		{ "CheckpointsReached", eTraceColumnType::Int },
+	};
+	static_assert(sizeof(g_Columns) / sizeof(g_Columns[0]) == size_t(eTraceColumn::_Count), "Every column needs a name and type");
+
+	const uint32_t g_ChunkHeaderWords{ sizeof(TraceChunkHeader) / sizeof(uint32_t) };
+
+	size_t GetHeaderSize(uint32_t columnCount, uint32_t stateCount)
+	{
+		const auto size = sizeof(TraceFileHeader) + columnCount * sizeof(TraceColumnInfo) + stateCount * g_StateNameSize;
+		return (size + g_HeaderAlignment - 1) / g_HeaderAlignment * g_HeaderAlignment;
+	}
+
+	size_t GetChunkSize(uint32_t columnCount, uint32_t framesPerChunk)
+	{
+		return sizeof(TraceChunkHeader) + size_t(columnCount) * framesPerChunk * sizeof(uint32_t);
+	}
+}
+
+const char* GetTraceColumnName(eTraceColumn column)
+{
+	return g_Columns[uint32_t(column)].Name;
+}
+
+eTraceColumnType GetTraceColumnType(eTraceColumn column)
+{
+	return g_Columns[uint32_t(column)].Type;
+}
+
+
+// WRITER
+TraceWriter::TraceWriter()
+	: m_File()
+	, m_Chunk(GetChunkSize(uint32_t(eTraceColumn::_Count), m_FramesPerChunk) / sizeof(uint32_t), 0)
+	, m_FrameInChunk(0)
+	, m_FirstFrame(0)
+{
+}
+
+TraceWriter::~TraceWriter()
+{
+	Close();
+}
+
+bool TraceWriter::Open(const string& filePath, int seed, const vector<string>& stateNames)
+{
+	Close();
+
+	m_File.open(filePath, ios::binary | ios::trunc);
+	if (!m_File)
+		return false;
+
+	const auto columnCount = uint32_t(eTraceColumn::_Count);
+	const auto stateCount = uint32_t(stateNames.size());
+	vector<char> header(GetHeaderSize(columnCount, stateCount), 0);
+
+	TraceFileHeader fileHeader{};
+	memcpy(fileHeader.Magic, g_Magic, sizeof(g_Magic));
+	fileHeader.Version = g_Version;
+	fileHeader.HeaderSize = uint32_t(header.size());
+	fileHeader.ColumnCount = columnCount;
+	fileHeader.StateCount = stateCount;
+	fileHeader.FramesPerChunk = m_FramesPerChunk;
+	fileHeader.Seed = seed;
+	memcpy(header.data(), &fileHeader, sizeof(fileHeader));
+	memcpy(header.data() + sizeof(fileHeader), g_Columns, sizeof(g_Columns));
+
+	auto* pStateName = header.data() + sizeof(fileHeader) + sizeof(g_Columns);
+	for (const auto& name : stateNames)
+	{
+		memcpy(pStateName, name.data(), min(name.size(), g_StateNameSize - 1)); // Truncated if need be, the rest is already 0
+		pStateName += g_StateNameSize;
+	}
+
+	m_File.write(header.data(), streamsize(header.size()));
+	fill(m_Chunk.begin(), m_Chunk.end(), 0u);
+	m_FrameInChunk = 0;
+	m_FirstFrame = 0;
+	return true;
+}
+
+void TraceWriter::Close()
+{
+	if (m_File.is_open() == false)
+		return;
+
+	if (m_FrameInChunk > 0)
+		WriteChunk();
+	m_File.close();
+}
+
+void TraceWriter::Set(eTraceColumn column, float value)
+{
+	assert(GetTraceColumnType(column) == eTraceColumnType::Float);
+	memcpy(&m_Chunk[g_ChunkHeaderWords + uint32_t(column) * m_FramesPerChunk + m_FrameInChunk], &value, sizeof(value));
+}
+
+void TraceWriter::Set(eTraceColumn column, int value)
+{
+	assert(GetTraceColumnType(column) == eTraceColumnType::Int);
+	m_Chunk[g_ChunkHeaderWords + uint32_t(column) * m_FramesPerChunk + m_FrameInChunk] = uint32_t(value);
+}
+
+void TraceWriter::EndFrame()
+{
+	if (m_File.is_open() == false)
+		return;
+
+	if (++m_FrameInChunk == m_FramesPerChunk)
+		WriteChunk();
+}
+
+void TraceWriter::WriteChunk()
+{
+	TraceChunkHeader chunkHeader{};
+	chunkHeader.FrameCount = m_FrameInChunk;
+	chunkHeader.FirstFrame = m_FirstFrame;
+	memcpy(m_Chunk.data(), &chunkHeader, sizeof(chunkHeader));
+
+	m_File.write(reinterpret_cast<const char*>(m_Chunk.data()), streamsize(m_Chunk.size() * sizeof(uint32_t)));
+	m_File.flush();
+
+	m_FirstFrame += m_FrameInChunk;
+	m_FrameInChunk = 0;
+	fill(m_Chunk.begin(), m_Chunk.end(), 0u);
+}
+
+
+// READER
+TraceReader::TraceReader()
+	: m_File()
+	, m_pHeader(nullptr)
+	, m_pColumns(nullptr)
+	, m_pStateNames(nullptr)
+	, m_ChunkSize(0)
+	, m_ChunkCount(0)
+	, m_FrameCount(0)
+{
+}
+
+bool TraceReader::Open(const string& filePath)
+{
+	Close();
+	if (m_File.Open(filePath) == false)
+		return false;
+
+	const auto* pData = m_File.GetData();
+	const auto fileSize = m_File.GetSize();
+	const auto* pHeader = reinterpret_cast<const TraceFileHeader*>(pData);
+	if (fileSize < sizeof(TraceFileHeader) || memcmp(pHeader->Magic, g_Magic, sizeof(g_Magic)) != 0 || pHeader->Version != g_Version
+		|| pHeader->FramesPerChunk == 0 || pHeader->HeaderSize > fileSize || pHeader->HeaderSize < GetHeaderSize(pHeader->ColumnCount, pHeader->StateCount))
+	{
+		m_File.Close();
+		return false;
+	}
+
+	m_pHeader = pHeader;
+	m_pColumns = reinterpret_cast<const TraceColumnInfo*>(pData + sizeof(TraceFileHeader));
+	m_pStateNames = reinterpret_cast<const char*>(m_pColumns + pHeader->ColumnCount);
+	m_ChunkSize = GetChunkSize(pHeader->ColumnCount, pHeader->FramesPerChunk);
+
+	// A chunk that only got written halfway (the game got killed) doesn't count
+	m_ChunkCount = uint32_t((fileSize - pHeader->HeaderSize) / m_ChunkSize);
+	for (uint32_t chunk = 0; chunk < m_ChunkCount; ++chunk)
+	{
+		const auto* pChunkHeader = reinterpret_cast<const TraceChunkHeader*>(pData + pHeader->HeaderSize + chunk * m_ChunkSize);
+		m_FrameCount += min(pChunkHeader->FrameCount, pHeader->FramesPerChunk);
+	}
+	return true;
+}
+
+void TraceReader::Close()
+{
+	m_File.Close();
+	m_pHeader = nullptr;
+	m_pColumns = nullptr;
+	m_pStateNames = nullptr;
+	m_ChunkSize = 0;
+	m_ChunkCount = 0;
+	m_FrameCount = 0;
+}
+
+string TraceReader::GetColumnName(uint32_t column) const
+{
+	const auto& name = m_pColumns[column].Name;
+	return string(name, strnlen(name, sizeof(name)));
+}
+
+int TraceReader::FindColumn(const string& name) const
+{
+	for (uint32_t column = 0; column < m_pHeader->ColumnCount; ++column)
+	{
+		if (GetColumnName(column) == name)
+			return int(column);
+	}
+	return -1;
+}
+
+string TraceReader::GetStateName(int state) const
+{
+	if (state < 0 || uint32_t(state) >= m_pHeader->StateCount)
+		return string{};
+
+	const auto* pName = m_pStateNames + state * g_StateNameSize;
+	return string(pName, strnlen(pName, g_StateNameSize));
+}
+
+const float* TraceReader::GetFloats(uint32_t chunk, uint32_t column, uint32_t& frameCount) const
+{
+	assert(GetColumnType(column) == eTraceColumnType::Float);
+	return reinterpret_cast<const float*>(GetColumnData(chunk, column, frameCount));
+}
+
+const int32_t* TraceReader::GetInts(uint32_t chunk, uint32_t column, uint32_t& frameCount) const
+{
+	assert(GetColumnType(column) == eTraceColumnType::Int);
+	return reinterpret_cast<const int32_t*>(GetColumnData(chunk, column, frameCount));
+}
+
+const uint8_t* TraceReader::GetColumnData(uint32_t chunk, uint32_t column, uint32_t& frameCount) const
+{
+	assert(chunk < m_ChunkCount && column < m_pHeader->ColumnCount);
+	const auto* pChunk = m_File.GetData() + m_pHeader->HeaderSize + chunk * m_ChunkSize;
+	frameCount = min(reinterpret_cast<const TraceChunkHeader*>(pChunk)->FrameCount, m_pHeader->FramesPerChunk);
+	return pChunk + sizeof(TraceChunkHeader) + size_t(column) * m_pHeader->FramesPerChunk * sizeof(uint32_t);
+}
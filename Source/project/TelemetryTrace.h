@@ -0,0 +1,179 @@
+#pragma once
+#include <cstdint>
+#include "MappedFile.h"
+
+// Per-frame telemetry of the bot, stored by column so a tool can go through one value of thousands of runs without reading the rest
+// (the plugin writes one per run, see TELEMETRY_ENABLED in Plugin.cpp, TraceScan reads them)
+//
+// File layout (little-endian, everything 4 bytes wide):
+//   TraceFileHeader, then a TraceColumnInfo per column and the names of the FSM's states (the State column's values index them),
+//   padded up to HeaderSize. Then the chunks, all of the same size: a TraceChunkHeader followed by every column's values
+//   for FramesPerChunk frames, one column after the other (only the first FrameCount ones are used, the last chunk is padded)
+// Since every chunk has the same size, a column's values in any chunk are found without looking at anything else,
+// and since chunks only get written once they're complete, a run that got cut short still leaves a valid file behind
+#ifndef TELEMETRY_ENABLED
+#define TELEMETRY_ENABLED 1
+#endif
+
+enum class eTraceColumnType : uint32_t
+{
+	Float,
+	Int
+};
+
+// The bot's columns, as the plugin writes them (readers should look them up by name, older files might have other columns)
+enum class eTraceColumn : uint32_t
+{
+	DeltaTime,
+
+	// AgentInfo
+	PositionX,
+	PositionY,
+	Orientation,
+	Health,
+	Energy,
+	Stamina,
+
+	// Active FSMState (index in the state names, -1 while there's none)
+	State,
+
+	// SteeringPlugin_Output
+	LinearVelocityX,
+	LinearVelocityY,
+	AngularVelocity,
+	AutoOrient,
+	RunMode,
+
+	// FOV counts
+	HousesInFOV,
+	EnemiesInFOV,
+	ItemsInFOV,
+	PurgeZonesInFOV,
+
+	// StatisticsInfo
+	Score,
+	Difficulty,
+	TimeSurvived,
+	KillCountdown,
+	EnemiesKilled,
+	EnemiesHit,
+	ItemsPickedUp,
+	MissedShots,
+	CheckpointsReached,
+
+	_Count
+};
+
+const char* GetTraceColumnName(eTraceColumn column);
+eTraceColumnType GetTraceColumnType(eTraceColumn column);
+
+struct TraceFileHeader
+{
+	char Magic[4]; // "ZSTR"
+	uint32_t Version;
+	uint32_t HeaderSize; // Offset of the first chunk
+	uint32_t ColumnCount;
+	uint32_t StateCount;
+	uint32_t FramesPerChunk;
+	int32_t Seed;
+	uint32_t Reserved;
+};
+
+struct TraceColumnInfo
+{
+	char Name[28]; // Null-terminated
+	eTraceColumnType Type;
+};
+
+struct TraceChunkHeader
+{
+	uint32_t FrameCount;
+	uint32_t Reserved;
+	uint64_t FirstFrame;
+};
+
+// Fills in one chunk at a time (a fixed-size buffer), and writes it out once it's full
+class TraceWriter final
+{
+public:
+	TraceWriter();
+	~TraceWriter();
+
+	TraceWriter(const TraceWriter&) = delete;
+	TraceWriter& operator=(const TraceWriter&) = delete;
+
+	bool Open(const string& filePath, int seed, const vector<string>& stateNames);
+	void Close(); // Writes out the last (partial) chunk
+	bool IsOpen() const { return m_File.is_open(); }
+	uint64_t GetFrameCount() const { return m_FirstFrame + m_FrameInChunk; }
+
+	// Every column of the frame gets set, then it's ended (columns that weren't set are 0)
+	void Set(eTraceColumn column, float value);
+	void Set(eTraceColumn column, int value);
+	void EndFrame();
+
+	static const uint32_t m_FramesPerChunk{ 1024 };
+
+private:
+	void WriteChunk();
+
+	ofstream m_File;
+	vector<uint32_t> m_Chunk; // Chunk header and every column, as they end up in the file
+	uint32_t m_FrameInChunk;
+	uint64_t m_FirstFrame; // Of the current chunk
+};
+
+// Maps a trace and hands out its columns chunk by chunk, straight from the mapping
+class TraceReader final
+{
+public:
+	TraceReader();
+	~TraceReader() = default;
+
+	bool Open(const string& filePath); // Fails for anything that isn't a trace (of this version)
+	void Close();
+
+	int GetSeed() const { return m_pHeader->Seed; }
+	uint64_t GetFrameCount() const { return m_FrameCount; }
+	uint32_t GetChunkCount() const { return m_ChunkCount; }
+
+	uint32_t GetColumnCount() const { return m_pHeader->ColumnCount; }
+	string GetColumnName(uint32_t column) const;
+	eTraceColumnType GetColumnType(uint32_t column) const { return m_pColumns[column].Type; }
+	int FindColumn(const string& name) const; // -1 if this trace doesn't have it
+
+	uint32_t GetStateCount() const { return m_pHeader->StateCount; }
+	string GetStateName(int state) const; // Empty for -1 or anything out of range
+
+	// A column's values in one chunk (frameCount of them), as floats or ints depending on its type
+	const float* GetFloats(uint32_t chunk, uint32_t column, uint32_t& frameCount) const;
+	const int32_t* GetInts(uint32_t chunk, uint32_t column, uint32_t& frameCount) const;
+
+	// Calls func(const T* pValues, uint32_t count) for every chunk of the column, T being float or int32_t (has to match its type)
+	template<typename T, typename Func>
+	void ScanColumn(uint32_t column, Func func) const;
+
+private:
+	const uint8_t* GetColumnData(uint32_t chunk, uint32_t column, uint32_t& frameCount) const;
+
+	MappedFile m_File;
+	const TraceFileHeader* m_pHeader;
+	const TraceColumnInfo* m_pColumns;
+	const char* m_pStateNames;
+	size_t m_ChunkSize;
+	uint32_t m_ChunkCount;
+	uint64_t m_FrameCount;
+};
+
+template<typename T, typename Func>
+void TraceReader::ScanColumn(uint32_t column, Func func) const
+{
+	static_assert(sizeof(T) == 4, "Columns are 4 bytes wide");
+	for (uint32_t chunk = 0; chunk < m_ChunkCount; ++chunk)
+	{
+		uint32_t frameCount = 0;
+		const auto* pValues = reinterpret_cast<const T*>(GetColumnData(chunk, column, frameCount));
+		if (frameCount > 0)
+			func(pValues, frameCount);
+	}
+}
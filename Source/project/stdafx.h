@@ -32,8 +32,12 @@ using namespace std;
 #pragma region //Third-Pary Includes
 #include <GL/gl3w.h>
 #include <ImGui/imgui.h>
+#ifdef _WIN32
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_syswm.h>
+#else
+typedef unsigned int UINT; // Normally pulled in by windows.h (through SDL_syswm.h)
+#endif
 
 #include "EliteMath/EMath.h"
 #include "EliteInput/EInputCodes.h"
@@ -41,3 +45,9 @@ using namespace std;
 #pragma endregion
 
 #define SAFE_DELETE(p) if (p) { delete (p); (p) = nullptr; }
+
+#ifdef _WIN32
+#define PLUGIN_API __declspec (dllexport)
+#else
+#define PLUGIN_API
+#endif